@@ -0,0 +1,172 @@
+/**
+ * @file bench_accounts.cpp
+ * @brief Account lookup, trade settlement and pre-trade risk benchmarks
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <ces/engine/accounts.hpp>
+#include <ces/engine/risk.hpp>
+#include <ces/lob/order.hpp>
+#include <ces/common/types.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace ces;
+
+namespace {
+
+constexpr std::size_t PAIR_COUNT = 1 << 16;  // Power of 2 for cheap wrap
+
+struct TradePair {
+    TraderId maker;
+    TraderId taker;
+};
+
+/**
+ * Random maker/taker pairs over [0, traders), generated up front so the
+ * timed loop only measures the accounts themselves.
+ */
+std::vector<TradePair> make_pairs(std::size_t traders) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::uint32_t> id_dist(0, static_cast<std::uint32_t>(traders - 1));
+    std::vector<TradePair> pairs(PAIR_COUNT);
+    for (auto& pair : pairs) {
+        pair.maker = TraderId{id_dist(rng)};
+        pair.taker = TraderId{id_dist(rng)};
+    }
+    return pairs;
+}
+
+void create_accounts(Accounts& accounts, std::size_t traders) {
+    for (std::size_t i = 0; i < traders; ++i) {
+        accounts.create_account(TraderId{static_cast<std::uint32_t>(i)}, 1'000'000'000);
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Trade Settlement
+// ============================================================================
+
+/**
+ * apply_trade() between random counterparties; cost should not depend on
+ * the number of accounts beyond cache effects. Arg 1 selects the write
+ * mode (0 shared atomic RMW, 1 single-writer seqlock stores).
+ */
+static void BM_ApplyTrade(benchmark::State& state) {
+    const auto traders = static_cast<std::size_t>(state.range(0));
+    const auto mode = static_cast<AccountsMode>(state.range(1));
+    Accounts accounts(traders, mode);
+    create_accounts(accounts, traders);
+    const auto pairs = make_pairs(traders);
+    
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const TradePair& pair = pairs[i++ & (PAIR_COUNT - 1)];
+        accounts.apply_trade(pair.maker, pair.taker, Side::Buy, Price{10000}, Qty{10});
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(to_string(mode));
+}
+
+BENCHMARK(BM_ApplyTrade)
+    ->ArgNames({"traders", "mode"})
+    ->ArgsProduct({{10, 1000, 100000}, {0, 1}});
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+static void BM_AccountLookup(benchmark::State& state) {
+    const auto traders = static_cast<std::size_t>(state.range(0));
+    Accounts accounts(traders);
+    create_accounts(accounts, traders);
+    const auto pairs = make_pairs(traders);
+    
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(accounts.get(pairs[i++ & (PAIR_COUNT - 1)].maker));
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_AccountLookup)
+    ->ArgName("traders")
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(100000);
+
+/**
+ * Seqlock read of a whole account (uncontended).
+ */
+static void BM_AccountSnapshot(benchmark::State& state) {
+    const auto traders = static_cast<std::size_t>(state.range(0));
+    Accounts accounts(traders, AccountsMode::SingleWriter);
+    create_accounts(accounts, traders);
+    const auto pairs = make_pairs(traders);
+    
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(accounts.snapshot(pairs[i++ & (PAIR_COUNT - 1)].maker));
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_AccountSnapshot)
+    ->ArgName("traders")
+    ->Arg(10)
+    ->Arg(100000);
+
+// ============================================================================
+// Pre-Trade Risk
+// ============================================================================
+
+/**
+ * Full RiskChecker::check() per new order: price/qty/notional validation
+ * plus position, open-exposure and balance limits from the account. Arg 1
+ * turns on per-trader token-bucket throttling (limits high enough that
+ * every order conforms, so the whole check path runs).
+ */
+static void BM_RiskCheck(benchmark::State& state) {
+    const auto traders = static_cast<std::size_t>(state.range(0));
+    const bool throttled = state.range(1) != 0;
+    Accounts accounts(traders, AccountsMode::SingleWriter);
+    create_accounts(accounts, traders);
+    RiskConfig config;
+    config.throttle_traders = traders;
+    if (throttled) {
+        config.throttle.new_orders_per_sec = 1'000'000'000;
+        config.throttle.new_order_burst = std::numeric_limits<std::uint32_t>::max();
+    }
+    RiskChecker risk(config, &accounts);
+    
+    std::vector<OrderEvent> events;
+    events.reserve(PAIR_COUNT);
+    std::uint64_t order_id = 1;
+    for (const TradePair& pair : make_pairs(traders)) {
+        const Side side = (order_id % 2 == 0) ? Side::Buy : Side::Sell;
+        events.push_back(OrderEvent::new_limit(OrderId{order_id++}, pair.maker, side,
+                                               Price{10000}, Qty{10}));
+        accounts.adjust_open(pair.maker, side, 10, Price{10000});
+    }
+    
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(risk.check(events[i++ & (PAIR_COUNT - 1)]));
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(throttled ? "throttled" : "unthrottled");
+}
+
+BENCHMARK(BM_RiskCheck)
+    ->ArgNames({"traders", "throttle"})
+    ->ArgsProduct({{10, 1000, 100000}, {0, 1}});
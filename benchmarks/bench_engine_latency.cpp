@@ -6,16 +6,27 @@
 #include <benchmark/benchmark.h>
 
 #include <ces/engine/matching_engine.hpp>
+#include <ces/engine/pipeline_engine.hpp>
+#include <ces/engine/journal.hpp>
+#include <ces/engine/replication.hpp>
 #include <ces/concurrency/spsc_semaphore_queue.hpp>
+#include <ces/concurrency/spsc_queue.hpp>
+#include <ces/concurrency/mpsc_queue.hpp>
+#include <ces/concurrency/wait_strategy.hpp>
 #include <ces/lob/order.hpp>
 #include <ces/common/types.hpp>
 #include <ces/common/time.hpp>
+#include <ces/common/tsc_clock.hpp>
 
 #include <thread>
 #include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
 #include <vector>
 #include <algorithm>
 #include <numeric>
+#include <span>
 
 using namespace ces;
 
@@ -25,8 +36,13 @@ constexpr std::size_t QUEUE_CAPACITY = 65536;
 // End-to-End Latency Benchmark
 // ============================================================================
 
+/**
+ * Push-to-processed latency of single orders; arg 1 selects the engine's
+ * WaitStrategy (0 busy-spin, 1 spin-yield, 2 spin-park, 3 blocking).
+ */
 static void BM_EndToEndLatency(benchmark::State& state) {
     const std::size_t num_orders = state.range(0);
+    const auto strategy = static_cast<WaitStrategy>(state.range(1));
     
     using Queue = SpscSemaphoreQueue<OrderEvent, QUEUE_CAPACITY>;
     Queue queue;
@@ -34,6 +50,7 @@ static void BM_EndToEndLatency(benchmark::State& state) {
     EngineConfig config;
     config.max_orders = 100000;
     config.max_traders = 100;
+    config.wait.strategy = strategy;
     
     MatchingEngine<QUEUE_CAPACITY> engine(queue, config);
     
@@ -99,16 +116,112 @@ static void BM_EndToEndLatency(benchmark::State& state) {
     engine_thread.join();
     
     state.SetItemsProcessed(state.iterations() * num_orders);
+    state.SetLabel(to_string(strategy));
 }
 
-BENCHMARK(BM_EndToEndLatency)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_EndToEndLatency)
+    ->ArgNames({"orders", "wait"})
+    ->ArgsProduct({{100, 1000, 10000}, {0, 1, 2, 3}});
+
+// ============================================================================
+// Round-Trip Latency Benchmark (order out, execution report back)
+// ============================================================================
+
+/**
+ * What a trader actually observes: push an order, then spin on its own
+ * report queue until the terminal report for that order arrives. Resting
+ * orders alternate sides far from each other so every event is a plain Ack.
+ */
+static void BM_RoundTripLatency(benchmark::State& state) {
+    const std::size_t num_orders = state.range(0);
+    const auto strategy = static_cast<WaitStrategy>(state.range(1));
+    
+    using Queue = SpscQueue<OrderEvent, QUEUE_CAPACITY>;
+    Queue queue;
+    
+    EngineConfig config;
+    config.max_orders = 100000;
+    config.max_traders = 100;
+    config.wait.strategy = strategy;
+    config.risk.check_balance = false;
+    
+    MatchingEngine<QUEUE_CAPACITY, Queue> engine(queue, config);
+    
+    ReportRouter router;
+    ReportRouter::Queue reports;
+    router.attach(TraderId{0}, reports);
+    engine.set_report_router(&router);
+    
+    std::jthread engine_thread([&engine](std::stop_token st) {
+        engine.run(st);
+    });
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    
+    std::vector<Duration> latencies;
+    latencies.reserve(num_orders);
+    std::uint64_t order_id = 1;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        latencies.clear();
+        state.ResumeTiming();
+        
+        for (std::size_t i = 0; i < num_orders; ++i) {
+            Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+            Price price = (side == Side::Buy) ? Price{9990} : Price{10010};
+            const OrderId id{order_id++};
+            
+            Timestamp start = now_ns();
+            queue.push(OrderEvent::new_limit(id, TraderId{0}, side, price, Qty{10}));
+            
+            ExecutionReport report;
+            do {
+                reports.pop(report);
+            } while (report.order_id != id || !report.is_terminal());
+            
+            latencies.push_back(static_cast<Duration>(now_ns() - start));
+        }
+        
+        state.PauseTiming();
+        std::sort(latencies.begin(), latencies.end());
+        state.counters["p50_us"] = latencies[latencies.size() * 50 / 100] / 1000.0;
+        state.counters["p99_us"] = latencies[latencies.size() * 99 / 100] / 1000.0;
+        state.counters["max_us"] = latencies.back() / 1000.0;
+        
+        // Cancel everything so the book stays the same size across iterations
+        for (std::uint64_t id = order_id - num_orders; id < order_id; ++id) {
+            queue.push(OrderEvent::cancel(OrderId{id}));
+        }
+        while (engine.book().order_count() > 0) {
+            std::this_thread::yield();
+        }
+        state.ResumeTiming();
+    }
+    
+    engine_thread.request_stop();
+    engine_thread.join();
+    
+    state.SetItemsProcessed(state.iterations() * num_orders);
+    state.counters["dropped"] = static_cast<double>(router.dropped());
+    state.SetLabel(to_string(strategy));
+}
+
+BENCHMARK(BM_RoundTripLatency)
+    ->ArgNames({"orders", "wait"})
+    ->ArgsProduct({{1000}, {0, 1, 2}})
+    ->UseRealTime();
 
 // ============================================================================
 // Queue Latency Benchmark (measure queue overhead)
 // ============================================================================
 
+/**
+ * Push-to-pop latency through the queue alone, for the semaphore queue
+ * and the lock-free queue with cached indices.
+ */
+template<typename Queue>
 static void BM_QueueLatency(benchmark::State& state) {
-    using Queue = SpscSemaphoreQueue<OrderEvent, QUEUE_CAPACITY>;
     Queue queue;
     
     std::atomic<bool> running{true};
@@ -154,7 +267,8 @@ static void BM_QueueLatency(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations());
 }
 
-BENCHMARK(BM_QueueLatency);
+BENCHMARK_TEMPLATE(BM_QueueLatency, SpscSemaphoreQueue<OrderEvent, QUEUE_CAPACITY>);
+BENCHMARK_TEMPLATE(BM_QueueLatency, SpscQueue<OrderEvent, QUEUE_CAPACITY>);
 
 // ============================================================================
 // Matching Latency Benchmark (with trades)
@@ -219,16 +333,21 @@ BENCHMARK(BM_MatchingLatency);
 // Throughput Under Load
 // ============================================================================
 
+/**
+ * Engine throughput with arg 0 producer threads pushing concurrently.
+ * Multi-producer runs need MpscQueue; the SPSC queue is registered for a
+ * single producer only, as a baseline.
+ */
+template<typename Queue>
 static void BM_ThroughputUnderLoad(benchmark::State& state) {
     const std::size_t num_producers = state.range(0);
     
-    using Queue = SpscSemaphoreQueue<OrderEvent, QUEUE_CAPACITY>;
     Queue queue;
     
     EngineConfig config;
     config.max_orders = 1000000;
     
-    MatchingEngine<QUEUE_CAPACITY> engine(queue, config);
+    MatchingEngine<QUEUE_CAPACITY, Queue> engine(queue, config);
     
     std::jthread engine_thread([&engine](std::stop_token st) {
         engine.run(st);
@@ -237,25 +356,103 @@ static void BM_ThroughputUnderLoad(benchmark::State& state) {
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
     
     constexpr std::size_t ORDERS_PER_ITER = 10000;
+    const std::size_t per_producer = ORDERS_PER_ITER / num_producers;
+    const std::size_t total = per_producer * num_producers;
+    std::uint64_t next_id = 1;
     
     for (auto _ : state) {
-        std::uint64_t start_processed = engine.events_processed();
+        const std::uint64_t start_processed = engine.events_processed();
+        
+        {
+            std::vector<std::jthread> producers;
+            producers.reserve(num_producers);
+            for (std::size_t p = 0; p < num_producers; ++p) {
+                // Disjoint order ID range per producer
+                const std::uint64_t first_id = next_id + p * per_producer;
+                producers.emplace_back([&queue, p, first_id, per_producer]() {
+                    for (std::size_t i = 0; i < per_producer; ++i) {
+                        Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+                        Price price = (side == Side::Buy) ? Price{9990} : Price{10010};
+                        queue.push(OrderEvent::new_limit(
+                            OrderId{first_id + i},
+                            TraderId{static_cast<std::uint32_t>(p)},
+                            side,
+                            price,
+                            Qty{10}
+                        ));
+                    }
+                });
+            }
+        }  // Join producers
+        next_id += total;
         
+        // Wait for all to process
+        while (engine.events_processed() < start_processed + total) {
+            std::this_thread::yield();
+        }
+    }
+    
+    engine_thread.request_stop();
+    engine_thread.join();
+    
+    state.SetItemsProcessed(state.iterations() * total);
+}
+
+BENCHMARK_TEMPLATE(BM_ThroughputUnderLoad, SpscSemaphoreQueue<OrderEvent, QUEUE_CAPACITY>)
+    ->ArgName("producers")->Arg(1)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ThroughputUnderLoad, MpscQueue<OrderEvent, QUEUE_CAPACITY>)
+    ->ArgName("producers")->Arg(1)->Arg(4)->Arg(8)->UseRealTime();
+
+// ============================================================================
+// Batch Throughput
+// ============================================================================
+
+/**
+ * Engine throughput vs batch size: the producer publishes runs of arg 0
+ * events with try_push_n() and the engine drains up to arg 0 per poll
+ * (in place for SpscQueue, via try_pop_n() for the semaphore queue).
+ */
+template<typename Queue>
+static void BM_BatchThroughput(benchmark::State& state) {
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    
+    Queue queue;
+    
+    EngineConfig config;
+    config.max_orders = 1000000;
+    config.max_batch = batch;
+    config.wait.strategy = WaitStrategy::SpinYield;
+    
+    MatchingEngine<QUEUE_CAPACITY, Queue> engine(queue, config);
+    
+    std::jthread engine_thread([&engine](std::stop_token st) {
+        engine.run(st);
+    });
+    
+    constexpr std::size_t ORDERS_PER_ITER = 10000;
+    std::vector<OrderEvent> events(ORDERS_PER_ITER);
+    std::uint64_t next_id = 1;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
         for (std::size_t i = 0; i < ORDERS_PER_ITER; ++i) {
             Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
             Price price = (side == Side::Buy) ? Price{9990} : Price{10010};
-            
-            queue.push(OrderEvent::new_limit(
-                OrderId{start_processed + i + 1},
-                TraderId{static_cast<std::uint32_t>(i % num_producers)},
-                side,
-                price,
-                Qty{10}
-            ));
+            events[i] = OrderEvent::new_limit(OrderId{next_id++}, TraderId{0}, side, price, Qty{10});
         }
+        const std::uint64_t target = engine.events_processed() + ORDERS_PER_ITER;
+        state.ResumeTiming();
         
-        // Wait for all to process
-        while (engine.events_processed() < start_processed + ORDERS_PER_ITER) {
+        std::span<const OrderEvent> pending(events);
+        while (!pending.empty()) {
+            const std::size_t pushed = queue.try_push_n(pending.first(std::min(batch, pending.size())));
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+            pending = pending.subspan(pushed);
+        }
+        
+        while (engine.events_processed() < target) {
             std::this_thread::yield();
         }
     }
@@ -266,7 +463,316 @@ static void BM_ThroughputUnderLoad(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations() * ORDERS_PER_ITER);
 }
 
-BENCHMARK(BM_ThroughputUnderLoad)->Arg(1)->Arg(4)->Arg(8);
+BENCHMARK_TEMPLATE(BM_BatchThroughput, SpscSemaphoreQueue<OrderEvent, QUEUE_CAPACITY>)
+    ->ArgName("batch")->Arg(1)->Arg(8)->Arg(64)->Arg(256)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_BatchThroughput, SpscQueue<OrderEvent, QUEUE_CAPACITY>)
+    ->ArgName("batch")->Arg(1)->Arg(8)->Arg(64)->Arg(256)->UseRealTime();
+
+// ============================================================================
+// Staged Pipeline vs Single-Thread Engine
+// ============================================================================
+
+namespace {
+
+constexpr std::size_t STAGED_ORDERS_PER_ITER = 10000;
+
+/// Resting and crossing limits from 8 traders around 10000
+void fill_mixed_flow(std::vector<OrderEvent>& events, std::uint64_t& next_id) {
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+        const auto offset = static_cast<Price::value_type>(i % 5) - 2;
+        events[i] = OrderEvent::new_limit(
+            OrderId{next_id++}, TraderId{static_cast<std::uint32_t>(i % 8)},
+            side, Price{10000 + offset}, Qty{10});
+    }
+}
+
+void report_latency(benchmark::State& state, const EngineStats& stats) {
+    const auto latency = stats.get_latency_stats();
+    state.counters["p50_us"] = latency.p50_ns / 1000.0;
+    state.counters["p99_us"] = latency.p99_ns / 1000.0;
+}
+
+} // namespace
+
+/**
+ * Risk, matching and post-trade on three threads over one sequenced ring.
+ */
+static void BM_StagedPipeline(benchmark::State& state) {
+    PipelineConfig config;
+    config.engine.max_orders = 1000000;
+    config.engine.risk.check_balance = false;  // Rejects would not count as processed
+    auto pipeline = std::make_unique<PipelineEngine<QUEUE_CAPACITY>>(config);
+    pipeline->start();
+    
+    std::vector<OrderEvent> events(STAGED_ORDERS_PER_ITER);
+    std::uint64_t next_id = 1;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        fill_mixed_flow(events, next_id);
+        const std::uint64_t target = pipeline->events_processed() + events.size();
+        state.ResumeTiming();
+        
+        for (const OrderEvent& event : events) {
+            pipeline->publish(event);
+        }
+        while (pipeline->events_processed() < target) {
+            std::this_thread::yield();
+        }
+    }
+    
+    pipeline->stop();
+    state.SetItemsProcessed(state.iterations() * STAGED_ORDERS_PER_ITER);
+    report_latency(state, pipeline->stats());
+}
+
+BENCHMARK(BM_StagedPipeline)->UseRealTime();
+
+/**
+ * Same flow through the single-thread engine (lock-free queue, same wait strategy).
+ */
+static void BM_SingleThreadEngine(benchmark::State& state) {
+    using Queue = SpscQueue<OrderEvent, QUEUE_CAPACITY>;
+    Queue queue;
+    
+    EngineConfig config;
+    config.max_orders = 1000000;
+    config.risk.check_balance = false;
+    config.wait.strategy = WaitStrategy::SpinYield;
+    MatchingEngine<QUEUE_CAPACITY, Queue> engine(queue, config);
+    
+    std::jthread engine_thread([&engine](std::stop_token st) {
+        engine.run(st);
+    });
+    
+    std::vector<OrderEvent> events(STAGED_ORDERS_PER_ITER);
+    std::uint64_t next_id = 1;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        fill_mixed_flow(events, next_id);
+        const std::uint64_t target = engine.events_processed() + events.size();
+        state.ResumeTiming();
+        
+        for (const OrderEvent& event : events) {
+            queue.push(event);
+        }
+        while (engine.events_processed() < target) {
+            std::this_thread::yield();
+        }
+    }
+    
+    engine_thread.request_stop();
+    engine_thread.join();
+    state.SetItemsProcessed(state.iterations() * STAGED_ORDERS_PER_ITER);
+    report_latency(state, engine.stats());
+}
+
+BENCHMARK(BM_SingleThreadEngine)->UseRealTime();
+
+// ============================================================================
+// Journal Overhead
+// ============================================================================
+
+/**
+ * process_event() on the mixed flow with a write-ahead journal attached;
+ * arg 0 is no journal, 1-3 select JournalDurability (per-event, group
+ * commit, async). Per-event waits for an msync per accepted event.
+ */
+static void BM_JournalOverhead(benchmark::State& state) {
+    const bool journaled = state.range(0) > 0;
+    const auto durability = static_cast<JournalDurability>(std::max<std::int64_t>(state.range(0) - 1, 0));
+    const std::string path = (std::filesystem::temp_directory_path() / "ces_bench_journal.bin").string();
+    
+    using Queue = SpscQueue<OrderEvent, QUEUE_CAPACITY>;
+    Queue queue;
+    EngineConfig config;
+    config.max_orders = 1000000;
+    config.risk.check_balance = false;
+    MatchingEngine<QUEUE_CAPACITY, Queue> engine(queue, config);
+    
+    const JournalConfig journal_config{.capacity = 1 << 20, .durability = durability};
+    Journal journal;
+    if (journaled) {
+        if (journal.create(path, journal_config) != JournalResult::Ok) {
+            state.SkipWithError("cannot create journal");
+            return;
+        }
+        engine.set_journal(&journal);
+    }
+    
+    std::vector<OrderEvent> events(STAGED_ORDERS_PER_ITER);
+    std::uint64_t next_id = 1;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        fill_mixed_flow(events, next_id);
+        if (journaled && journal.written() + events.size() > journal_config.capacity) {
+            (void)journal.close();
+            (void)journal.create(path, journal_config);
+        }
+        state.ResumeTiming();
+        
+        for (const OrderEvent& event : events) {
+            engine.process_event(event);
+        }
+    }
+    
+    state.SetItemsProcessed(state.iterations() * STAGED_ORDERS_PER_ITER);
+    if (journaled) {
+        state.counters["syncs"] = static_cast<double>(journal.syncs());
+        (void)journal.close();
+        std::remove(path.c_str());
+    }
+}
+
+BENCHMARK(BM_JournalOverhead)->ArgName("journal")->Arg(0)->Arg(1)->Arg(2)->Arg(3)->UseRealTime();
+
+// ============================================================================
+// Engine Time Source
+// ============================================================================
+
+/**
+ * Cost of one timestamp: arg 0 is now_ns() (high_resolution_clock), arg 1
+ * a TscClock tick read.
+ */
+static void BM_ClockRead(benchmark::State& state) {
+    const bool tsc = state.range(0) == 1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tsc ? TscClock::ticks() : now_ns());
+    }
+}
+
+BENCHMARK(BM_ClockRead)->ArgName("tsc")->Arg(0)->Arg(1);
+
+/**
+ * process_event() on the mixed flow with each engine time source. The
+ * engine reads its clock four times per event (start, after risk, after
+ * matching, end).
+ */
+static void BM_EngineTimeSource(benchmark::State& state) {
+    using Queue = SpscQueue<OrderEvent, QUEUE_CAPACITY>;
+    Queue queue;
+    EngineConfig config;
+    config.max_orders = 1000000;
+    config.risk.check_balance = false;
+    config.time_source = static_cast<TimeSource>(state.range(0));
+    MatchingEngine<QUEUE_CAPACITY, Queue> engine(queue, config);
+    if (engine.time_source() != config.time_source) {
+        state.SkipWithError("no invariant TSC");
+        return;
+    }
+    
+    std::vector<OrderEvent> events(STAGED_ORDERS_PER_ITER);
+    std::uint64_t next_id = 1;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        fill_mixed_flow(events, next_id);
+        state.ResumeTiming();
+        
+        for (const OrderEvent& event : events) {
+            engine.process_event(event);
+        }
+    }
+    
+    state.SetItemsProcessed(state.iterations() * STAGED_ORDERS_PER_ITER);
+    state.counters["matching_p50_ns"] =
+        engine.stats().get_stage_stats(OrderType::NewLimit, LatencyStage::Matching).p50_ns;
+}
+
+BENCHMARK(BM_EngineTimeSource)->ArgName("tsc")->Arg(0)->Arg(1)->UseRealTime();
+
+// ============================================================================
+// Replication Overhead
+// ============================================================================
+
+/**
+ * process_event() with an async journal streamed to a standby engine on
+ * another thread. Arg is the standby's max lag in events (0 = no standby).
+ * Counters: primary stall time per event and the standby's p99 lag behind
+ * acceptance. Fixed at 100 iterations so one journal holds the whole run.
+ */
+static void BM_ReplicationOverhead(benchmark::State& state) {
+    const auto max_lag = static_cast<std::uint64_t>(state.range(0));
+    const std::string path = (std::filesystem::temp_directory_path() / "ces_bench_replication.bin").string();
+    const ReplicationConfig replication_config{
+        .socket_path = (std::filesystem::temp_directory_path() / "ces_bench_replication.sock").string(),
+        .max_lag = std::max<std::uint64_t>(max_lag, 1)
+    };
+    
+    using Queue = SpscQueue<OrderEvent, QUEUE_CAPACITY>;
+    EngineConfig config;
+    config.max_orders = 1000000;
+    config.risk.check_balance = false;
+    Queue queue;
+    MatchingEngine<QUEUE_CAPACITY, Queue> engine(queue, config);
+    Queue standby_queue;
+    MatchingEngine<QUEUE_CAPACITY, Queue> standby_engine(standby_queue, config);
+    
+    Journal journal;
+    if (journal.create(path, JournalConfig{.capacity = 1 << 20, .durability = JournalDurability::Async})
+            != JournalResult::Ok) {
+        state.SkipWithError("cannot create journal");
+        return;
+    }
+    engine.set_journal(&journal);
+    
+    ReplicationPrimary primary(journal, replication_config);
+    ReplicationStandby standby(replication_config);
+    std::jthread standby_thread;
+    if (max_lag > 0) {
+        if (primary.start() != ReplicationResult::Ok || standby.connect(1) != ReplicationResult::Ok) {
+            state.SkipWithError("cannot set up replication");
+            return;
+        }
+        engine.set_replication(&primary);
+        standby_thread = std::jthread([&](std::stop_token st) {
+            while (!st.stop_requested() && standby.connected()) {
+                standby.poll([&](const JournalRecord& r) { standby_engine.replay(r); });
+            }
+        });
+        while (!primary.connected()) {
+            std::this_thread::yield();
+        }
+    }
+    
+    std::vector<OrderEvent> events(STAGED_ORDERS_PER_ITER);
+    std::uint64_t next_id = 1;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        fill_mixed_flow(events, next_id);
+        state.ResumeTiming();
+        
+        for (const OrderEvent& event : events) {
+            engine.process_event(event);
+        }
+    }
+    
+    state.SetItemsProcessed(state.iterations() * STAGED_ORDERS_PER_ITER);
+    if (max_lag > 0) {
+        while (standby.applied() < journal.written() && standby.connected()) {
+            std::this_thread::yield();
+        }
+        standby_thread.request_stop();
+        standby_thread.join();
+        const auto events_total = static_cast<double>(state.iterations() * STAGED_ORDERS_PER_ITER);
+        state.counters["stall_ns_per_event"] = static_cast<double>(primary.stall_ns()) / events_total;
+        state.counters["lag_p99_us"] = standby.lag_stats().p99_ns / 1000.0;
+        state.counters["in_sync"] = standby_engine.state_hash() == engine.state_hash() ? 1 : 0;
+        primary.stop();
+    }
+    (void)journal.close();
+    std::remove(path.c_str());
+}
+
+BENCHMARK(BM_ReplicationOverhead)
+    ->ArgName("max_lag")
+    ->Arg(0)->Arg(1'024)->Arg(65'536)
+    ->Iterations(100)
+    ->UseRealTime();
 
 // ============================================================================
 // Main
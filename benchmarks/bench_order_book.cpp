@@ -8,8 +8,13 @@
 #include <ces/lob/order_book.hpp>
 #include <ces/lob/order.hpp>
 #include <ces/common/types.hpp>
+#include <ces/memory/page_allocator.hpp>
 
+#include <algorithm>
+#include <filesystem>
 #include <random>
+#include <string>
+#include <vector>
 
 using namespace ces;
 
@@ -21,8 +26,8 @@ static void BM_AddOrder(benchmark::State& state) {
     OrderBook book(100000, 1000);
     std::uint64_t order_id = 1;
     std::mt19937_64 rng(12345);
-    std::uniform_int_distribution<std::int64_t> price_dist(9900, 10100);
-    std::uniform_int_distribution<std::int64_t> qty_dist(1, 100);
+    std::uniform_int_distribution<Price::value_type> price_dist(9900, 10100);
+    std::uniform_int_distribution<Qty::value_type> qty_dist(1, 100);
     
     for (auto _ : state) {
         Side side = (order_id % 2 == 0) ? Side::Buy : Side::Sell;
@@ -58,7 +63,7 @@ BENCHMARK(BM_AddOrder);
 static void BM_CancelOrder(benchmark::State& state) {
     OrderBook book(100000, 1000);
     std::mt19937_64 rng(12345);
-    std::uniform_int_distribution<std::int64_t> price_dist(9900, 10100);
+    std::uniform_int_distribution<Price::value_type> price_dist(9900, 10100);
     
     // Pre-populate book
     for (std::uint64_t i = 1; i <= 10000; ++i) {
@@ -102,6 +107,51 @@ static void BM_CancelOrder(benchmark::State& state) {
 
 BENCHMARK(BM_CancelOrder);
 
+// ============================================================================
+// Random Cancel by Backing (heap vs huge pages)
+// ============================================================================
+
+static void BM_RandomCancelBacking(benchmark::State& state) {
+    constexpr std::uint64_t NUM_ORDERS = 1'000'000;
+    const bool huge = state.range(0) != 0;
+    
+    OrderBook book(
+        static_cast<std::uint32_t>(NUM_ORDERS), 10000, 0.5f,
+        huge ? AllocationPolicy::huge() : AllocationPolicy::heap()
+    );
+    std::mt19937_64 rng(12345);
+    std::uniform_int_distribution<Price::value_type> bid_dist(5000, 9999);
+    std::uniform_int_distribution<Price::value_type> ask_dist(10001, 15000);
+    std::uniform_int_distribution<std::uint64_t> id_dist(1, NUM_ORDERS);
+    
+    auto add = [&](std::uint64_t id) {
+        Side side = (id % 2 == 0) ? Side::Buy : Side::Sell;
+        Price price{side == Side::Buy ? bid_dist(rng) : ask_dist(rng)};
+        book.add_limit(OrderId{id}, TraderId{0}, side, price, Qty{100});
+    };
+    
+    // Populate the full pool so cancels touch memory across the whole array
+    for (std::uint64_t id = 1; id <= NUM_ORDERS; ++id) {
+        add(id);
+    }
+    
+    for (auto _ : state) {
+        std::uint64_t id = id_dist(rng);
+        
+        auto response = book.cancel(OrderId{id});
+        benchmark::DoNotOptimize(response);
+        
+        state.PauseTiming();
+        add(id);
+        state.ResumeTiming();
+    }
+    
+    state.SetLabel(to_string(book.pool_backing()));
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RandomCancelBacking)->ArgName("huge")->Arg(0)->Arg(1);
+
 // ============================================================================
 // Match Hot Path Benchmark
 // ============================================================================
@@ -143,6 +193,158 @@ static void BM_MatchHotPath(benchmark::State& state) {
 
 BENCHMARK(BM_MatchHotPath);
 
+// ============================================================================
+// Deep Level Sweep Benchmark
+// ============================================================================
+
+/**
+ * Market order sweeping a single level of N makers whose pool slots are
+ * scattered (freelist shuffled up front), so each next_idx hop is a cache miss.
+ */
+static void BM_DeepLevelSweep(benchmark::State& state) {
+    const auto depth = static_cast<std::uint32_t>(state.range(0));
+    constexpr std::uint32_t POOL_SIZE = 1 << 21;
+    OrderBook book(POOL_SIZE, 1000);
+    std::mt19937_64 rng(42);
+    std::uint64_t order_id = 1;
+    
+    // Scatter the freelist: fill the pool, then cancel in random order
+    std::vector<std::uint64_t> ids;
+    ids.reserve(POOL_SIZE);
+    for (std::uint32_t i = 0; i < POOL_SIZE; ++i) {
+        ids.push_back(order_id);
+        book.add_limit(OrderId{order_id++}, TraderId{0}, Side::Buy, Price{1000}, Qty{1});
+    }
+    std::shuffle(ids.begin(), ids.end(), rng);
+    for (auto id : ids) {
+        book.cancel(OrderId{id});
+    }
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (std::uint32_t i = 0; i < depth; ++i) {
+            book.add_limit(OrderId{order_id++}, TraderId{0}, Side::Sell, Price{10000}, Qty{1});
+        }
+        state.ResumeTiming();
+        
+        auto response = book.add_market(
+            OrderId{order_id++}, TraderId{1}, Side::Buy, Qty{static_cast<std::int32_t>(depth)}
+        );
+        benchmark::DoNotOptimize(response);
+    }
+    
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+
+BENCHMARK(BM_DeepLevelSweep)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// ============================================================================
+// Snapshot Restore Benchmarks
+// ============================================================================
+
+namespace {
+
+constexpr std::uint32_t SNAPSHOT_ORDERS = 1'000'000;
+
+/// Non-crossing 1M-order book: bids 5000-9999, asks 10001-15000
+void build_resting_book(OrderBook& book) {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<Price::value_type> offset(0, 4999);
+    for (std::uint32_t i = 0; i < SNAPSHOT_ORDERS; ++i) {
+        const bool buy = (i % 2) == 0;
+        const Price price{buy ? 9999 - offset(rng) : 10001 + offset(rng)};
+        book.add_limit(OrderId{i + 1}, TraderId{i % 1000}, buy ? Side::Buy : Side::Sell, price, Qty{100});
+    }
+}
+
+} // namespace
+
+static void BM_SnapshotRestore(benchmark::State& state) {
+    const std::string path = (std::filesystem::temp_directory_path() / "ces_bench_snapshot.bin").string();
+    {
+        OrderBook source(SNAPSHOT_ORDERS, 10000);
+        build_resting_book(source);
+        if (source.save_snapshot(path) != SnapshotResult::Ok) {
+            state.SkipWithError("failed to write snapshot");
+            return;
+        }
+    }
+    
+    OrderBook book(SNAPSHOT_ORDERS, 10000);
+    for (auto _ : state) {
+        auto result = book.load_snapshot(path);
+        benchmark::DoNotOptimize(result);
+    }
+    
+    state.SetItemsProcessed(state.iterations() * SNAPSHOT_ORDERS);
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_SnapshotRestore)->Unit(benchmark::kMillisecond);
+
+/// Baseline: rebuild the same book by replaying add_limit
+static void BM_ReplayRebuild(benchmark::State& state) {
+    OrderBook book(SNAPSHOT_ORDERS, 10000);
+    for (auto _ : state) {
+        book.clear();
+        build_resting_book(book);
+    }
+    
+    state.SetItemsProcessed(state.iterations() * SNAPSHOT_ORDERS);
+}
+
+BENCHMARK(BM_ReplayRebuild)->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// Book Reset Benchmark
+// ============================================================================
+
+/**
+ * clear() on a 1M-capacity book holding N live orders (backtest reset path).
+ */
+static void BM_BookReset(benchmark::State& state) {
+    const auto live = static_cast<std::uint32_t>(state.range(0));
+    OrderBook book(1'000'000, 1000);
+    std::uint64_t order_id = 1;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (std::uint32_t i = 0; i < live; ++i) {
+            book.add_limit(OrderId{order_id++}, TraderId{0}, Side::Buy,
+                           Price{static_cast<Price::value_type>(9000 + i % 500)}, Qty{1});
+        }
+        state.ResumeTiming();
+        
+        book.clear();
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Fixed iteration counts: refilling the book between resets dominates wall time
+BENCHMARK(BM_BookReset)->Arg(0)->Arg(1000)->Iterations(2000);
+BENCHMARK(BM_BookReset)->Arg(100000)->Iterations(50);
+
+// ============================================================================
+// Startup Benchmark
+// ============================================================================
+
+/**
+ * Construct a 1M-order book, lazily (0) or prefaulted (1).
+ */
+static void BM_BookStartup(benchmark::State& state) {
+    const bool prefault = state.range(0) != 0;
+    for (auto _ : state) {
+        OrderBook book(1'000'000, 1000);
+        if (prefault) {
+            book.prefault();
+        }
+        benchmark::DoNotOptimize(book);
+    }
+}
+
+BENCHMARK(BM_BookStartup)->ArgName("prefault")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
 // ============================================================================
 // Best Bid/Ask Query Benchmark
 // ============================================================================
@@ -150,7 +352,7 @@ BENCHMARK(BM_MatchHotPath);
 static void BM_BestBidAsk(benchmark::State& state) {
     OrderBook book(100000, 1000);
     std::mt19937_64 rng(12345);
-    std::uniform_int_distribution<std::int64_t> price_dist(9900, 10100);
+    std::uniform_int_distribution<Price::value_type> price_dist(9900, 10100);
     
     // Populate book
     for (std::uint64_t i = 1; i <= 10000; ++i) {
@@ -183,7 +385,7 @@ BENCHMARK(BM_BestBidAsk);
 static void BM_OrderLookup(benchmark::State& state) {
     OrderBook book(100000, 1000);
     std::mt19937_64 rng(12345);
-    std::uniform_int_distribution<std::int64_t> price_dist(9900, 10100);
+    std::uniform_int_distribution<Price::value_type> price_dist(9900, 10100);
     
     // Populate book
     constexpr std::uint64_t NUM_ORDERS = 10000;
@@ -219,8 +421,8 @@ static void BM_Throughput(benchmark::State& state) {
     const std::size_t batch_size = state.range(0);
     OrderBook book(1000000, 10000);
     std::mt19937_64 rng(12345);
-    std::uniform_int_distribution<std::int64_t> price_dist(9900, 10100);
-    std::uniform_int_distribution<std::int64_t> qty_dist(1, 100);
+    std::uniform_int_distribution<Price::value_type> price_dist(9900, 10100);
+    std::uniform_int_distribution<Qty::value_type> qty_dist(1, 100);
     
     std::uint64_t order_id = 1;
     
@@ -0,0 +1,192 @@
+/**
+ * @file bench_recovery.cpp
+ * @brief Restart time from checkpoint + journal tail, and checkpoint capture cost
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <ces/engine/matching_engine.hpp>
+#include <ces/engine/journal.hpp>
+#include <ces/engine/checkpoint.hpp>
+#include <ces/concurrency/spsc_queue.hpp>
+#include <ces/lob/order.hpp>
+#include <ces/common/types.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ces;
+
+namespace {
+
+constexpr std::size_t QUEUE_CAPACITY = 4096;
+constexpr std::size_t JOURNAL_EVENTS = 200'000;
+
+using Queue = SpscQueue<OrderEvent, QUEUE_CAPACITY>;
+using Engine = MatchingEngine<QUEUE_CAPACITY, Queue>;
+
+EngineConfig bench_config() {
+    EngineConfig config;
+    config.max_orders = 1'000'000;
+    config.risk.check_balance = false;
+    return config;
+}
+
+std::string temp_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+/**
+ * Limits from 64 traders within +/-50 ticks of 10000, one in five events
+ * cancelling an earlier order, so the book keeps a few thousand levels'
+ * worth of resting orders while trading.
+ */
+std::vector<OrderEvent> make_flow(std::size_t count) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> offset(-50, 50);
+    std::uniform_int_distribution<int> qty(1, 20);
+    std::uniform_int_distribution<int> pick(0, 4);
+    std::vector<OrderEvent> events;
+    events.reserve(count);
+    std::uint64_t next_id = 1;
+    while (events.size() < count) {
+        if (next_id > 1 && pick(rng) == 0) {
+            std::uniform_int_distribution<std::uint64_t> target(1, next_id - 1);
+            events.push_back(OrderEvent::cancel(OrderId{target(rng)}));
+            continue;
+        }
+        const Side side = (rng() & 1) ? Side::Buy : Side::Sell;
+        const int skew = side == Side::Buy ? -3 : 3;  // Mostly rests, sometimes crosses
+        events.push_back(OrderEvent::new_limit(
+            OrderId{next_id++}, TraderId{static_cast<std::uint32_t>(rng() % 64)},
+            side, Price{10000 + offset(rng) + skew}, Qty{qty(rng)}));
+    }
+    return events;
+}
+
+} // namespace
+
+// ============================================================================
+// Restart Time vs Checkpoint Interval
+// ============================================================================
+
+/**
+ * Recover a 200k-record session: load the newest checkpoint and replay
+ * the journal tail after it. Arg is the checkpoint interval in journal
+ * records (0 = no checkpoint, replay everything). The tail is
+ * JOURNAL_EVENTS mod interval, so restart time follows the interval.
+ */
+static void BM_RecoveryTime(benchmark::State& state) {
+    const auto interval = static_cast<std::uint64_t>(state.range(0));
+    const std::string journal_path = temp_path("ces_bench_recovery.journal");
+    const std::string checkpoint_path = interval > 0 ? temp_path("ces_bench_recovery.ckpt") : std::string{};
+
+    // Record the session once
+    {
+        Queue queue;
+        Engine live(queue, bench_config());
+        Journal journal;
+        if (journal.create(journal_path, JournalConfig{.capacity = JOURNAL_EVENTS,
+                                                       .durability = JournalDurability::Async})
+                != JournalResult::Ok) {
+            state.SkipWithError("cannot create journal");
+            return;
+        }
+        live.set_journal(&journal);
+
+        std::unique_ptr<Checkpointer> checkpointer;
+        if (interval > 0) {
+            checkpointer = std::make_unique<Checkpointer>(
+                journal, CheckpointConfig{.path = checkpoint_path, .interval = interval});
+            live.set_checkpointer(checkpointer.get());
+        }
+        for (const OrderEvent& event : make_flow(JOURNAL_EVENTS)) {
+            live.process_event(event);
+        }
+        if (checkpointer) {
+            checkpointer->wait_idle();
+            state.counters["capture_us"] = ns_to_us(checkpointer->last_capture_ns());
+        }
+        (void)journal.close(live.state_hash());
+    }
+
+    JournalResult result;
+    auto reader = JournalReader::open(journal_path, result);
+    if (!reader) {
+        state.SkipWithError("cannot open journal");
+        return;
+    }
+
+    RecoveryResult recovery;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto queue = std::make_unique<Queue>();
+        auto engine = std::make_unique<Engine>(*queue, bench_config());
+        state.ResumeTiming();
+
+        recovery = engine->recover(checkpoint_path, *reader);
+
+        state.PauseTiming();
+        if (recovery.result != SnapshotResult::Ok || engine->state_hash() != reader->state_hash()) {
+            state.SkipWithError("recovered state does not match the journal");
+            break;
+        }
+        engine.reset();
+        queue.reset();
+        state.ResumeTiming();
+    }
+
+    state.counters["checkpoint_seq"] = static_cast<double>(recovery.checkpoint_seq);
+    state.counters["tail"] = static_cast<double>(recovery.replayed);
+    std::remove(journal_path.c_str());
+    if (!checkpoint_path.empty()) {
+        std::remove(checkpoint_path.c_str());
+    }
+}
+
+BENCHMARK(BM_RecoveryTime)
+    ->ArgName("interval")
+    ->Arg(0)->Arg(15'000)->Arg(45'000)->Arg(90'000)->Arg(150'000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// ============================================================================
+// Checkpoint Capture (engine-thread pause)
+// ============================================================================
+
+/**
+ * capture_checkpoint() into a reused image with N resting orders: the
+ * time matching stops for a checkpoint.
+ */
+static void BM_CheckpointCapture(benchmark::State& state) {
+    const auto orders = static_cast<std::uint64_t>(state.range(0));
+    Queue queue;
+    Engine engine(queue, bench_config());
+    for (std::uint64_t i = 0; i < orders; ++i) {
+        const Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+        const auto offset = static_cast<Price::value_type>(1 + i % 500);
+        engine.book().add_limit(OrderId{i + 1}, TraderId{static_cast<std::uint32_t>(i % 64)}, side,
+                                Price{side == Side::Buy ? 10000 - offset : 10000 + offset}, Qty{10});
+    }
+    for (std::uint32_t t = 0; t < 64; ++t) {
+        engine.accounts().create_account(TraderId{t}, 1'000'000'000);
+    }
+
+    CheckpointImage image;
+    for (auto _ : state) {
+        engine.capture_checkpoint(image);
+        benchmark::DoNotOptimize(image.book.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * image.book.size()));
+}
+
+BENCHMARK(BM_CheckpointCapture)
+    ->ArgName("orders")
+    ->Arg(10'000)->Arg(100'000)->Arg(500'000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -4,7 +4,9 @@
  * @brief C++20 Concepts for type constraints in the exchange simulator
  */
 
+#include <chrono>
 #include <concepts>
+#include <cstddef>
 #include <type_traits>
 
 namespace ces {
@@ -75,6 +77,21 @@ concept RingBufferElement =
     std::is_default_constructible_v<T> &&
     std::is_trivially_copyable_v<T>;
 
+/**
+ * @brief Concept for bounded event queues the engine and traders can share
+ *
+ * Satisfied by SpscSemaphoreQueue, SpscQueue and MpscQueue.
+ */
+template<typename Q, typename T>
+concept EventQueue = requires(Q q, T& out, const T& value, std::chrono::milliseconds timeout) {
+    { q.push(value) } -> std::same_as<void>;
+    { q.try_push(value) } -> std::same_as<bool>;
+    { q.try_pop(out) } -> std::same_as<bool>;
+    { q.try_pop_for(out, timeout) } -> std::same_as<bool>;
+    { q.size_approx() } -> std::convertible_to<std::size_t>;
+    { q.capacity() } -> std::convertible_to<std::size_t>;
+};
+
 /**
  * @brief Concept for types that can be stored in the object pool
  */
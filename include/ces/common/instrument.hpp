@@ -0,0 +1,94 @@
+#pragma once
+/**
+ * @file instrument.hpp
+ * @brief Instrument definition with tick/lot conversion at the API boundary
+ *
+ * Internally the book, engine and queues work in 32-bit tick and lot counts.
+ * Raw exchange units (price in minor currency units, quantity in shares or
+ * contracts) are converted here when orders enter or results leave the system.
+ */
+
+#include <ces/common/types.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+namespace ces {
+
+/**
+ * @brief Static instrument parameters used to convert raw units
+ *
+ * A raw price is representable if it is an exact multiple of tick_size
+ * whose tick count fits in Price. Quantities follow the same rule with
+ * lot_size and Qty.
+ */
+struct Instrument {
+    std::int64_t tick_size{constants::DEFAULT_TICK_SIZE};  // Raw price units per tick
+    std::int64_t lot_size{constants::DEFAULT_LOT_SIZE};    // Raw quantity units per lot
+
+    /**
+     * @brief Convert raw price to ticks
+     * @return Tick price, or nullopt if off the tick grid or out of range
+     */
+    [[nodiscard]] constexpr std::optional<Price> to_price(std::int64_t raw_price) const noexcept {
+        auto ticks = to_units<Price::value_type>(raw_price, tick_size);
+        if (!ticks) return std::nullopt;
+        return Price{*ticks};
+    }
+
+    /**
+     * @brief Convert raw quantity to lots
+     * @return Lot quantity, or nullopt if not a whole number of lots or out of range
+     */
+    [[nodiscard]] constexpr std::optional<Qty> to_qty(std::int64_t raw_qty) const noexcept {
+        auto lots = to_units<Qty::value_type>(raw_qty, lot_size);
+        if (!lots) return std::nullopt;
+        return Qty{*lots};
+    }
+
+    /**
+     * @brief Convert ticks back to raw price
+     */
+    [[nodiscard]] constexpr std::int64_t raw_price(Price price) const noexcept {
+        return static_cast<std::int64_t>(price.get()) * tick_size;
+    }
+
+    /**
+     * @brief Convert lots back to raw quantity
+     */
+    [[nodiscard]] constexpr std::int64_t raw_qty(Qty qty) const noexcept {
+        return static_cast<std::int64_t>(qty.get()) * lot_size;
+    }
+
+    /**
+     * @brief Convert an internal notional (ticks x lots) to raw units
+     */
+    [[nodiscard]] constexpr std::int64_t raw_notional(std::int64_t tick_lots) const noexcept {
+        return tick_lots * tick_size * lot_size;
+    }
+
+private:
+    template<typename T>
+    [[nodiscard]] static constexpr std::optional<T> to_units(std::int64_t raw, std::int64_t unit) noexcept {
+        if (unit <= 0 || raw % unit != 0) {
+            return std::nullopt;
+        }
+        std::int64_t units = raw / unit;
+        if (units < std::numeric_limits<T>::min() || units > std::numeric_limits<T>::max()) {
+            return std::nullopt;
+        }
+        return static_cast<T>(units);
+    }
+};
+
+/**
+ * @brief Internal notional value of price x qty in ticks x lots
+ *
+ * Widened to 64 bits since both operands are 32-bit counts.
+ */
+[[nodiscard]] constexpr std::int64_t notional_value(Price price, Qty qty) noexcept {
+    return static_cast<std::int64_t>(price.get()) * static_cast<std::int64_t>(qty.get());
+}
+
+} // namespace ces
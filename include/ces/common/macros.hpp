@@ -64,6 +64,22 @@ inline constexpr std::size_t CACHE_LINE_SIZE = 64;
     #define CES_PREFETCH_WRITE(addr) ((void)0)
 #endif
 
+// ============================================================================
+// Spin-Wait Hint
+// ============================================================================
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    /// Tell the core we are spinning (x86 PAUSE): saves power, frees the sibling hyperthread
+    #define CES_CPU_RELAX() _mm_pause()
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define CES_CPU_RELAX() __builtin_ia32_pause()
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    #define CES_CPU_RELAX() asm volatile("yield" ::: "memory")
+#else
+    #define CES_CPU_RELAX() ((void)0)
+#endif
+
 // ============================================================================
 // Debug Assertions
 // ============================================================================
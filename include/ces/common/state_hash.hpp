@@ -0,0 +1,38 @@
+#pragma once
+/**
+ * @file state_hash.hpp
+ * @brief Order-sensitive 64-bit hash for comparing engine state
+ *
+ * Not cryptographic: it only has to tell a faithful replay from a diverged
+ * one, cheaply enough to run over a full book at the end of a session.
+ */
+
+#include <cstdint>
+
+namespace ces {
+
+/**
+ * @brief Running hash of a sequence of 64-bit words
+ */
+class StateHash {
+private:
+    static constexpr std::uint64_t OFFSET = 0xcbf29ce484222325ULL;
+    static constexpr std::uint64_t PRIME = 0x100000001b3ULL;
+
+    std::uint64_t value_{OFFSET};
+
+public:
+    constexpr StateHash& add(std::uint64_t word) noexcept {
+        value_ = (value_ ^ word) * PRIME;
+        value_ ^= value_ >> 29;
+        return *this;
+    }
+
+    constexpr StateHash& add_signed(std::int64_t word) noexcept {
+        return add(static_cast<std::uint64_t>(word));
+    }
+
+    [[nodiscard]] constexpr std::uint64_t value() const noexcept { return value_; }
+};
+
+} // namespace ces
@@ -0,0 +1,124 @@
+#pragma once
+/**
+ * @file tsc_clock.hpp
+ * @brief Calibrated time-stamp counter clock for hot-path timestamps
+ *
+ * Reading the TSC is a single instruction; now_ns() goes through
+ * high_resolution_clock (a vDSO call at best). The engine can take its
+ * per-event timestamps in TSC ticks and record durations in ticks,
+ * converting to nanoseconds only when stats are read.
+ *
+ * Ticks are only a clock if the counter runs at a constant rate in every
+ * power state and is synchronized across cores: the invariant TSC that
+ * CPUID leaf 0x80000007 reports. Without it calibrate() fails and callers
+ * stay on now_ns().
+ */
+
+#include <ces/common/types.hpp>
+#include <ces/common/time.hpp>
+#include <ces/common/macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace ces {
+
+/**
+ * @brief Clock the engine stamps its per-event timestamps with
+ */
+enum class TimeSource : std::uint8_t {
+    System = 0,  // now_ns()
+    Tsc = 1      // TscClock ticks, converted when stats are read
+};
+
+[[nodiscard]] constexpr const char* to_string(TimeSource s) noexcept {
+    switch (s) {
+        case TimeSource::System: return "System";
+        case TimeSource::Tsc:    return "Tsc";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Parse a CLI name ("system", "tsc")
+ */
+[[nodiscard]] constexpr std::optional<TimeSource> parse_time_source(std::string_view name) noexcept {
+    if (name == "system") return TimeSource::System;
+    if (name == "tsc")    return TimeSource::Tsc;
+    return std::nullopt;
+}
+
+/**
+ * @brief TSC ticks with a measured rate and an anchor to now_ns()
+ *
+ * The rate is measured against CLOCK_MONOTONIC (std::chrono::steady_clock)
+ * over a short busy window. The anchor pairs one tick count with one
+ * now_ns() reading, so producer timestamps (OrderEvent::enqueue_time) can
+ * be mapped into ticks and engine ticks back into timestamps.
+ *
+ * The mapping drifts from now_ns() as the session goes on: a few ppm of
+ * rate error, plus any slew or step of the system clock, both accumulate
+ * from the anchor. reanchor() takes a fresh anchor at the measured rate,
+ * so the drift is bounded by what accrues between re-anchors.
+ *
+ * Immutable after calibrate() except for reanchor(); safe to share between
+ * threads as long as no thread re-anchors it.
+ */
+class TscClock {
+private:
+    double ticks_per_ns_{1.0};
+    double ns_per_tick_{1.0};
+    std::uint64_t anchor_ticks_{0};
+    Timestamp anchor_ns_{0};
+
+public:
+    /**
+     * @brief Whether the CPU advertises an invariant TSC (x86-64 only)
+     */
+    [[nodiscard]] static bool invariant_tsc() noexcept;
+
+    /**
+     * @brief Measure the tick rate
+     * @param window Busy-wait between the two reference readings; longer
+     *        is more precise (10 ms gives a few ppm)
+     * @return nullopt without an invariant TSC or on an implausible rate
+     */
+    [[nodiscard]] static std::optional<TscClock> calibrate(
+        std::chrono::milliseconds window = std::chrono::milliseconds{10});
+
+    /**
+     * @brief Pair a fresh tick count with now_ns() (rate unchanged)
+     */
+    void reanchor() noexcept;
+
+    /**
+     * @brief Current tick count (not serializing; see rdtscp for that)
+     */
+    [[nodiscard]] CES_FORCE_INLINE static std::uint64_t ticks() noexcept { return rdtsc(); }
+
+    /// Tick duration to nanoseconds
+    [[nodiscard]] Duration to_ns(std::int64_t ticks) const noexcept {
+        return static_cast<Duration>(static_cast<double>(ticks) * ns_per_tick_);
+    }
+
+    /// Tick count to a now_ns() timestamp
+    [[nodiscard]] Timestamp to_timestamp(std::uint64_t ticks) const noexcept {
+        return anchor_ns_ + static_cast<Timestamp>(to_ns(static_cast<std::int64_t>(ticks - anchor_ticks_)));
+    }
+
+    /// now_ns() timestamp to a tick count
+    [[nodiscard]] std::uint64_t from_timestamp(Timestamp ns) const noexcept {
+        const auto delta = static_cast<double>(static_cast<Duration>(ns - anchor_ns_));
+        return anchor_ticks_ + static_cast<std::uint64_t>(static_cast<std::int64_t>(delta * ticks_per_ns_));
+    }
+
+    /// Tick count of the current anchor
+    [[nodiscard]] std::uint64_t anchor_ticks() const noexcept { return anchor_ticks_; }
+
+    [[nodiscard]] double ticks_per_ns() const noexcept { return ticks_per_ns_; }
+    [[nodiscard]] double ns_per_tick() const noexcept { return ns_per_tick_; }
+};
+
+} // namespace ces
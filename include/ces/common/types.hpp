@@ -5,6 +5,9 @@
  * 
  * Defines Price, Qty, OrderId, TraderId with strong typing to prevent
  * accidental mixing of incompatible numeric types.
+ * 
+ * Price and Qty are 32-bit tick/lot counts. Raw exchange units are only
+ * seen at the API boundary and converted through ces::Instrument.
  */
 
 // Prevent Windows min/max macros from conflicting with std::numeric_limits
@@ -17,6 +20,7 @@
 #include <cstdint>
 #include <limits>
 #include <compare>
+#include <functional>
 
 namespace ces {
 
@@ -31,6 +35,8 @@ namespace ces {
  */
 template<typename T, typename Tag>
 struct StrongType {
+    using value_type = T;
+    
     T value{};
     
     constexpr StrongType() noexcept = default;
@@ -76,11 +82,11 @@ struct PoolIndexTag {};
 // Core Types
 // ============================================================================
 
-/// Price in integer ticks (e.g., cents or basis points)
-using Price = StrongType<std::int64_t, PriceTag>;
+/// Price as a count of instrument ticks (see Instrument for conversion)
+using Price = StrongType<std::int32_t, PriceTag>;
 
-/// Quantity in units (shares, contracts, etc.)
-using Qty = StrongType<std::int64_t, QtyTag>;
+/// Quantity as a count of instrument lots (see Instrument for conversion)
+using Qty = StrongType<std::int32_t, QtyTag>;
 
 /// Unique order identifier
 using OrderId = StrongType<std::uint64_t, OrderIdTag>;
@@ -109,6 +115,9 @@ inline constexpr TraderId INVALID_TRADER_ID{std::numeric_limits<std::uint32_t>::
 /// Default price tick size
 inline constexpr std::int64_t DEFAULT_TICK_SIZE = 1;
 
+/// Default quantity lot size
+inline constexpr std::int64_t DEFAULT_LOT_SIZE = 1;
+
 /// Default maximum price levels per side
 inline constexpr std::size_t DEFAULT_MAX_PRICE_LEVELS = 1024;
 
@@ -0,0 +1,278 @@
+#pragma once
+/**
+ * @file mpsc_queue.hpp
+ * @brief Bounded lock-free Multi-Producer Single-Consumer queue
+ *
+ * Vyukov-style ring: every slot carries a sequence number that says whose
+ * turn it is. Producers claim a position with one CAS on the shared head
+ * and publish the slot by advancing its sequence; the single consumer
+ * never does a read-modify-write. Same interface as the SPSC queues, so
+ * the engine and traders can use it through the EventQueue concept.
+ */
+
+#include <ces/common/types.hpp>
+#include <ces/common/macros.hpp>
+#include <ces/memory/page_allocator.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <thread>
+#include <type_traits>
+
+namespace ces {
+
+/**
+ * @brief Bounded lock-free MPSC queue with per-slot sequence numbers
+ *
+ * @tparam T Element type (should be trivially copyable)
+ * @tparam Capacity Queue capacity (must be power of 2)
+ *
+ * Thread Safety:
+ * - ANY number of producer threads call push()/try_push()
+ * - ONE consumer thread calls pop()/try_pop()/try_pop_n()
+ *
+ * Slot Protocol (slot i, position pos with pos & MASK == i):
+ * - sequence == pos           : free, producer for pos may write
+ * - sequence == pos + 1       : written, consumer for pos may read
+ * - sequence == pos + Capacity: read, free for the next lap
+ *
+ * A producer that has claimed a position but not yet published it holds
+ * back the consumer for later positions (FIFO order is by claim).
+ */
+template<typename T, std::size_t Capacity>
+    requires (Capacity > 1 && (Capacity & (Capacity - 1)) == 0)  // Power of 2
+class MpscQueue {
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    /// Pause-hinted polls before a blocking call starts yielding
+    static constexpr std::uint32_t SPIN_LIMIT = 1024;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    // Page aligned, optionally huge-page backed
+    PageAllocation memory_;
+    Cell* cells_{nullptr};
+
+    // Shared by all producers (CAS)
+    struct alignas(CACHE_LINE_SIZE) {
+        std::atomic<std::size_t> value{0};
+    } head_;
+
+    // Written only by the consumer; atomic so size_approx() may read it
+    struct alignas(CACHE_LINE_SIZE) {
+        std::atomic<std::size_t> value{0};
+    } tail_;
+
+public:
+    /**
+     * @brief Construct queue
+     * @param policy Buffer allocation policy (heap by default)
+     */
+    explicit MpscQueue(const AllocationPolicy& policy = {})
+        : memory_(sizeof(Cell) * Capacity, policy)
+        , cells_(static_cast<Cell*>(memory_.data())) {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            new (&cells_[i]) Cell{};
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscQueue() {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            cells_[i].~Cell();
+        }
+    }
+
+    // Non-copyable, non-movable
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    MpscQueue(MpscQueue&&) = delete;
+    MpscQueue& operator=(MpscQueue&&) = delete;
+
+    // ========================================================================
+    // Producer Interface (any thread)
+    // ========================================================================
+
+    /**
+     * @brief Push element (spins, then yields, while full)
+     */
+    void push(const T& value) noexcept {
+        for (std::uint32_t polls = 0; !try_push(value); ++polls) {
+            backoff(polls);
+        }
+    }
+
+    /**
+     * @brief Try to push element (non-blocking)
+     * @return true if pushed, false if queue was full
+     */
+    [[nodiscard]] bool try_push(const T& value) noexcept {
+        std::size_t pos = head_.value.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & MASK];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                // Slot free for this lap: claim the position
+                if (head_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+                // CAS failure reloaded pos
+            } else if (diff < 0) {
+                return false;  // Slot still holds last lap's element: full
+            } else {
+                pos = head_.value.load(std::memory_order_relaxed);  // Lost the race
+            }
+        }
+
+        cell->data = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Try to push with timeout
+     * @return true if pushed, false if timeout
+     */
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool try_push_for(const T& value,
+                                     std::chrono::duration<Rep, Period> timeout) noexcept {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (std::uint32_t polls = 0; !try_push(value); ++polls) {
+            if (polls >= SPIN_LIMIT && std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            backoff(polls);
+        }
+        return true;
+    }
+
+    // ========================================================================
+    // Consumer Interface (call from ONE thread only)
+    // ========================================================================
+
+    /**
+     * @brief Pop element (spins, then yields, while empty)
+     */
+    void pop(T& out) noexcept {
+        for (std::uint32_t polls = 0; !try_pop(out); ++polls) {
+            backoff(polls);
+        }
+    }
+
+    /**
+     * @brief Pop element (spins, then yields, while empty)
+     * @return Popped value
+     */
+    [[nodiscard]] T pop() noexcept {
+        T value;
+        pop(value);
+        return value;
+    }
+
+    /**
+     * @brief Try to pop element (non-blocking)
+     * @return true if popped, false if empty (or the next slot is not yet published)
+     */
+    [[nodiscard]] CES_FORCE_INLINE bool try_pop(T& out) noexcept {
+        const std::size_t pos = tail_.value.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & MASK];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+
+        out = std::move(cell.data);
+        cell.sequence.store(pos + Capacity, std::memory_order_release);
+        tail_.value.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Pop up to min(out.size(), max) consecutive published elements
+     * @return Number of elements popped (0 if empty)
+     *
+     * Each slot is handed back to producers with its own sequence store;
+     * the consumer index is written once.
+     */
+    [[nodiscard]] std::size_t try_pop_n(std::span<T> out, std::size_t max) noexcept {
+        const std::size_t wanted = std::min(out.size(), max);
+        const std::size_t tail = tail_.value.load(std::memory_order_relaxed);
+
+        std::size_t count = 0;
+        for (; count < wanted; ++count) {
+            const std::size_t pos = tail + count;
+            Cell& cell = cells_[pos & MASK];
+            if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+                break;
+            }
+            out[count] = std::move(cell.data);
+            cell.sequence.store(pos + Capacity, std::memory_order_release);
+        }
+
+        if (count > 0) {
+            tail_.value.store(tail + count, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Try to pop with timeout
+     * @return true if popped, false if timeout
+     */
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool try_pop_for(T& out,
+                                    std::chrono::duration<Rep, Period> timeout) noexcept {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (std::uint32_t polls = 0; !try_pop(out); ++polls) {
+            if (polls >= SPIN_LIMIT && std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            backoff(polls);
+        }
+        return true;
+    }
+
+    // ========================================================================
+    // Query Interface (can be called from any thread, approximate values)
+    // ========================================================================
+
+    /**
+     * @brief Approximate number of items in queue (includes claimed, unpublished slots)
+     */
+    [[nodiscard]] std::size_t size_approx() const noexcept {
+        const std::size_t tail = tail_.value.load(std::memory_order_acquire);
+        const std::size_t head = head_.value.load(std::memory_order_acquire);
+        return head > tail ? head - tail : 0;
+    }
+
+    [[nodiscard]] constexpr std::size_t capacity() const noexcept { return Capacity; }
+
+    /**
+     * @brief Memory backing actually obtained for the buffer
+     */
+    [[nodiscard]] PageBacking backing() const noexcept { return memory_.backing(); }
+
+    [[nodiscard]] bool empty_approx() const noexcept { return size_approx() == 0; }
+    [[nodiscard]] bool full_approx() const noexcept { return size_approx() >= Capacity; }
+
+private:
+    static void backoff(std::uint32_t polls) noexcept {
+        if (polls < SPIN_LIMIT) {
+            CES_CPU_RELAX();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+} // namespace ces
@@ -0,0 +1,100 @@
+#pragma once
+/**
+ * @file sequence.hpp
+ * @brief Disruptor-style sequence counters and barriers
+ *
+ * A Sequence counts how many ring slots a stage has finished. Downstream
+ * stages wait on a SequenceBarrier over their upstream sequences, and the
+ * publisher is gated by the slowest final stage so it never overwrites a
+ * slot still being read. Slots themselves are never copied between stages.
+ */
+
+#include <ces/common/macros.hpp>
+#include <ces/concurrency/wait_strategy.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <stop_token>
+#include <vector>
+
+namespace ces {
+
+/**
+ * @brief Cache-line padded completion counter owned by one stage
+ *
+ * Value n means slots [0, n) are done. Written by its owner only.
+ */
+class alignas(CACHE_LINE_SIZE) Sequence {
+private:
+    std::atomic<std::uint64_t> value_{0};
+
+public:
+    Sequence() = default;
+
+    Sequence(const Sequence&) = delete;
+    Sequence& operator=(const Sequence&) = delete;
+
+    [[nodiscard]] CES_FORCE_INLINE std::uint64_t get() const noexcept {
+        return value_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Publish completion up to (excluding) value; releases slot writes
+     */
+    CES_FORCE_INLINE void set(std::uint64_t value) noexcept {
+        value_.store(value, std::memory_order_release);
+    }
+
+    /**
+     * @brief Reset to zero (only while no stage is running)
+     */
+    void reset() noexcept { value_.store(0, std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Minimum over a fixed set of upstream sequences
+ */
+class SequenceBarrier {
+private:
+    std::vector<const Sequence*> upstream_;
+
+public:
+    SequenceBarrier(std::initializer_list<const Sequence*> upstream)
+        : upstream_(upstream) {}
+
+    /**
+     * @brief Number of slots every upstream stage has finished
+     */
+    [[nodiscard]] std::uint64_t available() const noexcept {
+        std::uint64_t minimum = std::numeric_limits<std::uint64_t>::max();
+        for (const Sequence* seq : upstream_) {
+            minimum = std::min(minimum, seq->get());
+        }
+        return minimum;
+    }
+
+    /**
+     * @brief Wait until more than `processed` slots are available
+     * @return Available count (> processed), or processed if stop was
+     *         requested while waiting
+     */
+    std::uint64_t wait_for(std::uint64_t processed, IdleWaiter& waiter,
+                           std::stop_token stop_token) const {
+        for (;;) {
+            const std::uint64_t ready = available();
+            if (ready > processed) {
+                waiter.reset();
+                return ready;
+            }
+            if (stop_token.stop_requested()) {
+                return processed;
+            }
+            waiter.idle();
+        }
+    }
+};
+
+} // namespace ces
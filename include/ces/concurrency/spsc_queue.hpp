@@ -0,0 +1,320 @@
+#pragma once
+/**
+ * @file spsc_queue.hpp
+ * @brief Lock-free Single-Producer Single-Consumer queue
+ *
+ * Same interface as SpscSemaphoreQueue, but coordination is done purely
+ * with acquire/release head and tail indices. Each side keeps a private
+ * copy of the other side's index and only reloads it when the copy says
+ * the queue is full (producer) or empty (consumer), so in steady state
+ * neither thread touches the other's cache line.
+ */
+
+#include <ces/common/types.hpp>
+#include <ces/common/macros.hpp>
+#include <ces/memory/page_allocator.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <thread>
+#include <type_traits>
+
+namespace ces {
+
+/**
+ * @brief Bounded lock-free SPSC queue with cached opposite indices
+ *
+ * @tparam T Element type (should be trivially copyable)
+ * @tparam Capacity Queue capacity (must be power of 2)
+ *
+ * Thread Safety:
+ * - ONE producer thread calls push()/try_push()
+ * - ONE consumer thread calls pop()/try_pop()
+ *
+ * Index Protocol:
+ * - Producer writes slot, then head.store(release)
+ * - Consumer head.load(acquire), reads slot, then tail.store(release)
+ *
+ * Blocking calls (push, pop, *_for) spin with a CPU pause hint and then
+ * yield; there is no kernel object to sleep on.
+ *
+ * Batches: try_push_n()/try_pop_n() move a run of elements and publish it
+ * with one index store. read_available()/consume() let the consumer work
+ * on elements in place; slots stay owned by the consumer until consume().
+ */
+template<typename T, std::size_t Capacity>
+    requires (Capacity > 0 && (Capacity & (Capacity - 1)) == 0)  // Power of 2
+class SpscQueue {
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    /// Pause-hinted polls before a blocking call starts yielding
+    static constexpr std::uint32_t SPIN_LIMIT = 1024;
+
+    // Page aligned, optionally huge-page backed
+    PageAllocation memory_;
+    T* buffer_{nullptr};
+
+    // Producer line: own index plus its view of the consumer index
+    struct alignas(CACHE_LINE_SIZE) {
+        std::atomic<std::size_t> value{0};
+        std::size_t cached_tail{0};
+    } head_;
+
+    // Consumer line: own index plus its view of the producer index
+    struct alignas(CACHE_LINE_SIZE) {
+        std::atomic<std::size_t> value{0};
+        std::size_t cached_head{0};
+    } tail_;
+
+public:
+    /**
+     * @brief Construct queue
+     * @param policy Buffer allocation policy (heap by default)
+     */
+    explicit SpscQueue(const AllocationPolicy& policy = {})
+        : memory_(sizeof(T) * Capacity, policy)
+        , buffer_(static_cast<T*>(memory_.data())) {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            new (&buffer_[i]) T{};
+        }
+    }
+
+    ~SpscQueue() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (std::size_t i = 0; i < Capacity; ++i) {
+                buffer_[i].~T();
+            }
+        }
+    }
+
+    // Non-copyable, non-movable
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+    SpscQueue(SpscQueue&&) = delete;
+    SpscQueue& operator=(SpscQueue&&) = delete;
+
+    // ========================================================================
+    // Producer Interface (call from ONE thread only)
+    // ========================================================================
+
+    /**
+     * @brief Push element (spins, then yields, while full)
+     */
+    void push(const T& value) noexcept {
+        for (std::uint32_t polls = 0; !try_push(value); ++polls) {
+            backoff(polls);
+        }
+    }
+
+    /**
+     * @brief Try to push element (non-blocking)
+     * @return true if pushed, false if queue was full
+     */
+    [[nodiscard]] CES_FORCE_INLINE bool try_push(const T& value) noexcept {
+        const std::size_t head = head_.value.load(std::memory_order_relaxed);
+        if CES_UNLIKELY(head - head_.cached_tail >= Capacity) {
+            // Looks full: refresh the consumer index (the only cross-core read)
+            head_.cached_tail = tail_.value.load(std::memory_order_acquire);
+            if (head - head_.cached_tail >= Capacity) {
+                return false;
+            }
+        }
+
+        buffer_[head & MASK] = value;
+        head_.value.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Try to push with timeout
+     * @return true if pushed, false if timeout
+     */
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool try_push_for(const T& value,
+                                     std::chrono::duration<Rep, Period> timeout) noexcept {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (std::uint32_t polls = 0; !try_push(value); ++polls) {
+            if (polls >= SPIN_LIMIT && std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            backoff(polls);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Push up to values.size() elements, published with one release store
+     * @return Number of elements pushed (0 if full)
+     */
+    [[nodiscard]] std::size_t try_push_n(std::span<const T> values) noexcept {
+        const std::size_t head = head_.value.load(std::memory_order_relaxed);
+        if (Capacity - (head - head_.cached_tail) < values.size()) {
+            head_.cached_tail = tail_.value.load(std::memory_order_acquire);
+        }
+        const std::size_t count = std::min(values.size(), Capacity - (head - head_.cached_tail));
+        if (count == 0) {
+            return 0;
+        }
+
+        // At most two contiguous runs: up to the end of the buffer, then from the start
+        const std::size_t start = head & MASK;
+        const std::size_t first = std::min(count, Capacity - start);
+        std::copy_n(values.data(), first, buffer_ + start);
+        std::copy_n(values.data() + first, count - first, buffer_);
+
+        head_.value.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // ========================================================================
+    // Consumer Interface (call from ONE thread only)
+    // ========================================================================
+
+    /**
+     * @brief Pop element (spins, then yields, while empty)
+     */
+    void pop(T& out) noexcept {
+        for (std::uint32_t polls = 0; !try_pop(out); ++polls) {
+            backoff(polls);
+        }
+    }
+
+    /**
+     * @brief Pop element (spins, then yields, while empty)
+     * @return Popped value
+     */
+    [[nodiscard]] T pop() noexcept {
+        T value;
+        pop(value);
+        return value;
+    }
+
+    /**
+     * @brief Try to pop element (non-blocking)
+     * @return true if popped, false if queue was empty
+     */
+    [[nodiscard]] CES_FORCE_INLINE bool try_pop(T& out) noexcept {
+        const std::size_t tail = tail_.value.load(std::memory_order_relaxed);
+        if CES_UNLIKELY(tail == tail_.cached_head) {
+            // Looks empty: refresh the producer index
+            tail_.cached_head = head_.value.load(std::memory_order_acquire);
+            if (tail == tail_.cached_head) {
+                return false;
+            }
+        }
+
+        out = std::move(buffer_[tail & MASK]);
+        tail_.value.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Try to pop with timeout
+     * @return true if popped, false if timeout
+     */
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool try_pop_for(T& out,
+                                    std::chrono::duration<Rep, Period> timeout) noexcept {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (std::uint32_t polls = 0; !try_pop(out); ++polls) {
+            if (polls >= SPIN_LIMIT && std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            backoff(polls);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Pop up to min(out.size(), max) elements, released with one store
+     * @return Number of elements popped (0 if empty)
+     */
+    [[nodiscard]] std::size_t try_pop_n(std::span<T> out, std::size_t max) noexcept {
+        const std::size_t wanted = std::min(out.size(), max);
+        const std::size_t tail = tail_.value.load(std::memory_order_relaxed);
+        if (tail_.cached_head - tail < wanted) {
+            tail_.cached_head = head_.value.load(std::memory_order_acquire);
+        }
+        const std::size_t count = std::min(wanted, tail_.cached_head - tail);
+        if (count == 0) {
+            return 0;
+        }
+
+        const std::size_t start = tail & MASK;
+        const std::size_t first = std::min(count, Capacity - start);
+        std::copy_n(buffer_ + start, first, out.data());
+        std::copy_n(buffer_, count - first, out.data() + first);
+
+        tail_.value.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Zero-copy view of readable elements
+     * @param max Upper bound on the view length
+     * @return Contiguous run starting at the tail (stops at the buffer end,
+     *         so a wrapped backlog takes two calls); empty if the queue is empty
+     *
+     * The slots are not released until consume() is called.
+     */
+    [[nodiscard]] std::span<const T> read_available(std::size_t max = Capacity) noexcept {
+        const std::size_t tail = tail_.value.load(std::memory_order_relaxed);
+        if (tail == tail_.cached_head) {
+            tail_.cached_head = head_.value.load(std::memory_order_acquire);
+        }
+        const std::size_t start = tail & MASK;
+        const std::size_t count = std::min({tail_.cached_head - tail, Capacity - start, max});
+        return {buffer_ + start, count};
+    }
+
+    /**
+     * @brief Release the first count elements of the last read_available() view
+     */
+    CES_FORCE_INLINE void consume(std::size_t count) noexcept {
+        CES_ASSERT_MSG(count <= tail_.cached_head - tail_.value.load(std::memory_order_relaxed),
+                   "consume() past the readable range");
+        tail_.value.store(tail_.value.load(std::memory_order_relaxed) + count,
+                          std::memory_order_release);
+    }
+
+    // ========================================================================
+    // Query Interface (can be called from any thread, approximate values)
+    // ========================================================================
+
+    /**
+     * @brief Approximate number of items in queue
+     * @note May not be exact under concurrent access
+     */
+    [[nodiscard]] std::size_t size_approx() const noexcept {
+        std::size_t head = head_.value.load(std::memory_order_acquire);
+        std::size_t tail = tail_.value.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    [[nodiscard]] constexpr std::size_t capacity() const noexcept { return Capacity; }
+
+    /**
+     * @brief Memory backing actually obtained for the buffer
+     */
+    [[nodiscard]] PageBacking backing() const noexcept { return memory_.backing(); }
+
+    [[nodiscard]] bool empty_approx() const noexcept { return size_approx() == 0; }
+    [[nodiscard]] bool full_approx() const noexcept { return size_approx() >= Capacity; }
+
+private:
+    static void backoff(std::uint32_t polls) noexcept {
+        if (polls < SPIN_LIMIT) {
+            CES_CPU_RELAX();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+} // namespace ces
@@ -9,12 +9,17 @@
 
 #include <ces/common/types.hpp>
 #include <ces/common/macros.hpp>
+#include <ces/memory/page_allocator.hpp>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
 #include <memory>
+#include <new>
 #include <semaphore>
+#include <span>
+#include <type_traits>
 
 namespace ces {
 
@@ -35,6 +40,9 @@ namespace ces {
  * 
  * Producer: free_slots.acquire() -> write -> filled_slots.release()
  * Consumer: filled_slots.acquire() -> read -> free_slots.release()
+ *
+ * Batch variants acquire tokens one by one (std::counting_semaphore has no
+ * try_acquire(n)) but write the index and release the peer semaphore once.
  */
 template<typename T, std::size_t Capacity>
     requires (Capacity > 0 && (Capacity & (Capacity - 1)) == 0)  // Power of 2
@@ -42,9 +50,10 @@ class SpscSemaphoreQueue {
 private:
     static constexpr std::size_t MASK = Capacity - 1;
     
-    // Heap-allocated buffer to avoid stack overflow with large capacities
-    // Cache-line aligned for performance
-    std::unique_ptr<T[]> buffer_;
+    // Page-allocated buffer to avoid stack overflow with large capacities
+    // Page aligned, optionally huge-page backed
+    PageAllocation memory_;
+    T* buffer_{nullptr};
     
     // Producer index - only written by producer
     struct alignas(CACHE_LINE_SIZE) {
@@ -61,8 +70,25 @@ private:
     std::counting_semaphore<Capacity> filled_slots_{0};
 
 public:
-    SpscSemaphoreQueue() : buffer_(new T[Capacity]{}) {}
-    ~SpscSemaphoreQueue() = default;
+    /**
+     * @brief Construct queue
+     * @param policy Buffer allocation policy (heap by default)
+     */
+    explicit SpscSemaphoreQueue(const AllocationPolicy& policy = {})
+        : memory_(sizeof(T) * Capacity, policy)
+        , buffer_(static_cast<T*>(memory_.data())) {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            new (&buffer_[i]) T{};
+        }
+    }
+    
+    ~SpscSemaphoreQueue() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (std::size_t i = 0; i < Capacity; ++i) {
+                buffer_[i].~T();
+            }
+        }
+    }
     
     // Non-copyable, non-movable
     SpscSemaphoreQueue(const SpscSemaphoreQueue&) = delete;
@@ -145,6 +171,27 @@ public:
         return true;
     }
     
+    /**
+     * @brief Push up to values.size() elements with one index store and one release
+     * @return Number of elements pushed (0 if full)
+     */
+    [[nodiscard]] std::size_t try_push_n(std::span<const T> values) noexcept {
+        const std::size_t count = try_acquire_up_to(free_slots_, values.size());
+        if (count == 0) {
+            return 0;
+        }
+        
+        const std::size_t head = head_.value.load(std::memory_order_relaxed);
+        const std::size_t start = head & MASK;
+        const std::size_t first = std::min(count, Capacity - start);
+        std::copy_n(values.data(), first, buffer_ + start);
+        std::copy_n(values.data() + first, count - first, buffer_);
+        head_.value.store(head + count, std::memory_order_release);
+        
+        filled_slots_.release(static_cast<std::ptrdiff_t>(count));
+        return count;
+    }
+    
     // ========================================================================
     // Consumer Interface (call from ONE thread only)
     // ========================================================================
@@ -216,6 +263,27 @@ public:
         return true;
     }
     
+    /**
+     * @brief Pop up to min(out.size(), max) elements with one index store and one release
+     * @return Number of elements popped (0 if empty)
+     */
+    [[nodiscard]] std::size_t try_pop_n(std::span<T> out, std::size_t max) noexcept {
+        const std::size_t count = try_acquire_up_to(filled_slots_, std::min(out.size(), max));
+        if (count == 0) {
+            return 0;
+        }
+        
+        const std::size_t tail = tail_.value.load(std::memory_order_relaxed);
+        const std::size_t start = tail & MASK;
+        const std::size_t first = std::min(count, Capacity - start);
+        std::copy_n(buffer_ + start, first, out.data());
+        std::copy_n(buffer_, count - first, out.data() + first);
+        tail_.value.store(tail + count, std::memory_order_release);
+        
+        free_slots_.release(static_cast<std::ptrdiff_t>(count));
+        return count;
+    }
+    
     // ========================================================================
     // Query Interface (can be called from any thread, approximate values)
     // ========================================================================
@@ -237,6 +305,11 @@ public:
         return Capacity;
     }
     
+    /**
+     * @brief Memory backing actually obtained for the buffer
+     */
+    [[nodiscard]] PageBacking backing() const noexcept { return memory_.backing(); }
+    
     /**
      * @brief Check if queue appears empty
      */
@@ -250,6 +323,16 @@ public:
     [[nodiscard]] bool full_approx() const noexcept {
         return size_approx() >= Capacity;
     }
+
+private:
+    static std::size_t try_acquire_up_to(std::counting_semaphore<Capacity>& sem,
+                                         std::size_t limit) noexcept {
+        std::size_t acquired = 0;
+        while (acquired < limit && sem.try_acquire()) {
+            ++acquired;
+        }
+        return acquired;
+    }
 };
 
 } // namespace ces
@@ -0,0 +1,270 @@
+#pragma once
+/**
+ * @file versioned_config.hpp
+ * @brief Immutable configuration snapshots published through one atomic pointer
+ *
+ * Operators build a new value and publish() it; the hot path reads the
+ * current snapshot with a single acquire load and never locks.
+ *
+ * Superseded snapshots are reclaimed by quiescent-state tracking. A thread
+ * that keeps snapshot pointers across publishes (the risk check) registers
+ * a Reader and calls quiescent() at points where it holds none, which
+ * stores the version it has caught up with into its own slot, and
+ * offline() before it blocks. publish() frees every retired snapshot that
+ * all online readers have moved past, so retention is bounded by the
+ * publishes between two quiescent points of a running reader, not by the
+ * holder's lifetime.
+ */
+
+#include <ces/common/macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ces {
+
+/**
+ * @brief Holder of the current immutable snapshot of T
+ *
+ * A snapshot from get() stays valid until the next publish() unless the
+ * calling thread holds a Reader, in which case it stays valid until that
+ * reader's next quiescent() (or its destruction).
+ *
+ * Thread Safety:
+ * - get(), Reader::get(), Reader::quiescent(): any thread, wait-free
+ * - publish(), register_reader(): any thread (serialize on a mutex)
+ * - The holder must outlive its readers
+ */
+template<typename T, std::size_t MaxReaders = 64>
+class VersionedConfig {
+private:
+    /// Slot value of a reader that holds no snapshot
+    static constexpr std::uint64_t IDLE = std::numeric_limits<std::uint64_t>::max();
+    static constexpr std::uint32_t NO_SLOT = std::numeric_limits<std::uint32_t>::max();
+
+    struct alignas(CACHE_LINE_SIZE) ReaderSlot {
+        std::atomic<std::uint64_t> seen{IDLE};  // Version caught up with at last quiescent()
+        bool used{false};                       // Under mutex_
+    };
+
+    /// A superseded snapshot and the version that replaced it
+    struct Retired {
+        std::unique_ptr<const T> snapshot;
+        std::uint64_t superseded_by{0};
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<const T*> current_;
+    std::atomic<std::uint64_t> version_{0};
+
+    // Registering a reader does not change the published value, so readers
+    // can register through a const holder
+    mutable std::array<ReaderSlot, MaxReaders> readers_;
+
+    // Touched only under mutex_
+    std::unique_ptr<const T> live_;
+    std::vector<Retired> retired_;
+    mutable std::uint32_t unslotted_readers_{0};  // Readers beyond MaxReaders: reclaim nothing
+    mutable std::mutex mutex_;
+
+public:
+    /**
+     * @brief Registration of a thread that holds snapshots across publishes
+     *
+     * Move-only; unregisters on destruction. A default-constructed Reader
+     * is unattached and get() returns nullptr.
+     */
+    class Reader {
+    private:
+        const VersionedConfig* config_{nullptr};
+        std::uint32_t slot_{NO_SLOT};
+        bool online_{true};
+
+        friend class VersionedConfig;
+        Reader(const VersionedConfig* config, std::uint32_t slot) noexcept : config_(config), slot_(slot) {}
+
+    public:
+        Reader() = default;
+        ~Reader() { reset(); }
+
+        Reader(Reader&& other) noexcept
+            : config_(std::exchange(other.config_, nullptr))
+            , slot_(std::exchange(other.slot_, NO_SLOT))
+            , online_(std::exchange(other.online_, true)) {}
+
+        Reader& operator=(Reader&& other) noexcept {
+            if (this != &other) {
+                reset();
+                config_ = std::exchange(other.config_, nullptr);
+                slot_ = std::exchange(other.slot_, NO_SLOT);
+                online_ = std::exchange(other.online_, true);
+            }
+            return *this;
+        }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        [[nodiscard]] explicit operator bool() const noexcept { return config_ != nullptr; }
+
+        /**
+         * @brief Current snapshot, valid until this reader's next quiescent()
+         */
+        [[nodiscard]] CES_FORCE_INLINE const T* get() const noexcept {
+            return config_ ? config_->get() : nullptr;
+        }
+
+        /**
+         * @brief Declare that no snapshot loaded before this call is still in use
+         *
+         * One load and one store to the reader's own cache line (plus a
+         * fence when coming back from offline()).
+         */
+        CES_FORCE_INLINE void quiescent() noexcept {
+            if (config_ && slot_ != NO_SLOT) {
+                config_->readers_[slot_].seen.store(
+                    config_->version_.load(std::memory_order_acquire), std::memory_order_release);
+                if CES_UNLIKELY(!online_) {
+                    // Pairs with the fence in publish(): either that publish
+                    // sees this slot, or the next get() sees its snapshot
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    online_ = true;
+                }
+            }
+        }
+
+        /**
+         * @brief Hold no snapshot until the next quiescent() (e.g. before blocking)
+         *
+         * An offline reader does not hold back reclamation however many
+         * publishes it sleeps through. Do not call get() until quiescent().
+         */
+        void offline() noexcept {
+            if (config_ && slot_ != NO_SLOT) {
+                config_->readers_[slot_].seen.store(IDLE, std::memory_order_release);
+                online_ = false;
+            }
+        }
+
+        /**
+         * @brief Unregister (snapshots from get() may be freed afterwards)
+         */
+        void reset() noexcept {
+            if (config_) {
+                config_->unregister(slot_);
+                config_ = nullptr;
+                slot_ = NO_SLOT;
+            }
+        }
+    };
+
+    explicit VersionedConfig(T initial = {})
+        : live_(std::make_unique<const T>(std::move(initial))) {
+        current_.store(live_.get(), std::memory_order_release);
+    }
+
+    // Non-copyable, non-movable (readers hold pointers into it)
+    VersionedConfig(const VersionedConfig&) = delete;
+    VersionedConfig& operator=(const VersionedConfig&) = delete;
+
+    /**
+     * @brief Current snapshot (see the class note for how long it stays valid)
+     */
+    [[nodiscard]] CES_FORCE_INLINE const T* get() const noexcept {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Register the calling thread as a reader, caught up with the current version
+     *
+     * Past MaxReaders the reader still works but disables reclamation
+     * until it is destroyed.
+     */
+    [[nodiscard]] Reader register_reader() const {
+        std::lock_guard lock(mutex_);
+        for (std::uint32_t i = 0; i < MaxReaders; ++i) {
+            if (!readers_[i].used) {
+                readers_[i].used = true;
+                // Under the publish mutex: a later publish sees this slot, and
+                // this thread's next get() sees at least the version stored
+                readers_[i].seen.store(version_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                return Reader(this, i);
+            }
+        }
+        ++unslotted_readers_;
+        return Reader(this, NO_SLOT);
+    }
+
+    /**
+     * @brief Replace the current snapshot and free retired ones no reader can hold
+     * @return Version number of the new snapshot (initial value is 0)
+     */
+    std::uint64_t publish(T value) {
+        auto next = std::make_unique<const T>(std::move(value));
+        std::lock_guard lock(mutex_);
+        const std::uint64_t version = version_.load(std::memory_order_relaxed) + 1;
+        // Snapshot before version: a reader that sees the version sees the snapshot
+        current_.store(next.get(), std::memory_order_release);
+        version_.store(version, std::memory_order_release);
+        retired_.push_back(Retired{std::move(live_), version});
+        live_ = std::move(next);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        reclaim();
+        return version;
+    }
+
+    /**
+     * @brief Number of publishes so far
+     */
+    [[nodiscard]] std::uint64_t version() const noexcept {
+        return version_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Superseded snapshots not yet freed
+     */
+    [[nodiscard]] std::size_t retained() const {
+        std::lock_guard lock(mutex_);
+        return retired_.size();
+    }
+
+private:
+    /**
+     * @brief Free retired snapshots every registered reader has moved past (mutex_ held)
+     */
+    void reclaim() noexcept {
+        if (unslotted_readers_ > 0) {
+            return;
+        }
+        std::uint64_t oldest_seen = IDLE;
+        for (const ReaderSlot& slot : readers_) {
+            if (slot.used) {
+                oldest_seen = std::min(oldest_seen, slot.seen.load(std::memory_order_acquire));
+            }
+        }
+        std::size_t freed = 0;
+        while (freed < retired_.size() && retired_[freed].superseded_by <= oldest_seen) {
+            ++freed;
+        }
+        retired_.erase(retired_.begin(), retired_.begin() + static_cast<std::ptrdiff_t>(freed));
+    }
+
+    void unregister(std::uint32_t slot) const noexcept {
+        std::lock_guard lock(mutex_);
+        if (slot == NO_SLOT) {
+            --unslotted_readers_;
+            return;
+        }
+        readers_[slot].seen.store(IDLE, std::memory_order_release);
+        readers_[slot].used = false;
+    }
+};
+
+} // namespace ces
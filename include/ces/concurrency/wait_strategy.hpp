@@ -0,0 +1,116 @@
+#pragma once
+/**
+ * @file wait_strategy.hpp
+ * @brief Idle strategies for consumer loops polling a queue
+ *
+ * Blocking on a semaphore costs a futex syscall and a scheduler hop per
+ * wakeup. Spinning strategies trade CPU for latency by polling instead.
+ */
+
+#include <ces/common/macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <thread>
+
+namespace ces {
+
+/**
+ * @brief How a consumer waits when its queue is empty
+ */
+enum class WaitStrategy : std::uint8_t {
+    BusySpin = 0,   // Poll continuously with a CPU pause hint (one core at 100%)
+    SpinYield = 1,  // Spin, then std::this_thread::yield() between polls
+    SpinPark = 2,   // Spin, then sleep for park_duration between polls
+    Blocking = 3    // Block in the queue's timed pop (semaphore/futex)
+};
+
+[[nodiscard]] constexpr const char* to_string(WaitStrategy s) noexcept {
+    switch (s) {
+        case WaitStrategy::BusySpin:  return "BusySpin";
+        case WaitStrategy::SpinYield: return "SpinYield";
+        case WaitStrategy::SpinPark:  return "SpinPark";
+        case WaitStrategy::Blocking:  return "Blocking";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Parse a CLI name ("busy", "yield", "park", "block")
+ */
+[[nodiscard]] constexpr std::optional<WaitStrategy> parse_wait_strategy(std::string_view name) noexcept {
+    if (name == "busy")  return WaitStrategy::BusySpin;
+    if (name == "yield") return WaitStrategy::SpinYield;
+    if (name == "park")  return WaitStrategy::SpinPark;
+    if (name == "block") return WaitStrategy::Blocking;
+    return std::nullopt;
+}
+
+/**
+ * @brief Wait strategy parameters
+ */
+struct WaitConfig {
+    WaitStrategy strategy{WaitStrategy::Blocking};
+    std::uint32_t spin_iterations{10'000};               // Polls before backing off
+    std::chrono::microseconds park_duration{50};         // SpinPark sleep per poll
+    std::chrono::milliseconds block_timeout{10};         // Blocking pop timeout
+};
+
+/**
+ * @brief Per-thread backoff state for a polling loop
+ *
+ * Usage:
+ *   if (queue.try_pop(x)) { waiter.reset(); ... } else if (waiter.idle()) { housekeeping(); }
+ *
+ * Thread Safety: owned by one thread.
+ */
+class IdleWaiter {
+private:
+    WaitConfig config_;
+    std::uint32_t idle_polls_{0};
+
+public:
+    explicit IdleWaiter(const WaitConfig& config) noexcept : config_(config) {}
+
+    [[nodiscard]] WaitStrategy strategy() const noexcept { return config_.strategy; }
+    [[nodiscard]] const WaitConfig& config() const noexcept { return config_; }
+
+    /**
+     * @brief Work was found: restart the spin phase
+     */
+    CES_FORCE_INLINE void reset() noexcept { idle_polls_ = 0; }
+
+    /**
+     * @brief Back off after an empty poll
+     * @return true when the loop has been idle long enough for housekeeping
+     *         (past the spin phase, or every spin_iterations polls when busy-spinning)
+     */
+    bool idle() noexcept {
+        if (idle_polls_ < config_.spin_iterations) {
+            ++idle_polls_;
+            CES_CPU_RELAX();
+            return false;
+        }
+
+        switch (config_.strategy) {
+            case WaitStrategy::BusySpin:
+                idle_polls_ = 0;
+                CES_CPU_RELAX();
+                break;
+            case WaitStrategy::SpinYield:
+                std::this_thread::yield();
+                break;
+            case WaitStrategy::SpinPark:
+                std::this_thread::sleep_for(config_.park_duration);
+                break;
+            case WaitStrategy::Blocking:
+                // Blocking waits inside the queue; nothing to do here
+                break;
+        }
+        return true;
+    }
+};
+
+} // namespace ces
@@ -1,15 +1,19 @@
 #pragma once
 /**
  * @file accounts.hpp
- * @brief Thread-safe account management with striped mutex scheme
+ * @brief Thread-safe account management with a TraderId-indexed directory
  * 
  * Solves the "ATM problem" - concurrent access to shared account state
- * without global lock contention.
+ * without global lock contention. Accounts are found by indexing a two-level
+ * directory with the TraderId (no scan, no lock); only creating an account
+ * takes a mutex.
  */
 
 #include <ces/common/types.hpp>
 #include <ces/common/macros.hpp>
 
+#include <array>
+#include <optional>
 #include <vector>
 #include <mutex>
 #include <atomic>
@@ -18,19 +22,47 @@
 
 namespace ces {
 
+/**
+ * @brief Who may write account state
+ */
+enum class AccountsMode : std::uint8_t {
+    Shared = 0,       // Any thread; every update is an atomic RMW
+    SingleWriter = 1  // One writer thread; plain read-add-store under a seqlock
+};
+
+[[nodiscard]] constexpr const char* to_string(AccountsMode m) noexcept {
+    switch (m) {
+        case AccountsMode::Shared:       return "Shared";
+        case AccountsMode::SingleWriter: return "SingleWriter";
+    }
+    return "Unknown";
+}
+
 /**
  * @brief Individual trader account state
  * 
  * Note: Uses alignas to ensure atomic operations work correctly.
  * Account is not directly copyable/movable due to atomics in the struct,
  * so we use unique_ptr in the Accounts container.
+ * 
+ * In SingleWriter mode the fields are only ever stored (relaxed), never
+ * RMW'd, and `seq` is odd while an update is in progress, so readers can
+ * take a consistent copy with Accounts::snapshot().
+ * 
+ * Open quantities/notionals cover the trader's resting orders, so risk can
+ * bound the worst case (everything open fills) without walking the book.
  */
 struct alignas(CACHE_LINE_SIZE) Account {
     TraderId trader_id{constants::INVALID_TRADER_ID};
+    std::atomic<std::uint32_t> seq{0};      // Seqlock (SingleWriter mode)
     std::atomic<std::int64_t> balance{0};
     std::atomic<std::int64_t> position{0};  // Net position (positive = long)
     std::atomic<std::uint64_t> trade_count{0};
     std::atomic<std::uint64_t> volume{0};
+    std::atomic<std::int64_t> open_buy_qty{0};
+    std::atomic<std::int64_t> open_sell_qty{0};
+    std::atomic<std::int64_t> open_buy_notional{0};   // Sum of price x qty over resting buys
+    std::atomic<std::int64_t> open_sell_notional{0};
     
     Account() = default;
     
@@ -49,47 +81,88 @@ struct alignas(CACHE_LINE_SIZE) Account {
 };
 
 /**
- * @brief Thread-safe account manager using striped mutex scheme
+ * @brief Consistent copy of one account
+ */
+struct AccountSnapshot {
+    TraderId trader_id{constants::INVALID_TRADER_ID};
+    std::int64_t balance{0};
+    std::int64_t position{0};
+    std::uint64_t trade_count{0};
+    std::uint64_t volume{0};
+    std::int64_t open_buy_qty{0};
+    std::int64_t open_sell_qty{0};
+    std::int64_t open_buy_notional{0};
+    std::int64_t open_sell_notional{0};
+};
+
+/**
+ * @brief Thread-safe account manager with O(1) lock-free lookup
  * 
- * Uses multiple mutexes to reduce contention when multiple threads
- * access different accounts concurrently.
+ * The 32-bit TraderId is split into a directory index (high bits) and a
+ * page slot (low bits). Pages of account pointers are allocated on first
+ * use, so memory grows with the ID range actually used, not with 2^32.
+ * Account objects never move once created, so returned pointers stay valid
+ * until clear().
  * 
  * Thread Safety:
- * - All operations are thread-safe
- * - Uses striped locking for balance updates
- * - Atomics for read-only statistics
+ * - get() / balance queries / snapshot(): lock-free, any thread
+ * - apply_trade() / adjust_balance(): any thread in Shared mode; only the
+ *   single writer thread in SingleWriter mode
+ * - Account creation serializes on one mutex (cold path)
+ * - clear() must not race with any other call
  */
 class Accounts {
 public:
-    /// Default number of stripe mutexes
-    static constexpr std::size_t DEFAULT_STRIPE_COUNT = 16;
+    /// Low TraderId bits that select the slot within a page
+    static constexpr std::size_t PAGE_BITS = 16;
+    static constexpr std::size_t PAGE_SIZE = std::size_t{1} << PAGE_BITS;
+    static constexpr std::size_t DIRECTORY_SIZE = std::size_t{1} << (32 - PAGE_BITS);
 
 private:
+    struct Page {
+        std::array<std::atomic<Account*>, PAGE_SIZE> slots{};
+    };
+    
+    /// Field changes applied to one account under one seqlock section
+    struct Delta {
+        std::int64_t balance{0};
+        std::int64_t position{0};
+        std::uint64_t trades{0};
+        std::uint64_t volume{0};
+        Side open_side{Side::Buy};
+        std::int64_t open_qty{0};
+        std::int64_t open_notional{0};
+    };
+    
+    // Directory of lazily allocated pages (published with release)
+    std::unique_ptr<std::atomic<Page*>[]> directory_;
+    
+    // Ownership; touched only under create_mutex_
+    std::vector<std::unique_ptr<Page>> pages_;
     std::vector<std::unique_ptr<Account>> accounts_;
-    std::vector<std::mutex> stripe_mutexes_;
-    std::size_t stripe_count_;
+    std::mutex create_mutex_;
+    
+    std::atomic<std::size_t> count_{0};
     std::size_t max_traders_;
+    AccountsMode mode_;
 
 public:
     /**
      * @brief Construct account manager
-     * @param max_traders Maximum number of traders
-     * @param stripe_count Number of stripe mutexes (power of 2 recommended)
-     */
-    explicit Accounts(
-        std::size_t max_traders,
-        std::size_t stripe_count = DEFAULT_STRIPE_COUNT
-    )
-        : stripe_mutexes_(stripe_count)
-        , stripe_count_(stripe_count)
-        , max_traders_(max_traders) {
+     * @param max_traders Maximum number of accounts
+     * @param mode Shared (atomic RMW) or SingleWriter (seqlock-published stores)
+     */
+    explicit Accounts(std::size_t max_traders, AccountsMode mode = AccountsMode::Shared)
+        : directory_(std::make_unique<std::atomic<Page*>[]>(DIRECTORY_SIZE))
+        , max_traders_(max_traders)
+        , mode_(mode) {
         
         accounts_.reserve(max_traders);
     }
     
     ~Accounts() = default;
     
-    // Non-copyable, non-movable (owns mutexes)
+    // Non-copyable, non-movable (owns a mutex; engines hold pointers into it)
     Accounts(const Accounts&) = delete;
     Accounts& operator=(const Accounts&) = delete;
     
@@ -110,18 +183,24 @@ public:
     Account* get_or_create(TraderId trader_id, std::int64_t initial_balance = 0);
     
     /**
-     * @brief Get existing account
+     * @brief Get existing account (lock-free, two dependent loads)
      * @param trader_id Trader ID
      * @return Pointer to account, or nullptr if not found
      */
-    Account* get(TraderId trader_id);
-    const Account* get(TraderId trader_id) const;
+    [[nodiscard]] CES_FORCE_INLINE Account* get(TraderId trader_id) noexcept {
+        return lookup(trader_id);
+    }
+    [[nodiscard]] CES_FORCE_INLINE const Account* get(TraderId trader_id) const noexcept {
+        return lookup(trader_id);
+    }
     
     /**
      * @brief Apply a trade to both maker and taker accounts
      * 
      * Atomically updates balances and positions for both parties.
-     * Maker sells at trade price, taker buys (or vice versa).
+     * Maker sells at trade price, taker buys (or vice versa). The maker's
+     * order was resting, so its open qty/notional on the maker side drops
+     * by the fill.
      * 
      * @param maker_id Maker trader ID
      * @param taker_id Taker trader ID
@@ -137,6 +216,18 @@ public:
         Qty qty
     );
     
+    /**
+     * @brief Record a change in a trader's resting orders
+     * @param trader_id Order owner
+     * @param side Order side
+     * @param qty Resting quantity added (negative when removed)
+     * @param price Order price
+     * 
+     * Called by the engine when an order starts resting, is cancelled or is
+     * modified; fills of resting orders are handled by apply_trade().
+     */
+    void adjust_open(TraderId trader_id, Side side, std::int64_t qty, Price price);
+    
     /**
      * @brief Adjust balance (deposit/withdrawal)
      * @param trader_id Trader ID
@@ -163,10 +254,48 @@ public:
      */
     std::int64_t get_position(TraderId trader_id) const;
     
+    /**
+     * @brief Consistent copy of an account, safe against a concurrent writer
+     * @return Snapshot, or nullopt if the account does not exist
+     * 
+     * In SingleWriter mode retries while an update is in progress, so the
+     * fields always belong to the same update. In Shared mode fields are
+     * loaded one by one and may straddle concurrent trades.
+     */
+    [[nodiscard]] std::optional<AccountSnapshot> snapshot(TraderId trader_id) const noexcept;
+    
+    /**
+     * @brief Hash of every account that has traded or has open orders, by TraderId
+     * 
+     * Accounts created but never used (e.g. for an order that risk
+     * rejected) are skipped, so a replay of accepted events hashes equal to
+     * the live engine. Only call while no trade is being applied.
+     */
+    [[nodiscard]] std::uint64_t state_hash() const noexcept;
+    
+    /**
+     * @brief Consistent copies of every account, by TraderId (for checkpoints)
+     * @param out Overwritten; its capacity is reused
+     */
+    void capture(std::vector<AccountSnapshot>& out) const;
+    
+    /**
+     * @brief Create or overwrite an account from a checkpointed copy
+     * @return false if the account limit is reached
+     * 
+     * Recovery only: must not race any other call on the account.
+     */
+    bool restore(const AccountSnapshot& snap);
+    
+    /**
+     * @brief Write mode chosen at construction
+     */
+    [[nodiscard]] AccountsMode mode() const noexcept { return mode_; }
+    
     /**
      * @brief Get total number of accounts
      */
-    std::size_t size() const noexcept { return accounts_.size(); }
+    std::size_t size() const noexcept { return count_.load(std::memory_order_relaxed); }
     
     /**
      * @brief Reset all accounts
@@ -174,19 +303,43 @@ public:
     void clear();
 
 private:
+    [[nodiscard]] CES_FORCE_INLINE Account* lookup(TraderId trader_id) const noexcept {
+        const auto id = static_cast<std::size_t>(trader_id.get());
+        const Page* page = directory_[id >> PAGE_BITS].load(std::memory_order_acquire);
+        if CES_UNLIKELY(page == nullptr) {
+            return nullptr;
+        }
+        return page->slots[id & (PAGE_SIZE - 1)].load(std::memory_order_acquire);
+    }
+    
     /**
-     * @brief Get stripe index for trader ID
+     * @brief Visit every account in TraderId order
      */
-    [[nodiscard]] std::size_t stripe_index(TraderId trader_id) const noexcept {
-        return static_cast<std::size_t>(trader_id.get()) % stripe_count_;
+    template<typename F>
+    void for_each_account(F&& visit) const {
+        for (std::size_t dir = 0; dir < DIRECTORY_SIZE; ++dir) {
+            const Page* page = directory_[dir].load(std::memory_order_acquire);
+            if (page == nullptr) {
+                continue;
+            }
+            for (const auto& slot : page->slots) {
+                if (const Account* acc = slot.load(std::memory_order_acquire)) {
+                    visit(*acc);
+                }
+            }
+        }
     }
     
     /**
-     * @brief Get mutex for trader
+     * @brief Apply one side of a trade (or a balance adjustment) to an account
      */
-    [[nodiscard]] std::mutex& get_mutex(TraderId trader_id) {
-        return stripe_mutexes_[stripe_index(trader_id)];
-    }
+    void settle(Account& acc, const Delta& delta) noexcept;
+    
+    /**
+     * @brief Create the account (caller holds create_mutex_)
+     * @return New account, or nullptr if it exists or the limit is reached
+     */
+    Account* create_locked(TraderId trader_id, std::int64_t initial_balance);
 };
 
 } // namespace ces
@@ -0,0 +1,186 @@
+#pragma once
+/**
+ * @file checkpoint.hpp
+ * @brief Engine checkpoints stamped with the journal sequence
+ *
+ * Layout (host byte order):
+ *   CheckpointHeader
+ *   AccountSnapshot x account_count   by TraderId
+ *   Book snapshot image (book_bytes)  see book_snapshot.hpp
+ *
+ * A checkpoint holds the state after journal records [1, journal_seq], so
+ * recovery loads it and replays only records journal_seq + 1 onwards. The
+ * writer makes those records durable before the checkpoint replaces the
+ * previous one, so a checkpoint on disk is never ahead of the journal.
+ *
+ * The engine thread copies its state into a reused in-memory image (one
+ * pass over the book, no allocation once the buffers have grown) and goes
+ * back to matching; the Checkpointer's writer thread writes the image to
+ * disk. The live state and the image are the two buffers: only the copy
+ * runs on the matching path, never the file I/O.
+ */
+
+#include <ces/common/types.hpp>
+#include <ces/common/time.hpp>
+#include <ces/lob/book_snapshot.hpp>
+#include <ces/engine/journal.hpp>
+#include <ces/engine/accounts.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ces {
+
+class OrderBook;
+
+/**
+ * @brief Fixed-size checkpoint file header
+ */
+struct CheckpointHeader {
+    static constexpr std::uint64_t MAGIC = 0x0054504B43534543ULL;  // "CESCKPT\0" on little-endian hosts
+    static constexpr std::uint32_t VERSION = 1;
+
+    std::uint64_t magic{MAGIC};
+    std::uint32_t version{VERSION};
+    std::uint32_t header_size{sizeof(CheckpointHeader)};
+    std::uint64_t journal_seq{0};        // Last journal record reflected in the state
+    std::uint64_t events_processed{0};
+    std::uint64_t account_count{0};
+    std::uint64_t book_bytes{0};
+    std::uint64_t created_ns{0};
+    std::uint64_t reserved{0};
+};
+
+static_assert(std::is_trivially_copyable_v<CheckpointHeader>);
+static_assert(std::is_trivially_copyable_v<AccountSnapshot>);
+static_assert(sizeof(CheckpointHeader) == 64);
+
+/**
+ * @brief In-memory checkpoint; buffers are reused between captures
+ */
+struct CheckpointImage {
+    CheckpointHeader header;
+    std::vector<AccountSnapshot> accounts;
+    std::vector<std::byte> book;
+};
+
+/**
+ * @brief Outcome of MatchingEngine::recover()
+ */
+struct RecoveryResult {
+    SnapshotResult result{SnapshotResult::Ok};
+    std::uint64_t checkpoint_seq{0};   // Journal records covered by the checkpoint
+    std::uint64_t replayed{0};         // Journal tail records replayed on top
+};
+
+/**
+ * @brief Write an image to path (temporary file, fsync, rename)
+ */
+[[nodiscard]] SnapshotResult write_checkpoint(const std::string& path, const CheckpointImage& image);
+
+/**
+ * @brief Load a checkpoint file into a book and accounts
+ * @param header Receives the checkpoint header on success
+ *
+ * Meant for a freshly constructed engine: the book is replaced, accounts
+ * in the checkpoint are created or overwritten.
+ */
+[[nodiscard]] SnapshotResult load_checkpoint(const std::string& path, OrderBook& book,
+                                             Accounts& accounts, CheckpointHeader& header);
+
+/**
+ * @brief Checkpoint options
+ */
+struct CheckpointConfig {
+    std::string path{"engine.checkpoint"};
+    std::uint64_t interval{100'000};  // Journal records between checkpoints
+};
+
+/**
+ * @brief Owns the checkpoint image and the thread that writes it
+ *
+ * One image is in flight at a time: if the writer is still busy when the
+ * next checkpoint is due, that checkpoint is skipped (and counted) rather
+ * than stalling the engine. Before writing an image the writer syncs the
+ * journal up to its journal_seq unless the flusher already has; a failed
+ * sync fails the checkpoint and keeps the previous one.
+ *
+ * The journal must be the one the engine appends to and must stay open
+ * while the checkpointer lives.
+ *
+ * Thread Safety: begin()/submit() from the engine thread only; counters
+ * from any thread.
+ */
+class Checkpointer {
+private:
+    Journal& journal_;
+    CheckpointConfig config_;
+    CheckpointImage image_;
+
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    bool pending_{false};              // Guarded by mutex_
+    std::atomic<bool> busy_{false};    // Image handed to the writer
+
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> skipped_{0};
+    std::atomic<std::uint64_t> failed_{0};
+    std::atomic<std::uint64_t> last_seq_{0};
+    std::atomic<std::int64_t> last_capture_ns_{0};
+    std::atomic<std::int64_t> last_write_ns_{0};
+
+    std::jthread writer_;
+
+public:
+    Checkpointer(Journal& journal, CheckpointConfig config);
+    ~Checkpointer();
+
+    // Non-copyable, non-movable (the writer holds this)
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    /**
+     * @brief Image to capture into, or nullptr (counted as skipped) if the
+     *        previous checkpoint is still being written
+     */
+    [[nodiscard]] CheckpointImage* begin() noexcept;
+
+    /**
+     * @brief Hand the captured image to the writer
+     * @param capture_ns Time the engine spent capturing it
+     */
+    void submit(Duration capture_ns);
+
+    /**
+     * @brief Block until the writer has finished the current image
+     */
+    void wait_idle() const noexcept;
+
+    [[nodiscard]] const CheckpointConfig& config() const noexcept { return config_; }
+    [[nodiscard]] std::uint64_t interval() const noexcept { return config_.interval; }
+
+    [[nodiscard]] std::uint64_t written() const noexcept { return written_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t skipped() const noexcept { return skipped_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t failed() const noexcept { return failed_.load(std::memory_order_relaxed); }
+
+    /// Journal seq of the newest checkpoint on disk
+    [[nodiscard]] std::uint64_t last_seq() const noexcept { return last_seq_.load(std::memory_order_acquire); }
+
+    /// Engine-thread pause of the last capture
+    [[nodiscard]] Duration last_capture_ns() const noexcept { return last_capture_ns_.load(std::memory_order_relaxed); }
+
+    /// Writer time of the last checkpoint (off the matching path)
+    [[nodiscard]] Duration last_write_ns() const noexcept { return last_write_ns_.load(std::memory_order_relaxed); }
+
+private:
+    void write_loop(std::stop_token stop_token);
+};
+
+} // namespace ces
@@ -0,0 +1,130 @@
+#pragma once
+/**
+ * @file execution_report.hpp
+ * @brief Engine-to-trader execution reports and their per-trader routing
+ *
+ * Every event a trader submits gets exactly one terminal report (Ack,
+ * Cancelled, Modified or Rejected) on that trader's outbound queue, preceded
+ * by a Fill for each trade it took part in. Makers get Fills for resting
+ * orders as they execute. Reports echo the event's enqueue time so the
+ * trader can measure order-to-ack round trips.
+ */
+
+#include <ces/common/types.hpp>
+#include <ces/common/time.hpp>
+#include <ces/common/macros.hpp>
+#include <ces/engine/risk.hpp>
+#include <ces/concurrency/spsc_queue.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ces {
+
+/**
+ * @brief Kind of execution report
+ */
+enum class ExecType : std::uint8_t {
+    Ack = 0,        // New order processed (result says resting / partially / fully filled)
+    Fill = 1,       // One execution against this order
+    Cancelled = 2,  // Cancel applied
+    Modified = 3,   // Modify applied
+    Rejected = 4    // Risk reject, unknown order, or no liquidity
+};
+
+[[nodiscard]] constexpr const char* to_string(ExecType t) noexcept {
+    switch (t) {
+        case ExecType::Ack:       return "Ack";
+        case ExecType::Fill:      return "Fill";
+        case ExecType::Cancelled: return "Cancelled";
+        case ExecType::Modified:  return "Modified";
+        case ExecType::Rejected:  return "Rejected";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Report sent from the engine to the owning trader
+ */
+struct ExecutionReport {
+    OrderId order_id{constants::INVALID_ORDER_ID};
+    Timestamp enqueue_time{0};   // Echo of the triggering event's enqueue time
+    Price price{0};              // Fill price (Fill only)
+    Qty qty{0};                  // Filled qty (Fill) or total filled by the event (Ack)
+    Qty leaves{0};               // Qty still resting after the event (Ack / Modified)
+    ExecType type{ExecType::Ack};
+    OrderResult result{OrderResult::Accepted};  // Book outcome
+    RiskResult risk{RiskResult::Passed};        // Set on risk rejects
+
+    [[nodiscard]] bool is_terminal() const noexcept { return type != ExecType::Fill; }
+};
+
+static_assert(sizeof(ExecutionReport) == CACHE_LINE_SIZE / 2, "Two reports must share a cache line");
+
+/**
+ * @brief Routes reports to per-trader SPSC queues
+ *
+ * Traders are attached before the engine starts; afterwards the engine
+ * thread is the only writer of every queue. A full queue drops the report
+ * (counted) rather than stalling matching on a slow trader.
+ *
+ * Thread Safety: attach() before run(); send() from the engine thread only.
+ */
+class ReportRouter {
+public:
+    /// Per-trader outbound queue capacity
+    static constexpr std::size_t QUEUE_CAPACITY = 4096;
+
+    using Queue = SpscQueue<ExecutionReport, QUEUE_CAPACITY>;
+
+private:
+    std::vector<Queue*> routes_;  // Indexed by TraderId
+    std::atomic<std::uint64_t> sent_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+
+public:
+    ReportRouter() = default;
+
+    // Non-copyable (engine holds a pointer)
+    ReportRouter(const ReportRouter&) = delete;
+    ReportRouter& operator=(const ReportRouter&) = delete;
+
+    /**
+     * @brief Register the outbound queue for a trader
+     */
+    void attach(TraderId trader_id, Queue& queue) {
+        const auto index = static_cast<std::size_t>(trader_id.get());
+        if (index >= routes_.size()) {
+            routes_.resize(index + 1, nullptr);
+        }
+        routes_[index] = &queue;
+    }
+
+    /**
+     * @brief Deliver a report to a trader (no-op if the trader has no queue)
+     * @return true if enqueued
+     */
+    CES_FORCE_INLINE bool send(TraderId trader_id, const ExecutionReport& report) noexcept {
+        const auto index = static_cast<std::size_t>(trader_id.get());
+        if (index >= routes_.size() || routes_[index] == nullptr) {
+            return false;
+        }
+        if CES_UNLIKELY(!routes_[index]->try_push(report)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        sent_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    [[nodiscard]] std::uint64_t sent() const noexcept {
+        return sent_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+};
+
+} // namespace ces
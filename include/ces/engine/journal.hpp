@@ -0,0 +1,335 @@
+#pragma once
+/**
+ * @file journal.hpp
+ * @brief Write-ahead journal of accepted order events
+ *
+ * Layout (host byte order, preallocated to capacity):
+ *   JournalHeader                 (64 bytes)
+ *   JournalRecord x capacity      (64 bytes each; unused records are zero)
+ *
+ * Records are numbered from 1 and written in order, so the valid prefix of
+ * the file is the run of records whose seq matches their position and
+ * whose checksum matches their contents. Records and the header are both
+ * 64 bytes, so no record straddles a page; the checksum catches a record
+ * torn below page granularity.
+ *
+ * The engine thread copies each record into a shared file mapping; a
+ * flusher thread makes the written prefix durable with msync(MS_SYNC)
+ * according to the durability mode.
+ */
+
+#include <ces/common/types.hpp>
+#include <ces/common/time.hpp>
+#include <ces/common/macros.hpp>
+#include <ces/common/state_hash.hpp>
+#include <ces/lob/order.hpp>
+#include <ces/memory/mapped_file.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace ces {
+
+/**
+ * @brief Result of creating or opening a journal
+ */
+enum class JournalResult : std::uint8_t {
+    Ok = 0,
+    IoError = 1,          // File could not be created, sized, mapped or synced
+    BadFormat = 2,        // Magic or sizes invalid
+    VersionMismatch = 3   // Written by an incompatible format version
+};
+
+[[nodiscard]] constexpr const char* to_string(JournalResult r) noexcept {
+    switch (r) {
+        case JournalResult::Ok:              return "Ok";
+        case JournalResult::IoError:         return "IoError";
+        case JournalResult::BadFormat:       return "BadFormat";
+        case JournalResult::VersionMismatch: return "VersionMismatch";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief When appended records become durable
+ */
+enum class JournalDurability : std::uint8_t {
+    PerEvent = 0,     // append() returns once its record is synced
+    GroupCommit = 1,  // Flusher syncs everything written every flush_interval
+    Async = 2         // Flusher only starts writeback; synced on sync()/close()
+};
+
+[[nodiscard]] constexpr const char* to_string(JournalDurability d) noexcept {
+    switch (d) {
+        case JournalDurability::PerEvent:    return "PerEvent";
+        case JournalDurability::GroupCommit: return "GroupCommit";
+        case JournalDurability::Async:       return "Async";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Fixed-size journal file header
+ */
+struct JournalHeader {
+    static constexpr std::uint64_t MAGIC = 0x004C4E524A534543ULL;  // "CESJRNL\0" on little-endian hosts
+    static constexpr std::uint32_t VERSION = 2;
+
+    static constexpr std::uint32_t FLAG_CLEAN_CLOSE = 1U << 0;  // close() synced record_count
+    static constexpr std::uint32_t FLAG_STATE_HASH = 1U << 1;   // state_hash is set
+
+    std::uint64_t magic{MAGIC};
+    std::uint32_t version{VERSION};
+    std::uint32_t header_size{sizeof(JournalHeader)};
+    std::uint32_t record_size{0};
+    std::uint32_t flags{0};
+    std::uint64_t capacity{0};        // Records preallocated
+    std::uint64_t record_count{0};    // Valid records (trusted only after a clean close)
+    std::uint64_t created_ns{0};
+    std::uint64_t state_hash{0};      // Engine state after the last record (see MatchingEngine::state_hash)
+    std::uint64_t reserved{0};
+};
+
+/**
+ * @brief One accepted event
+ */
+struct JournalRecord {
+    std::uint64_t seq{0};      // 1-based; 0 marks an unused record
+    Timestamp timestamp{0};    // When the engine accepted the event
+    OrderEvent event;
+    std::uint64_t checksum{0}; // compute_checksum() of the fields above
+    std::uint64_t reserved{0};
+
+    /**
+     * @brief Hash of the bytes before checksum, as stored
+     */
+    [[nodiscard]] std::uint64_t compute_checksum() const noexcept;
+};
+
+static_assert(std::is_trivially_copyable_v<JournalHeader>);
+static_assert(std::is_trivially_copyable_v<JournalRecord>);
+static_assert(sizeof(JournalHeader) == 64);
+static_assert(sizeof(JournalRecord) == 64);
+
+inline std::uint64_t JournalRecord::compute_checksum() const noexcept {
+    constexpr std::size_t WORDS = offsetof(JournalRecord, checksum) / sizeof(std::uint64_t);
+    std::uint64_t words[WORDS];
+    std::memcpy(words, this, sizeof(words));
+    StateHash hash;
+    for (const std::uint64_t word : words) {
+        hash.add(word);
+    }
+    return hash.value();
+}
+
+/**
+ * @brief Journal creation options
+ */
+struct JournalConfig {
+    std::uint64_t capacity{1 << 20};          // Records to preallocate
+    JournalDurability durability{JournalDurability::GroupCommit};
+    std::chrono::microseconds flush_interval{200};  // GroupCommit / Async period
+};
+
+/**
+ * @brief Append-only writer over a preallocated, memory-mapped file
+ *
+ * append() is a copy into the mapping plus one release store; it makes no
+ * system call unless the mode is PerEvent, where it waits for the flusher.
+ * The flusher thread syncs the pages between the durable and the written
+ * sequence, so one msync covers every record appended since the last one.
+ *
+ * A full journal refuses further records (append() returns false and the
+ * refusal is counted); size capacity for the session. A failed sync latches
+ * io_error(), after which the engine stops appending.
+ *
+ * Thread Safety: append() from ONE thread (the engine); sequences and
+ * counters may be read from any thread. close() must not race append().
+ */
+class Journal {
+private:
+    std::byte* base_{nullptr};
+    std::size_t mapped_size_{0};
+    int fd_{-1};
+    JournalConfig config_;
+    JournalRecord* records_{nullptr};
+    std::uint64_t capacity_{0};  // 0 while closed, so append() refuses
+
+    // Written by the appender only
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> overflowed_{0};
+    std::atomic<std::uint32_t> wake_{0};  // PerEvent: bumped to wake the flusher
+
+    // Written by the flusher (and sync()); durable_ only advances on a successful sync
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> durable_{0};
+    std::atomic<std::uint32_t> passes_{0};  // PerEvent: bumped after every sync attempt
+    std::atomic<std::uint64_t> syncs_{0};
+    std::atomic<bool> io_error_{false};
+
+    std::jthread flusher_;
+
+public:
+    Journal() = default;
+    ~Journal();
+
+    // Non-copyable, non-movable (the flusher holds this)
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    /**
+     * @brief Create (truncating) and preallocate a journal, then start the flusher
+     * @return Ok, or IoError if the file cannot be created, sized or mapped
+     */
+    [[nodiscard]] JournalResult create(const std::string& path, const JournalConfig& config = {});
+
+    /**
+     * @brief Append an accepted event
+     * @param event Event as accepted by the engine
+     * @param timestamp Acceptance time
+     * @return false if the journal is full (or not open), or in PerEvent
+     *         mode if the record could not be synced; the caller must not
+     *         apply an event whose append failed
+     */
+    CES_FORCE_INLINE bool append(const OrderEvent& event, Timestamp timestamp) noexcept {
+        const std::uint64_t index = written_.load(std::memory_order_relaxed);
+        if CES_UNLIKELY(index >= capacity_) {
+            overflowed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        JournalRecord record{.seq = index + 1, .timestamp = timestamp, .event = event};
+        record.checksum = record.compute_checksum();
+        std::memcpy(&records_[index], &record, sizeof(JournalRecord));
+
+        written_.store(index + 1, std::memory_order_release);
+        if (config_.durability == JournalDurability::PerEvent && !wait_durable(index + 1)) {
+            // Not durable and about to be refused: keep it out of the valid
+            // prefix should a later sync write it out
+            records_[index].seq = 0;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Make every written record durable now (any mode, any thread
+     *        while open)
+     * @return false on an I/O error
+     */
+    bool sync() noexcept;
+
+    /**
+     * @brief Stop the flusher, sync, record the count and unmap
+     * @param state_hash Engine state after the last record, for replay
+     *        verification (pass it once the engine has stopped)
+     */
+    JournalResult close(std::optional<std::uint64_t> state_hash = std::nullopt) noexcept;
+
+    [[nodiscard]] bool is_open() const noexcept { return base_ != nullptr; }
+    [[nodiscard]] const JournalConfig& config() const noexcept { return config_; }
+
+    /// Records appended so far (the last assigned seq)
+    [[nodiscard]] std::uint64_t written() const noexcept {
+        return written_.load(std::memory_order_acquire);
+    }
+
+    /// Records known to be on stable storage
+    [[nodiscard]] std::uint64_t durable() const noexcept {
+        return durable_.load(std::memory_order_acquire);
+    }
+
+    /// Appends refused because the journal was full
+    [[nodiscard]] std::uint64_t overflowed() const noexcept {
+        return overflowed_.load(std::memory_order_relaxed);
+    }
+
+    /// msync calls issued (each may cover many records)
+    [[nodiscard]] std::uint64_t syncs() const noexcept {
+        return syncs_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool io_error() const noexcept {
+        return io_error_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Mapped records; [0, written()) are complete once written() is read
+     *
+     * For readers in this process (replication). Valid until close().
+     */
+    [[nodiscard]] const JournalRecord* records() const noexcept { return records_; }
+
+private:
+    void flush_loop(std::stop_token stop_token);
+
+    /**
+     * @brief msync the pages holding records [from, to)
+     * @param blocking MS_SYNC (durable) rather than MS_ASYNC (writeback started)
+     */
+    bool sync_range(std::uint64_t from, std::uint64_t to, bool blocking) noexcept;
+
+    /**
+     * @brief Wake the PerEvent flusher and wait until seq is durable
+     * @return false if a sync failed first
+     */
+    bool wait_durable(std::uint64_t seq) noexcept;
+
+    /// Raise durable_ to seq unless a concurrent sync already went further
+    void advance_durable(std::uint64_t seq) noexcept;
+
+    /// Wake wait_durable() callers after a sync attempt
+    void end_pass() noexcept;
+
+    void release() noexcept;
+};
+
+/**
+ * @brief Read-only view of a journal file
+ *
+ * Records are copied out of the mapping (it has no alignment guarantee on
+ * platforms without mmap). count() is the valid prefix: the header's count
+ * after a clean close, otherwise the run of records with matching seq.
+ */
+class JournalReader {
+private:
+    MappedFile file_;
+    JournalHeader header_;
+    std::uint64_t count_{0};
+
+public:
+    /**
+     * @brief Map a journal and find its valid prefix
+     */
+    [[nodiscard]] static std::optional<JournalReader> open(const std::string& path,
+                                                           JournalResult& result);
+
+    [[nodiscard]] const JournalHeader& header() const noexcept { return header_; }
+    [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] bool clean_close() const noexcept {
+        return (header_.flags & JournalHeader::FLAG_CLEAN_CLOSE) != 0;
+    }
+
+    /**
+     * @brief Engine state hash recorded at close, if any
+     */
+    [[nodiscard]] std::optional<std::uint64_t> state_hash() const noexcept {
+        if ((header_.flags & JournalHeader::FLAG_STATE_HASH) == 0) {
+            return std::nullopt;
+        }
+        return header_.state_hash;
+    }
+
+    /**
+     * @brief Copy of record i (0-based; seq i + 1)
+     */
+    [[nodiscard]] JournalRecord record(std::uint64_t i) const noexcept;
+};
+
+} // namespace ces
@@ -4,27 +4,42 @@
  * @brief Matching engine consumer that processes order events
  * 
  * Owns OrderBook, Accounts, and Stats.
- * Consumes events from SPSC queue and applies them to the book.
+ * Consumes events from an SPSC queue and applies them to the book.
  */
 
 #include <ces/common/types.hpp>
 #include <ces/common/time.hpp>
 #include <ces/common/macros.hpp>
+#include <ces/common/instrument.hpp>
+#include <ces/common/concepts.hpp>
+#include <ces/common/state_hash.hpp>
+#include <ces/common/tsc_clock.hpp>
 #include <ces/lob/order_book.hpp>
 #include <ces/lob/order.hpp>
 #include <ces/engine/accounts.hpp>
 #include <ces/engine/risk.hpp>
+#include <ces/engine/trading_controls.hpp>
+#include <ces/engine/execution_report.hpp>
+#include <ces/engine/journal.hpp>
+#include <ces/engine/checkpoint.hpp>
+#include <ces/engine/replication.hpp>
 #include <ces/concurrency/spsc_semaphore_queue.hpp>
+#include <ces/concurrency/spsc_queue.hpp>
+#include <ces/concurrency/mpsc_queue.hpp>
 #include <ces/concurrency/pinning.hpp>
+#include <ces/concurrency/wait_strategy.hpp>
 #include <ces/metrics/stats.hpp>
 #include <ces/logging/async_logger.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <thread>
 #include <stop_token>
 #include <optional>
 #include <chrono>
 #include <functional>
+#include <span>
+#include <vector>
 
 namespace ces {
 
@@ -32,13 +47,20 @@ namespace ces {
  * @brief Configuration for the matching engine
  */
 struct EngineConfig {
+    // Instrument (tick/lot sizes for converting at the API boundary)
+    Instrument instrument;
+    
     // Order book configuration
-    std::uint32_t max_orders{static_cast<std::uint32_t>(constants::DEFAULT_MAX_ORDERS)};
+    std::uint32_t max_orders{static_cast<std::uint32_t>(constants::DEFAULT_MAX_ORDERS)};  // Initial pool capacity
     std::size_t max_price_levels{constants::DEFAULT_MAX_PRICE_LEVELS};
+    AllocationPolicy memory_policy;  // Order pool backing (heap or huge pages)
+    PoolGrowth pool_growth;          // Order pool segment size / growth limit
+    bool prefault_book{false};       // Fault in book storage at startup (else lazily)
     
     // Account configuration
     std::size_t max_traders{1000};
     std::int64_t initial_balance{1'000'000'000};  // 1 billion
+    AccountsMode accounts_mode{AccountsMode::SingleWriter};  // Only the engine thread settles trades
     
     // Risk configuration
     RiskConfig risk;
@@ -46,6 +68,22 @@ struct EngineConfig {
     // Thread affinity
     std::optional<std::uint32_t> pin_to_core;
     
+    // How run() waits on an empty queue
+    WaitConfig wait;
+    
+    // Maximum events taken from the queue per poll (1 = one at a time)
+    std::size_t max_batch{64};
+    
+    // Clock for per-event timestamps (Tsc falls back to System without an invariant TSC)
+    TimeSource time_source{TimeSource::System};
+    
+    // Tsc: how often run() re-pairs ticks with now_ns(), bounding the drift
+    // of queue-wait and end-to-end latency
+    std::chrono::milliseconds tsc_reanchor_interval{1000};
+    
+    // Orders a Queue-mode halt can park (reserved up front; more are rejected as Halted)
+    std::size_t halt_queue_capacity{4096};
+    
     // Logging
     bool enable_logging{false};
     std::string log_file{"engine.log"};
@@ -62,23 +100,49 @@ struct EngineConfig {
  * - Stats updated via std::atomic_ref for thread-safe reads
  * 
  * @tparam QueueCapacity Capacity of input queue (must be power of 2)
+ * @tparam QueueT Input queue type: SpscSemaphoreQueue (default), the
+ *         lock-free SpscQueue, or MpscQueue for several producers
  */
-template<std::size_t QueueCapacity>
+template<std::size_t QueueCapacity,
+         typename QueueT = SpscSemaphoreQueue<OrderEvent, QueueCapacity>>
+    requires EventQueue<QueueT, OrderEvent>
 class MatchingEngine {
 public:
-    using Queue = SpscSemaphoreQueue<OrderEvent, QueueCapacity>;
+    using Queue = QueueT;
 
 private:
     Queue& queue_;
     OrderBook book_;
     Accounts accounts_;
+    SymbolControlsHandle controls_;  // Before risk_, which holds a reader of it
     RiskChecker risk_;
     EngineStats stats_;
     AsyncLogger* logger_;
+    ReportRouter* reports_{nullptr};
+    Journal* journal_{nullptr};
+    Checkpointer* checkpointer_{nullptr};
+    ReplicationPrimary* replication_{nullptr};
+    std::uint64_t next_checkpoint_seq_{0};
     EngineConfig config_;
     
     std::atomic<bool> running_{false};
     std::atomic<std::uint64_t> events_processed_{0};
+    
+    // Enqueue time of the event being matched (echoed in taker fills)
+    Timestamp current_enqueue_time_{0};
+    
+    // Set when timing with TSC ticks (config.time_source == Tsc and usable)
+    std::optional<TscClock> tsc_;
+    std::uint64_t tsc_reanchor_ticks_{0};
+    
+    // Copy-out buffer for queues without an in-place read view
+    std::vector<OrderEvent> batch_;
+    
+    // Events parked by a Queue-mode halt; release_halted() swaps them into
+    // releasing_ while it processes them, so neither buffer allocates after
+    // construction
+    std::vector<OrderEvent> halted_events_;
+    std::vector<OrderEvent> releasing_;
 
 public:
     /**
@@ -89,12 +153,34 @@ public:
      */
     MatchingEngine(Queue& queue, EngineConfig config = {}, AsyncLogger* logger = nullptr)
         : queue_(queue)
-        , book_(config.max_orders, config.max_price_levels)
-        , accounts_(config.max_traders)
+        , book_(config.max_orders, config.max_price_levels, 0.5f,
+                config.memory_policy, config.pool_growth)
+        , accounts_(config.max_traders, config.accounts_mode)
         , risk_(config.risk, &accounts_)
         , logger_(logger)
         , config_(std::move(config)) {
         
+        config_.max_batch = std::max<std::size_t>(config_.max_batch, 1);
+        batch_.resize(config_.max_batch);
+        halted_events_.reserve(config_.halt_queue_capacity);
+        releasing_.reserve(config_.halt_queue_capacity);
+        
+        if (config_.prefault_book) {
+            book_.prefault();
+        }
+        
+        risk_.set_controls(&controls_, nullptr);
+        
+        if (config_.time_source == TimeSource::Tsc) {
+            tsc_ = TscClock::calibrate();
+            if (tsc_) {
+                stats_.set_time_scale(tsc_->ns_per_tick());
+                tsc_reanchor_ticks_ = static_cast<std::uint64_t>(
+                    static_cast<double>(std::chrono::nanoseconds(config_.tsc_reanchor_interval).count()) *
+                    tsc_->ticks_per_ns());
+            }
+        }
+        
         // Set up trade callback to update accounts
         book_.set_trade_callback([this](const Trade& trade) {
             on_trade(trade);
@@ -111,7 +197,7 @@ public:
      * @brief Run the matching engine loop
      * 
      * Designed to be called as std::jthread body.
-     * Blocks on queue.pop() until stop is requested.
+     * Waits on the queue per config.wait until stop is requested.
      */
     void run(std::stop_token stop_token) {
         running_.store(true, std::memory_order_release);
@@ -121,76 +207,151 @@ public:
             [[maybe_unused]] auto pin_result = pin_thread_to_core(*config_.pin_to_core);
         }
         
-        OrderEvent event;
+        IdleWaiter waiter(config_.wait);
+        const bool blocking = waiter.strategy() == WaitStrategy::Blocking;
         
         while (!stop_token.stop_requested()) {
-            // Try to pop with timeout to check stop_token periodically
-            bool popped = queue_.try_pop_for(event, std::chrono::milliseconds(10));
-            if (!popped) {
+            if (process_available() > 0) {
+                waiter.reset();
+                reanchor_clock();
                 continue;
             }
             
-            process_event(event);
+            // Blocking pops time out so stop_token is checked periodically
+            if (blocking) {
+                OrderEvent event;
+                if (queue_.try_pop_for(event, config_.wait.block_timeout)) {
+                    process_event(event);
+                    continue;
+                }
+            }
+            
+            // Idle: grow the order pool now rather than on the matching path,
+            // let operators free superseded controls, and pick up parked
+            // orders if a halt was lifted
+            if (blocking || waiter.idle()) {
+                book_.maintain();
+                risk_.quiescent();
+                release_halted();
+                reanchor_clock();
+            }
         }
         
         // Drain remaining events
-        while (queue_.try_pop(event)) {
-            process_event(event);
+        while (process_available() > 0) {
         }
         
         running_.store(false, std::memory_order_release);
     }
     
+    /**
+     * @brief Process up to max_batch queued events without waiting
+     *
+     * Uses the queue's zero-copy read_available()/consume() view when it
+     * has one (events are processed in the ring and their slots released
+     * with one store), otherwise a single try_pop_n() into a local buffer.
+     *
+     * @return Number of events processed
+     */
+    std::size_t process_available() {
+        if constexpr (requires { queue_.read_available(std::size_t{}); queue_.consume(std::size_t{}); }) {
+            const auto view = queue_.read_available(config_.max_batch);
+            for (const OrderEvent& event : view) {
+                process_event(event);
+            }
+            if (!view.empty()) {
+                queue_.consume(view.size());
+            }
+            return view.size();
+        } else if constexpr (requires { queue_.try_pop_n(std::span<OrderEvent>{}, std::size_t{}); }) {
+            const std::size_t count = queue_.try_pop_n(std::span<OrderEvent>(batch_), config_.max_batch);
+            for (std::size_t i = 0; i < count; ++i) {
+                process_event(batch_[i]);
+            }
+            return count;
+        } else {
+            OrderEvent event;
+            if (!queue_.try_pop(event)) {
+                return 0;
+            }
+            process_event(event);
+            return 1;
+        }
+    }
+    
     /**
      * @brief Process single event (exposed for testing)
      */
     void process_event(const OrderEvent& event) {
-        Timestamp start = now_ns();
+        // Orders parked by a halt go first once trading resumes
+        if CES_UNLIKELY(!halted_events_.empty()) {
+            release_halted();
+        }
+        
+        const Timestamp start = clock_now();
         
         // Ensure trader account exists
         if (event.type != OrderType::Cancel) {
             accounts_.get_or_create(event.trader_id, config_.initial_balance);
         }
         
+        // The order a cancel or modify refers to: risk limits a modify by
+        // its change, and apply() moves its open exposure. During a halt the
+        // order may still be parked rather than resting.
+        std::optional<Order> resting;
+        OrderEvent* parked = nullptr;
+        if (event.type == OrderType::Cancel || event.type == OrderType::Modify) {
+            resting = book_.find_order(event.order_id);
+            if CES_UNLIKELY(!resting && !halted_events_.empty()) {
+                parked = find_parked(event.order_id);
+                if (parked) {
+                    resting.emplace(parked->order_id, parked->trader_id, parked->side, parked->price, parked->qty);
+                }
+            }
+        }
+        
         // Risk check
-        RiskResult risk_result = risk_.check(event);
+        RiskResult risk_result = risk_.check(event, resting ? &*resting : nullptr);
+        const Timestamp risk_done = clock_now();
+        if CES_UNLIKELY(parked != nullptr &&
+                        (risk_result == RiskResult::Passed || risk_result == RiskResult::Halted)) {
+            amend_parked(event, *parked);
+            record_latency(event, start, risk_done);
+            return;
+        }
         if CES_UNLIKELY(risk_result != RiskResult::Passed) {
-            stats_.rejected_count.fetch_add(1, std::memory_order_relaxed);
-            if (logger_) {
-                logger_->log("Rejected order {} reason: {}", 
-                            event.order_id.get(), to_string(risk_result));
+            if (risk_result == RiskResult::Halted && risk_.halt_state() == HaltAction::Queue &&
+                halted_events_.size() < config_.halt_queue_capacity) {
+                halted_events_.push_back(event);
+                return;
             }
-            record_latency(event.enqueue_time, start);
+            reject(event, risk_result);
+            record_latency(event, start, risk_done);
             return;
         }
         
-        // Process based on type
-        OrderResponse response;
-        
-        switch (event.type) {
-            case OrderType::NewLimit:
-                response = book_.add_limit(
-                    event.order_id, event.trader_id,
-                    event.side, event.price, event.qty
-                );
-                break;
-                
-            case OrderType::NewMarket:
-                response = book_.add_market(
-                    event.order_id, event.trader_id,
-                    event.side, event.qty
-                );
-                break;
-                
-            case OrderType::Cancel:
-                response = book_.cancel(event.order_id);
-                break;
-                
-            case OrderType::Modify:
-                response = book_.modify(event.order_id, event.qty, event.price);
-                break;
+        // Accepted: log before the book changes so a crash never loses an
+        // applied event. An event that cannot be logged (journal full or
+        // failed) is not applied.
+        const Timestamp accepted_ns = tsc_ ? tsc_->to_timestamp(start) : start;
+        Timestamp journal_done = 0;
+        if (journal_) {
+            if CES_UNLIKELY(journal_->io_error() || !journal_->append(event, accepted_ns)) {
+                reject(event, RiskResult::JournalUnavailable);
+                record_latency(event, start, risk_done, clock_now());
+                return;
+            }
+            if (replication_) {
+                replication_->throttle(journal_->written());
+            }
+            journal_done = clock_now();
         }
         
+        book_.set_trade_time(accepted_ns);
+        const OrderResponse response = apply(event, resting);
+        book_.set_trade_time(0);
+        const Timestamp match_done = clock_now();
+        
         // Update stats
         events_processed_.fetch_add(1, std::memory_order_relaxed);
         
@@ -200,7 +361,47 @@ public:
             }
         }
         
-        record_latency(event.enqueue_time, start);
+        if (reports_) {
+            send_terminal_report(event, response);
+        }
+        
+        if CES_UNLIKELY(checkpointer_ && journal_->written() >= next_checkpoint_seq_) {
+            checkpoint();
+        }
+        
+        record_latency(event, start, risk_done, journal_done, match_done);
+    }
+    
+    /**
+     * @brief Apply a journal record: no risk check, clock read or journaling
+     *
+     * Journaled events already passed risk, so replaying them in order
+     * through the same book and account updates reproduces the live state.
+     * Trades are stamped with the record's acceptance time, as they were
+     * live. Attach no journal, report router or logger to a replaying engine.
+     */
+    void replay(const JournalRecord& record) {
+        const OrderEvent& event = record.event;
+        if (event.type != OrderType::Cancel) {
+            accounts_.get_or_create(event.trader_id, config_.initial_balance);
+        }
+        std::optional<Order> resting;
+        if (event.type == OrderType::Cancel || event.type == OrderType::Modify) {
+            resting = book_.find_order(event.order_id);
+        }
+        book_.set_trade_time(record.timestamp);
+        (void)apply(event, resting);
+        book_.set_trade_time(0);
+        events_processed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Hash of book and account state (engine stopped or engine thread only)
+     *
+     * Recorded in the journal at close and compared by replay.
+     */
+    [[nodiscard]] std::uint64_t state_hash() const {
+        return StateHash{}.add(book_.state_hash()).add(accounts_.state_hash()).value();
     }
     
     // ========================================================================
@@ -213,6 +414,11 @@ public:
     [[nodiscard]] OrderBook& book() noexcept { return book_; }
     [[nodiscard]] const OrderBook& book() const noexcept { return book_; }
     
+    /**
+     * @brief Get instrument used to convert raw prices/quantities
+     */
+    [[nodiscard]] const Instrument& instrument() const noexcept { return config_.instrument; }
+    
     /**
      * @brief Get reference to accounts
      */
@@ -225,6 +431,18 @@ public:
     [[nodiscard]] EngineStats& stats() noexcept { return stats_; }
     [[nodiscard]] const EngineStats& stats() const noexcept { return stats_; }
     
+    /**
+     * @brief Clock actually used for per-event timestamps
+     */
+    [[nodiscard]] TimeSource time_source() const noexcept {
+        return tsc_ ? TimeSource::Tsc : TimeSource::System;
+    }
+    
+    /**
+     * @brief Calibrated TSC clock, when time_source() is Tsc
+     */
+    [[nodiscard]] const std::optional<TscClock>& tsc_clock() const noexcept { return tsc_; }
+    
     /**
      * @brief Get events processed count
      */
@@ -232,6 +450,141 @@ public:
         return events_processed_.load(std::memory_order_relaxed);
     }
     
+    /**
+     * @brief Route execution reports to traders' outbound queues
+     *
+     * Set before run(); the router must outlive the engine's run loop.
+     * Cancels and modifies are reported only if the event carries its
+     * trader_id (see OrderEvent::cancel / OrderEvent::modify).
+     */
+    void set_report_router(ReportRouter* router) noexcept { reports_ = router; }
+    
+    /**
+     * @brief Write every accepted event to a write-ahead journal
+     *
+     * Set before run(); the engine thread becomes the journal's appender.
+     * Risk rejects and orders parked by a halt are not journaled (parked
+     * orders are, once released and accepted).
+     */
+    void set_journal(Journal* journal) noexcept { journal_ = journal; }
+    
+    /**
+     * @brief Take a checkpoint every checkpointer->interval() journal records
+     *
+     * Set after set_journal() and before run(). The engine thread captures
+     * the book and accounts into the checkpointer's image between events;
+     * the file is written on the checkpointer's thread.
+     */
+    void set_checkpointer(Checkpointer* checkpointer) noexcept {
+        checkpointer_ = journal_ ? checkpointer : nullptr;
+        if (checkpointer_) {
+            next_checkpoint_seq_ = journal_->written() + checkpointer_->interval();
+        }
+    }
+    
+    /**
+     * @brief Stream the journal to a hot standby, bounding how far it trails
+     *
+     * Set after set_journal() and before run(). The engine thread only
+     * checks the standby's lag after each append and waits when it exceeds
+     * the primary's max_lag.
+     */
+    void set_replication(ReplicationPrimary* replication) noexcept {
+        replication_ = journal_ ? replication : nullptr;
+    }
+    
+    /**
+     * @brief Copy the book, accounts and sequence state into an image
+     *
+     * Engine thread only (or engine stopped).
+     */
+    void capture_checkpoint(CheckpointImage& image) const {
+        image.header = CheckpointHeader{};
+        image.header.journal_seq = journal_ ? journal_->written() : events_processed();
+        image.header.events_processed = events_processed();
+        image.header.created_ns = now_ns();
+        book_.capture_snapshot(image.book);
+        accounts_.capture(image.accounts);
+        image.header.account_count = image.accounts.size();
+        image.header.book_bytes = image.book.size();
+    }
+    
+    /**
+     * @brief Restore state from a checkpoint plus the journal records after it
+     * @param checkpoint_path Checkpoint file, or empty to replay the whole journal
+     * @param journal Journal the checkpoint was stamped against
+     *
+     * Call on a freshly constructed engine before run().
+     */
+    RecoveryResult recover(const std::string& checkpoint_path, const JournalReader& journal) {
+        RecoveryResult recovery;
+        if (!checkpoint_path.empty()) {
+            CheckpointHeader header;
+            recovery.result = load_checkpoint(checkpoint_path, book_, accounts_, header);
+            if (recovery.result != SnapshotResult::Ok) {
+                return recovery;
+            }
+            if (header.journal_seq > journal.count()) {
+                recovery.result = SnapshotResult::BadFormat;  // Checkpoint is ahead of the journal
+                return recovery;
+            }
+            recovery.checkpoint_seq = header.journal_seq;
+            events_processed_.store(header.events_processed, std::memory_order_relaxed);
+        }
+        for (std::uint64_t i = recovery.checkpoint_seq; i < journal.count(); ++i) {
+            replay(journal.record(i));
+        }
+        recovery.replayed = journal.count() - recovery.checkpoint_seq;
+        return recovery;
+    }
+    
+    /**
+     * @brief Operator controls for this symbol (price band, halt)
+     *
+     * Publish a new snapshot from any thread; the engine applies it from
+     * the next event it checks.
+     */
+    [[nodiscard]] SymbolControlsHandle& controls() noexcept { return controls_; }
+    
+    /**
+     * @brief Attach market-wide controls shared with other engines (before run())
+     */
+    void set_market_controls(const MarketControlsHandle* market) noexcept {
+        risk_.set_controls(&controls_, market);
+    }
+    
+    /**
+     * @brief Orders parked by a Queue-mode halt (engine thread only)
+     */
+    [[nodiscard]] std::size_t halted_events() const noexcept { return halted_events_.size(); }
+    
+    /**
+     * @brief Process orders parked by a halt if trading has resumed
+     * @return true if parked orders were released
+     *
+     * Called by run() when idle and before the next event; call it directly
+     * when driving process_event() by hand.
+     */
+    bool release_halted() {
+        // Not re-entered from the process_event() calls below
+        if (halted_events_.empty() || !releasing_.empty() || risk_.halt_state()) {
+            return false;
+        }
+        releasing_.swap(halted_events_);
+        for (const OrderEvent& event : releasing_) {
+            process_event(event);  // Re-parks in order if halted again meanwhile
+        }
+        releasing_.clear();
+        return true;
+    }
+    
+    /**
+     * @brief Pre-allocate order pool capacity if running low
+     *
+     * Safe to call from any thread (e.g. a housekeeping loop).
+     */
+    bool maintain() { return book_.maintain(); }
+    
     /**
      * @brief Check if engine is running
      */
@@ -262,18 +615,244 @@ private:
                         trade.qty.get(), trade.price.get(),
                         trade.maker_trader_id.get(), trade.taker_trader_id.get());
         }
+        
+        if (reports_) {
+            reports_->send(trade.maker_trader_id, ExecutionReport{
+                .order_id = trade.maker_order_id,
+                .enqueue_time = current_enqueue_time_,
+                .price = trade.price,
+                .qty = trade.qty,
+                .type = ExecType::Fill
+            });
+            reports_->send(trade.taker_trader_id, ExecutionReport{
+                .order_id = trade.taker_order_id,
+                .enqueue_time = current_enqueue_time_,
+                .price = trade.price,
+                .qty = trade.qty,
+                .type = ExecType::Fill
+            });
+        }
+    }
+    
+    /**
+     * @brief Capture a checkpoint if the writer is free, and schedule the next
+     */
+    void checkpoint() {
+        if (CheckpointImage* image = checkpointer_->begin()) {
+            const Timestamp start = now_ns();
+            capture_checkpoint(*image);
+            checkpointer_->submit(elapsed_ns(start));
+        }
+        next_checkpoint_seq_ = journal_->written() + checkpointer_->interval();
+    }
+    
+    /**
+     * @brief Count, log and report an event that is not applied
+     */
+    void reject(const OrderEvent& event, RiskResult reason) {
+        stats_.rejected_count.fetch_add(1, std::memory_order_relaxed);
+        if (logger_) {
+            logger_->log("Rejected order {} reason: {}", 
+                        event.order_id.get(), to_string(reason));
+        }
+        if (reports_) {
+            reports_->send(event.trader_id, ExecutionReport{
+                .order_id = event.order_id,
+                .enqueue_time = event.enqueue_time,
+                .type = ExecType::Rejected,
+                .result = OrderResult::Rejected,
+                .risk = reason
+            });
+        }
+    }
+    
+    /**
+     * @brief Parked new order with this ID, if any
+     */
+    OrderEvent* find_parked(OrderId order_id) noexcept {
+        for (OrderEvent& parked : halted_events_) {
+            if (parked.order_id == order_id &&
+                (parked.type == OrderType::NewLimit || parked.type == OrderType::NewMarket)) {
+                return &parked;
+            }
+        }
+        return nullptr;
+    }
+    
+    /**
+     * @brief Cancel or modify an order that a halt has parked
+     *
+     * The parked order never reached the journal or the accounts, so only
+     * the parked event changes; a modified order is risk-checked in full
+     * when it is released.
+     */
+    void amend_parked(const OrderEvent& event, OrderEvent& parked) {
+        OrderResponse response;
+        response.order_id = event.order_id;
+        if (event.type == OrderType::Cancel) {
+            response.result = OrderResult::Cancelled;
+            halted_events_.erase(halted_events_.begin() + (&parked - halted_events_.data()));
+        } else {
+            parked.qty = event.qty;
+            if (event.price.get() != 0) {
+                parked.price = event.price;
+            }
+            response.result = OrderResult::Modified;
+            response.qty_remaining = event.qty;
+        }
+        events_processed_.fetch_add(1, std::memory_order_relaxed);
+        if (reports_) {
+            send_terminal_report(event, response);
+        }
+    }
+    
+    /**
+     * @brief Apply an accepted event to the book and accounts
+     * @param resting_before For a cancel or modify, its order as it rests
+     *        before the event (for open-exposure tracking)
+     */
+    OrderResponse apply(const OrderEvent& event, const std::optional<Order>& resting_before) {
+        OrderResponse response;
+        current_enqueue_time_ = event.enqueue_time;
+        
+        switch (event.type) {
+            case OrderType::NewLimit:
+                response = book_.add_limit(
+                    event.order_id, event.trader_id,
+                    event.side, event.price, event.qty
+                );
+                break;
+                
+            case OrderType::NewMarket:
+                response = book_.add_market(
+                    event.order_id, event.trader_id,
+                    event.side, event.qty
+                );
+                break;
+                
+            case OrderType::Cancel:
+                response = book_.cancel(event.order_id);
+                break;
+                
+            case OrderType::Modify:
+                response = book_.modify(event.order_id, event.qty, event.price);
+                break;
+        }
+        
+        update_open_exposure(event, response, resting_before);
+        return response;
     }
     
     /**
-     * @brief Record latency sample
+     * @brief Move the event's order between resting states in its owner's account
+     *
+     * Fills of resting (maker) orders are accounted in apply_trade(); here
+     * only the event's own order changes: a new limit that rests, a cancel,
+     * or a modify (old resting state out, new one in).
      */
-    void record_latency(Timestamp enqueue_time, Timestamp process_start) {
-        Timestamp now = now_ns();
-        Duration total_latency = static_cast<Duration>(now - enqueue_time);
-        Duration process_latency = static_cast<Duration>(now - process_start);
+    void update_open_exposure(const OrderEvent& event, const OrderResponse& response,
+                              const std::optional<Order>& resting_before) {
+        switch (event.type) {
+            case OrderType::NewLimit:
+                if (response.success() && response.qty_remaining.get() > 0) {
+                    accounts_.adjust_open(event.trader_id, event.side,
+                                          response.qty_remaining.get(), event.price);
+                }
+                break;
+            case OrderType::NewMarket:
+                break;
+            case OrderType::Cancel:
+            case OrderType::Modify:
+                if (!resting_before) {
+                    break;
+                }
+                accounts_.adjust_open(resting_before->trader_id, resting_before->side,
+                                      -resting_before->qty_remaining.get(), resting_before->price);
+                if (event.type == OrderType::Modify) {
+                    if (auto resting_after = book_.find_order(event.order_id)) {
+                        accounts_.adjust_open(resting_after->trader_id, resting_after->side,
+                                              resting_after->qty_remaining.get(), resting_after->price);
+                    }
+                }
+                break;
+        }
+    }
+    
+    /**
+     * @brief Report the outcome of an event to its sender
+     */
+    void send_terminal_report(const OrderEvent& event, const OrderResponse& response) {
+        ExecType type = ExecType::Ack;
+        if (!response.success()) {
+            type = ExecType::Rejected;
+        } else if (event.type == OrderType::Cancel) {
+            type = ExecType::Cancelled;
+        } else if (event.type == OrderType::Modify) {
+            type = ExecType::Modified;
+        }
+        
+        reports_->send(event.trader_id, ExecutionReport{
+            .order_id = event.order_id,
+            .enqueue_time = event.enqueue_time,
+            .qty = response.qty_filled,
+            .leaves = response.qty_remaining,
+            .type = type,
+            .result = response.result
+        });
+    }
+    
+    /**
+     * @brief Per-event timestamp in the engine's time source units
+     *
+     * TSC ticks or now_ns(); stats convert to ns when read, everything
+     * leaving the engine (journal, trades) is converted to ns first.
+     */
+    [[nodiscard]] CES_FORCE_INLINE Timestamp clock_now() const noexcept {
+        return tsc_ ? TscClock::ticks() : now_ns();
+    }
+    
+    /**
+     * @brief Re-pair TSC ticks with now_ns() once per tsc_reanchor_interval
+     *
+     * One tick read per call; the re-anchor itself (a few clock reads) runs
+     * between batches, never inside an event.
+     */
+    void reanchor_clock() noexcept {
+        if (tsc_ && TscClock::ticks() - tsc_->anchor_ticks() >= tsc_reanchor_ticks_) {
+            tsc_->reanchor();
+        }
+    }
+    
+    /**
+     * @brief Record end-to-end latency and its split into stages
+     * @param journal_done End of journaling and replication throttling, or 0
+     *        if the event was not journaled
+     * @param match_done End of matching, or 0 if the event was rejected
+     *
+     * Producer stamps mapped through the TSC anchor can land after the
+     * engine's own reads; such durations are recorded as 0 rather than as
+     * negative values (which could also collide with SKIPPED).
+     */
+    void record_latency(const OrderEvent& event, Timestamp process_start, Timestamp risk_done,
+                        Timestamp journal_done = 0, Timestamp match_done = 0) {
+        constexpr Duration SKIPPED = StageHistogram<LATENCY_STAGE_COUNT>::SKIPPED;
+        const Timestamp now = clock_now();
+        const Timestamp match_start = journal_done != 0 ? journal_done : risk_done;
+        const Timestamp post_start = match_done != 0 ? match_done : match_start;
+        const Timestamp enqueued = tsc_ ? tsc_->from_timestamp(event.enqueue_time) : event.enqueue_time;
+        
+        const auto span = [](Timestamp from, Timestamp to) noexcept {
+            return std::max<Duration>(static_cast<Duration>(to - from), 0);
+        };
         
-        stats_.record_latency(total_latency);
-        (void)process_latency;  // Could track separately
+        stats_.record_latency(span(enqueued, now));
+        stats_.record_stages(event.type, StageSample{
+            span(enqueued, process_start),
+            span(process_start, risk_done),
+            journal_done != 0 ? span(risk_done, journal_done) : SKIPPED,
+            match_done != 0 ? span(match_start, match_done) : SKIPPED,
+            span(post_start, now)
+        });
     }
 };
 
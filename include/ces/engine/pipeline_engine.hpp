@@ -0,0 +1,461 @@
+#pragma once
+/**
+ * @file pipeline_engine.hpp
+ * @brief Staged matching pipeline: risk, matching and post-trade on separate threads
+ *
+ * The single-thread MatchingEngine runs risk, matching, account updates,
+ * logging and latency recording back to back. PipelineEngine splits that
+ * work across three stages over one sequenced ring (Disruptor-style):
+ *
+ *   publisher -> [risk] -> [matching] -> [post-trade]
+ *
+ * Each stage reads and annotates the same slot in place and advances its
+ * own Sequence; the next stage waits on a SequenceBarrier over it. Trades
+ * produced by matching flow to post-trade over an SPSC trade queue, which
+ * post-trade drains before retiring the slots that produced them.
+ */
+
+#include <ces/common/types.hpp>
+#include <ces/common/time.hpp>
+#include <ces/common/macros.hpp>
+#include <ces/lob/order_book.hpp>
+#include <ces/lob/order.hpp>
+#include <ces/engine/accounts.hpp>
+#include <ces/engine/risk.hpp>
+#include <ces/engine/matching_engine.hpp>
+#include <ces/concurrency/sequence.hpp>
+#include <ces/concurrency/spsc_queue.hpp>
+#include <ces/concurrency/pinning.hpp>
+#include <ces/concurrency/wait_strategy.hpp>
+#include <ces/memory/page_allocator.hpp>
+#include <ces/metrics/stats.hpp>
+#include <ces/logging/async_logger.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stop_token>
+#include <thread>
+
+namespace ces {
+
+/**
+ * @brief Configuration for the staged pipeline
+ */
+struct PipelineConfig {
+    // Book, accounts, risk and wait settings (pin_to_core is ignored)
+    EngineConfig engine;
+
+    // Per-stage thread affinity
+    std::optional<std::uint32_t> risk_core;
+    std::optional<std::uint32_t> matching_core;
+    std::optional<std::uint32_t> post_trade_core;
+
+    PipelineConfig() {
+        // Stages poll sequences; there is no semaphore to block on
+        engine.wait.strategy = WaitStrategy::SpinYield;
+    }
+};
+
+/**
+ * @brief One ring entry, annotated in place by each stage
+ */
+struct alignas(CACHE_LINE_SIZE) PipelineSlot {
+    /// One resting order entering or leaving its owner's open exposure
+    struct OpenChange {
+        TraderId trader_id{constants::INVALID_TRADER_ID};
+        Price price{0};
+        Qty qty{0};            // 0 = no change
+        Side side{Side::Buy};
+    };
+
+    OrderEvent event;          // Written by the publisher
+    RiskResult risk{RiskResult::Passed};  // Written by risk
+    OrderResponse response;    // Written by matching
+    OpenChange open_removed;   // Written by matching, applied by post-trade
+    OpenChange open_added;
+};
+
+/**
+ * @brief Three-stage matching pipeline over a sequenced ring
+ *
+ * Thread Safety:
+ * - ONE publisher thread calls publish()/try_publish()
+ * - start() launches one thread per stage; stop() drains and joins them
+ * - Stats and counters are readable from any thread
+ *
+ * @tparam Capacity Ring capacity (must be power of 2)
+ */
+template<std::size_t Capacity>
+    requires (Capacity > 0 && (Capacity & (Capacity - 1)) == 0)
+class PipelineEngine {
+public:
+    /// Trades buffered between matching and post-trade
+    static constexpr std::size_t TRADE_QUEUE_CAPACITY = 65536;
+
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    PipelineConfig config_;
+
+    // Ring storage (page aligned, optionally huge-page backed)
+    PageAllocation memory_;
+    PipelineSlot* slots_{nullptr};
+
+    // Stage progress
+    Sequence published_;
+    Sequence risk_done_;
+    Sequence matching_done_;
+    Sequence post_trade_done_;
+    std::uint64_t claim_{0};          // Publisher-local next position
+    std::uint64_t cached_gate_{0};    // Publisher's view of post_trade_done_
+
+    OrderBook book_;
+    Accounts accounts_;
+    SymbolControlsHandle controls_;
+    RiskChecker risk_;
+    EngineStats stats_;
+    AsyncLogger* logger_;
+
+    SpscQueue<Trade, TRADE_QUEUE_CAPACITY> trades_;
+
+    std::atomic<std::uint64_t> events_processed_{0};
+
+    std::jthread risk_thread_;
+    std::jthread matching_thread_;
+    std::jthread post_trade_thread_;
+
+public:
+    /**
+     * @brief Construct pipeline (stages are not started)
+     * @param config Pipeline configuration
+     * @param logger Optional async logger (used by post-trade only)
+     */
+    explicit PipelineEngine(PipelineConfig config = {}, AsyncLogger* logger = nullptr)
+        : config_(std::move(config))
+        , memory_(sizeof(PipelineSlot) * Capacity, config_.engine.memory_policy)
+        , slots_(static_cast<PipelineSlot*>(memory_.data()))
+        , book_(config_.engine.max_orders, config_.engine.max_price_levels, 0.5f,
+                config_.engine.memory_policy, config_.engine.pool_growth)
+        , accounts_(config_.engine.max_traders, config_.engine.accounts_mode)
+        , risk_(config_.engine.risk, &accounts_)
+        , logger_(logger) {
+
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            new (&slots_[i]) PipelineSlot{};
+        }
+        if (config_.engine.wait.strategy == WaitStrategy::Blocking) {
+            config_.engine.wait.strategy = WaitStrategy::SpinPark;
+        }
+        if (config_.engine.prefault_book) {
+            book_.prefault();
+        }
+        risk_.set_controls(&controls_, nullptr);
+
+        // Runs on the matching thread; accounts are updated in post-trade
+        book_.set_trade_callback([this](const Trade& trade) {
+            trades_.push(trade);
+        });
+    }
+
+    ~PipelineEngine() { stop(); }
+
+    // Non-copyable, non-movable
+    PipelineEngine(const PipelineEngine&) = delete;
+    PipelineEngine& operator=(const PipelineEngine&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    /**
+     * @brief Launch the three stage threads
+     */
+    void start() {
+        if (risk_thread_.joinable()) {
+            return;
+        }
+        risk_thread_ = std::jthread([this](std::stop_token st) {
+            pin(config_.risk_core);
+            run_risk(st);
+        });
+        matching_thread_ = std::jthread([this](std::stop_token st) {
+            pin(config_.matching_core);
+            run_matching(st);
+        });
+        post_trade_thread_ = std::jthread([this](std::stop_token st) {
+            pin(config_.post_trade_core);
+            run_post_trade(st);
+        });
+    }
+
+    /**
+     * @brief Wait for every published event to retire, then join the stages
+     *
+     * Call from the publisher thread (or after it has stopped publishing).
+     */
+    void stop() {
+        if (!risk_thread_.joinable()) {
+            return;
+        }
+        while (post_trade_done_.get() < published_.get()) {
+            std::this_thread::yield();
+        }
+        risk_thread_.request_stop();
+        matching_thread_.request_stop();
+        post_trade_thread_.request_stop();
+        risk_thread_.join();
+        matching_thread_.join();
+        post_trade_thread_.join();
+    }
+
+    // ========================================================================
+    // Publisher Interface (call from ONE thread only)
+    // ========================================================================
+
+    /**
+     * @brief Publish an event into the ring
+     * @return false if the ring is full (post-trade has not freed a slot)
+     */
+    [[nodiscard]] bool try_publish(const OrderEvent& event) noexcept {
+        if CES_UNLIKELY(claim_ - cached_gate_ >= Capacity) {
+            cached_gate_ = post_trade_done_.get();
+            if (claim_ - cached_gate_ >= Capacity) {
+                return false;
+            }
+        }
+        slots_[claim_ & MASK].event = event;
+        published_.set(++claim_);
+        return true;
+    }
+
+    /**
+     * @brief Publish an event, yielding while the ring is full
+     */
+    void publish(const OrderEvent& event) noexcept {
+        while (!try_publish(event)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // ========================================================================
+    // Accessors
+    // ========================================================================
+
+    /**
+     * @brief Order book (only safe to inspect after stop())
+     */
+    [[nodiscard]] OrderBook& book() noexcept { return book_; }
+    [[nodiscard]] const OrderBook& book() const noexcept { return book_; }
+
+    [[nodiscard]] Accounts& accounts() noexcept { return accounts_; }
+    [[nodiscard]] const Accounts& accounts() const noexcept { return accounts_; }
+
+    [[nodiscard]] EngineStats& stats() noexcept { return stats_; }
+    [[nodiscard]] const EngineStats& stats() const noexcept { return stats_; }
+
+    /**
+     * @brief Operator controls, read by the risk stage on every event
+     *
+     * A halt rejects new orders regardless of HaltAction: the ring has no
+     * place to park them without stalling later cancels.
+     */
+    [[nodiscard]] SymbolControlsHandle& controls() noexcept { return controls_; }
+
+    /**
+     * @brief Attach market-wide controls shared with other engines (before start())
+     */
+    void set_market_controls(const MarketControlsHandle* market) noexcept {
+        risk_.set_controls(&controls_, market);
+    }
+
+    /**
+     * @brief Events fully retired by the post-trade stage
+     */
+    [[nodiscard]] std::uint64_t events_processed() const noexcept {
+        return events_processed_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] PageBacking ring_backing() const noexcept { return memory_.backing(); }
+
+private:
+    static void pin(const std::optional<std::uint32_t>& core) {
+        if (core) {
+            [[maybe_unused]] auto pin_result = pin_thread_to_core(*core);
+        }
+    }
+
+    /**
+     * @brief Stage 1: account creation and pre-trade risk
+     */
+    void run_risk(std::stop_token stop_token) {
+        SequenceBarrier barrier{&published_};
+        IdleWaiter waiter(config_.engine.wait);
+        std::uint64_t next = 0;
+
+        while (!stop_token.stop_requested()) {
+            // The wait may be long: do not hold back controls reclamation
+            risk_.offline();
+            const std::uint64_t ready = barrier.wait_for(next, waiter, stop_token);
+            for (; next < ready; ++next) {
+                PipelineSlot& slot = slots_[next & MASK];
+                if (slot.event.type != OrderType::Cancel) {
+                    accounts_.get_or_create(slot.event.trader_id, config_.engine.initial_balance);
+                }
+                // The book runs behind this stage, so a cancel or modify is
+                // checked against its order as it rests now (as accounts are
+                // read now)
+                std::optional<Order> resting;
+                if (slot.event.type == OrderType::Cancel || slot.event.type == OrderType::Modify) {
+                    resting = book_.find_order(slot.event.order_id);
+                }
+                slot.risk = risk_.check(slot.event, resting ? &*resting : nullptr);
+            }
+            risk_done_.set(next);
+        }
+    }
+
+    /**
+     * @brief Stage 2: apply accepted events to the book
+     */
+    void run_matching(std::stop_token stop_token) {
+        SequenceBarrier barrier{&risk_done_};
+        IdleWaiter waiter(config_.engine.wait);
+        std::uint64_t next = 0;
+
+        while (!stop_token.stop_requested()) {
+            const std::uint64_t ready = barrier.wait_for(next, waiter, stop_token);
+            for (; next < ready; ++next) {
+                PipelineSlot& slot = slots_[next & MASK];
+                slot.open_removed = {};
+                slot.open_added = {};
+                slot.response = slot.risk == RiskResult::Passed
+                    ? apply(slot)
+                    : OrderResponse{};
+            }
+            // Trades pushed above are visible to post-trade once it sees this
+            matching_done_.set(next);
+        }
+    }
+
+    /**
+     * @brief Stage 3: accounts, stats, logging and latency
+     */
+    void run_post_trade(std::stop_token stop_token) {
+        SequenceBarrier barrier{&matching_done_};
+        IdleWaiter waiter(config_.engine.wait);
+        std::uint64_t next = 0;
+        Trade trade;
+
+        while (!stop_token.stop_requested()) {
+            const std::uint64_t ready = barrier.available();
+
+            // Every trade from slots < ready is already queued. Draining
+            // also while idle keeps a long sweep from filling the queue
+            // and stalling matching mid-slot.
+            bool drained = false;
+            while (trades_.try_pop(trade)) {
+                on_trade(trade);
+                drained = true;
+            }
+
+            if (ready == next) {
+                if (drained) {
+                    waiter.reset();
+                } else {
+                    waiter.idle();
+                }
+                continue;
+            }
+            waiter.reset();
+
+            for (; next < ready; ++next) {
+                const PipelineSlot& slot = slots_[next & MASK];
+                if CES_UNLIKELY(slot.risk != RiskResult::Passed) {
+                    stats_.rejected_count.fetch_add(1, std::memory_order_relaxed);
+                    if (logger_) {
+                        logger_->log("Rejected order {} reason: {}",
+                                    slot.event.order_id.get(), to_string(slot.risk));
+                    }
+                } else {
+                    apply_open_changes(slot);
+                    events_processed_.fetch_add(1, std::memory_order_relaxed);
+                    if (slot.response.success() && slot.response.qty_filled.get() > 0) {
+                        stats_.filled_qty.fetch_add(slot.response.qty_filled.get(),
+                                                    std::memory_order_relaxed);
+                    }
+                }
+                stats_.record_latency(static_cast<Duration>(now_ns() - slot.event.enqueue_time));
+            }
+            post_trade_done_.set(next);
+        }
+    }
+
+    /**
+     * @brief Apply the slot's event to the book and note how its own order's
+     *        resting state changed (maker fills are settled by on_trade)
+     */
+    OrderResponse apply(PipelineSlot& slot) {
+        const OrderEvent& event = slot.event;
+        OrderResponse response;
+        switch (event.type) {
+            case OrderType::NewLimit:
+                response = book_.add_limit(event.order_id, event.trader_id,
+                                           event.side, event.price, event.qty);
+                if (response.success() && response.qty_remaining.get() > 0) {
+                    slot.open_added = {event.trader_id, event.price, response.qty_remaining, event.side};
+                }
+                return response;
+            case OrderType::NewMarket:
+                return book_.add_market(event.order_id, event.trader_id,
+                                        event.side, event.qty);
+            case OrderType::Cancel:
+            case OrderType::Modify:
+                if (auto before = book_.find_order(event.order_id)) {
+                    slot.open_removed = {before->trader_id, before->price,
+                                         before->qty_remaining, before->side};
+                }
+                if (event.type == OrderType::Cancel) {
+                    return book_.cancel(event.order_id);
+                }
+                response = book_.modify(event.order_id, event.qty, event.price);
+                if (auto after = book_.find_order(event.order_id)) {
+                    slot.open_added = {after->trader_id, after->price, after->qty_remaining, after->side};
+                }
+                return response;
+        }
+        return response;
+    }
+
+    void apply_open_changes(const PipelineSlot& slot) {
+        if (const auto& removed = slot.open_removed; removed.qty.get() > 0) {
+            accounts_.adjust_open(removed.trader_id, removed.side, -removed.qty.get(), removed.price);
+        }
+        if (const auto& added = slot.open_added; added.qty.get() > 0) {
+            accounts_.adjust_open(added.trader_id, added.side, added.qty.get(), added.price);
+        }
+    }
+
+    void on_trade(const Trade& trade) {
+        accounts_.apply_trade(
+            trade.maker_trader_id,
+            trade.taker_trader_id,
+            trade.taker_side,
+            trade.price,
+            trade.qty
+        );
+
+        stats_.trade_count.fetch_add(1, std::memory_order_relaxed);
+        stats_.volume.fetch_add(trade.qty.get(), std::memory_order_relaxed);
+
+        if (logger_) {
+            logger_->log("Trade: {} @ {} maker={} taker={}",
+                        trade.qty.get(), trade.price.get(),
+                        trade.maker_trader_id.get(), trade.taker_trader_id.get());
+        }
+    }
+};
+
+} // namespace ces
@@ -0,0 +1,283 @@
+#pragma once
+/**
+ * @file replication.hpp
+ * @brief Hot-standby replication by streaming the journal over a Unix socket
+ *
+ * Wire protocol (host byte order; both ends run on the same host):
+ *   standby -> primary  ReplicaHello, then one u64 ack (last applied seq)
+ *                       per batch applied
+ *   primary -> standby  JournalRecord stream in seq order, starting at
+ *                       ReplicaHello::next_seq
+ *
+ * The primary's sender thread reads records straight out of the journal
+ * mapping, so the engine thread does no extra copy or system call per
+ * event. The standby applies each record with MatchingEngine::replay(),
+ * the same code path journal recovery uses, so its state tracks the
+ * primary's and it can take over from its last applied seq.
+ *
+ * Lag is bounded in events: once the primary is max_lag records ahead of
+ * the standby's last ack, the engine thread waits in throttle() until the
+ * standby catches up. Those waits are the primary's added latency and are
+ * recorded as such. A primary with no standby connected never waits.
+ */
+
+#include <ces/common/types.hpp>
+#include <ces/common/time.hpp>
+#include <ces/common/macros.hpp>
+#include <ces/engine/journal.hpp>
+#include <ces/metrics/latency.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ces {
+
+/**
+ * @brief Result of starting or connecting a replication endpoint
+ */
+enum class ReplicationResult : std::uint8_t {
+    Ok = 0,
+    IoError = 1,        // Socket could not be created, bound or connected
+    Timeout = 2         // No primary accepted within the timeout
+};
+
+[[nodiscard]] constexpr const char* to_string(ReplicationResult r) noexcept {
+    switch (r) {
+        case ReplicationResult::Ok:      return "Ok";
+        case ReplicationResult::IoError: return "IoError";
+        case ReplicationResult::Timeout: return "Timeout";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief First message from a standby
+ */
+struct ReplicaHello {
+    static constexpr std::uint64_t MAGIC = 0x004F4C4C45485243ULL;  // "CRHELLO\0" on little-endian hosts
+
+    std::uint64_t magic{MAGIC};
+    std::uint64_t next_seq{1};  // First journal seq the standby needs (last applied + 1)
+};
+
+static_assert(std::is_trivially_copyable_v<ReplicaHello>);
+static_assert(sizeof(ReplicaHello) == 16);
+
+/**
+ * @brief Replication options (shared by both ends)
+ */
+struct ReplicationConfig {
+    std::string socket_path{"/tmp/ces_replication.sock"};
+    std::uint64_t max_lag{65'536};                      // Events the standby may trail by
+    std::size_t batch{256};                             // Records per send / receive
+    std::chrono::microseconds poll_interval{20};        // Sender idle sleep
+    std::chrono::milliseconds receive_timeout{10};      // Standby wait for data per poll()
+};
+
+// ============================================================================
+// Primary
+// ============================================================================
+
+/**
+ * @brief Serves one standby at a time from a live journal
+ *
+ * Start before the engine runs and stop before the journal is closed: the
+ * sender thread reads the journal mapping. A standby that disconnects can
+ * reconnect with the seq it needs next, as long as the journal still holds
+ * it (journals are not truncated during a session).
+ *
+ * Thread Safety: throttle() from the journal's appender (the engine
+ * thread); counters from any thread.
+ */
+class ReplicationPrimary {
+private:
+    const Journal& journal_;
+    ReplicationConfig config_;
+    int listen_fd_{-1};
+
+    static constexpr std::uint64_t NO_LIMIT = ~std::uint64_t{0};
+
+    // Written by the sender thread; limit_ is acked + max_lag, or NO_LIMIT
+    // while no standby is connected
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> limit_{NO_LIMIT};
+    std::atomic<std::uint64_t> acked_{0};
+    std::atomic<std::uint64_t> sent_{0};
+    std::atomic<std::uint64_t> connections_{0};
+    std::atomic<bool> connected_{false};
+
+    // Written by the engine thread
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> stalls_{0};
+    std::atomic<std::int64_t> stall_ns_{0};
+    LatencyHistogram stall_histogram_{10'000};
+
+    std::jthread sender_;
+
+public:
+    ReplicationPrimary(const Journal& journal, ReplicationConfig config);
+    ~ReplicationPrimary();
+
+    // Non-copyable, non-movable (the sender holds this)
+    ReplicationPrimary(const ReplicationPrimary&) = delete;
+    ReplicationPrimary& operator=(const ReplicationPrimary&) = delete;
+
+    /**
+     * @brief Listen on config().socket_path (replacing a stale socket) and
+     *        start the sender thread
+     */
+    [[nodiscard]] ReplicationResult start();
+
+    /**
+     * @brief Disconnect the standby, stop the sender and remove the socket
+     */
+    void stop() noexcept;
+
+    /**
+     * @brief Keep the standby within max_lag events of seq
+     * @param seq Journal records written, including the one just appended
+     *
+     * One load and compare on the fast path; waits only while a connected
+     * standby trails by more than max_lag.
+     */
+    CES_FORCE_INLINE void throttle(std::uint64_t seq) noexcept {
+        if CES_LIKELY(seq <= limit_.load(std::memory_order_acquire)) {
+            return;
+        }
+        wait_for_standby(seq);
+    }
+
+    [[nodiscard]] const ReplicationConfig& config() const noexcept { return config_; }
+
+    [[nodiscard]] bool connected() const noexcept { return connected_.load(std::memory_order_acquire); }
+
+    /// Standbys accepted so far
+    [[nodiscard]] std::uint64_t connections() const noexcept { return connections_.load(std::memory_order_relaxed); }
+
+    /// Last seq sent to the standby
+    [[nodiscard]] std::uint64_t sent() const noexcept { return sent_.load(std::memory_order_relaxed); }
+
+    /// Last seq the standby reported applied
+    [[nodiscard]] std::uint64_t acked() const noexcept { return acked_.load(std::memory_order_acquire); }
+
+    /// Journal records not yet applied by the connected standby
+    [[nodiscard]] std::uint64_t lag_events() const noexcept {
+        if (!connected()) {
+            return 0;
+        }
+        const std::uint64_t written = journal_.written();
+        const std::uint64_t acked = this->acked();
+        return written > acked ? written - acked : 0;
+    }
+
+    /// Times the engine waited for the standby (the primary's added latency)
+    [[nodiscard]] std::uint64_t stalls() const noexcept { return stalls_.load(std::memory_order_relaxed); }
+    [[nodiscard]] Duration stall_ns() const noexcept { return stall_ns_.load(std::memory_order_relaxed); }
+    [[nodiscard]] LatencyStats stall_stats() const { return stall_histogram_.compute_stats(); }
+
+private:
+    void send_loop(std::stop_token stop_token);
+
+    /**
+     * @brief Stream records to one standby until it disconnects or stop
+     */
+    void serve(int fd, std::stop_token stop_token);
+
+    CES_NOINLINE void wait_for_standby(std::uint64_t seq) noexcept;
+};
+
+// ============================================================================
+// Standby
+// ============================================================================
+
+/**
+ * @brief Receives the journal stream and feeds it to an apply function
+ *
+ * Typical loop on the standby engine's thread:
+ *
+ *     while (!stop) {
+ *         standby.poll([&](const JournalRecord& r) { engine.replay(r); });
+ *     }
+ *
+ * To fail over, stop polling: the engine holds the state after applied()
+ * records and can journal and match new events from there.
+ *
+ * Thread Safety: connect()/poll() from one thread; counters from any thread.
+ */
+class ReplicationStandby {
+private:
+    ReplicationConfig config_;
+    int fd_{-1};
+
+    std::vector<JournalRecord> buffer_;
+    std::size_t buffered_bytes_{0};   // Received into buffer_, complete or not
+    std::size_t consumed_bytes_{0};   // Handed out by the last receive()
+
+    std::atomic<std::uint64_t> applied_{0};
+    std::atomic<std::int64_t> last_lag_ns_{0};
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> gap_{false};
+    LatencyHistogram lag_histogram_{100'000};
+
+public:
+    explicit ReplicationStandby(ReplicationConfig config);
+    ~ReplicationStandby();
+
+    ReplicationStandby(const ReplicationStandby&) = delete;
+    ReplicationStandby& operator=(const ReplicationStandby&) = delete;
+
+    /**
+     * @brief Connect to a primary and request records from next_seq
+     * @param next_seq Last seq already in the standby's state + 1 (1 when
+     *        starting empty, checkpoint seq + 1 after a recovery)
+     * @param timeout How long to retry while the primary is not listening
+     */
+    [[nodiscard]] ReplicationResult connect(std::uint64_t next_seq,
+                                            std::chrono::milliseconds timeout = std::chrono::seconds{5});
+
+    /**
+     * @brief Apply the records that have arrived, then acknowledge them
+     * @param apply Called with each record in seq order
+     * @return Records applied (0 on timeout or once disconnected)
+     */
+    template <typename Apply>
+    std::size_t poll(Apply&& apply) {
+        const std::span<const JournalRecord> records = receive();
+        for (const JournalRecord& record : records) {
+            apply(record);
+        }
+        if (!records.empty()) {
+            acknowledge(records.back());
+        }
+        return records.size();
+    }
+
+    void disconnect() noexcept;
+
+    [[nodiscard]] bool connected() const noexcept { return connected_.load(std::memory_order_acquire); }
+
+    /// The primary skipped a seq or sent a corrupt record (stream rejected and disconnected)
+    [[nodiscard]] bool gap_detected() const noexcept { return gap_.load(std::memory_order_relaxed); }
+
+    /// Last seq applied
+    [[nodiscard]] std::uint64_t applied() const noexcept { return applied_.load(std::memory_order_acquire); }
+
+    /// Primary acceptance to standby apply, for the newest record of each batch
+    [[nodiscard]] Duration last_lag_ns() const noexcept { return last_lag_ns_.load(std::memory_order_relaxed); }
+    [[nodiscard]] LatencyStats lag_stats() const { return lag_histogram_.compute_stats(); }
+
+private:
+    /**
+     * @brief Wait up to receive_timeout for data; return the complete records
+     */
+    std::span<const JournalRecord> receive();
+
+    void acknowledge(const JournalRecord& last) noexcept;
+};
+
+} // namespace ces
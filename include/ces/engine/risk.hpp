@@ -7,23 +7,45 @@
  */
 
 #include <ces/common/types.hpp>
+#include <ces/common/time.hpp>
+#include <ces/common/instrument.hpp>
 #include <ces/engine/accounts.hpp>
+#include <ces/engine/trading_controls.hpp>
 #include <ces/lob/order.hpp>
 
+#include <algorithm>
 #include <cstdint>
+#include <optional>
+#include <vector>
 
 namespace ces {
 
+/**
+ * @brief Per-trader message-rate limits (0 per second = unlimited)
+ *
+ * New orders and modifies share one bucket, cancels have their own so a
+ * trader can always pull quotes even when order entry is saturated.
+ */
+struct ThrottleLimits {
+    std::uint32_t new_orders_per_sec{0};
+    std::uint32_t new_order_burst{1};   // Messages allowed back to back
+    std::uint32_t cancels_per_sec{0};
+    std::uint32_t cancel_burst{1};
+};
+
 /**
  * @brief Risk check configuration
  */
 struct RiskConfig {
-    std::int64_t max_order_value{1'000'000'000};  // Max notional per order
-    std::int64_t max_position{1'000'000};         // Max position size
+    std::int64_t max_order_value{1'000'000'000};  // Max notional per order (ticks x lots)
+    std::int64_t max_position{1'000'000};         // Max |position| if every open order on a side fills
+    std::int64_t max_open_notional{100'000'000'000};  // Max resting notional (both sides) incl. the new order
     Qty max_order_qty{Qty{100'000}};              // Max quantity per order
     Price max_price{Price{1'000'000}};            // Max valid price
     Price min_price{Price{1}};                    // Min valid price
     bool check_balance{true};                     // Require sufficient balance
+    ThrottleLimits throttle;                      // Default rate limits for every trader
+    std::size_t throttle_traders{4096};           // Throttle table size (TraderIds below this)
     
     RiskConfig() = default;
 };
@@ -38,7 +60,12 @@ enum class RiskResult : std::uint8_t {
     ExceedsMaxOrderValue = 3,
     ExceedsMaxPosition = 4,
     InsufficientBalance = 5,
-    UnknownTrader = 6
+    UnknownTrader = 6,
+    ExceedsMaxExposure = 7,
+    RateLimited = 8,
+    OutsidePriceBand = 9,
+    Halted = 10,
+    JournalUnavailable = 11  // Set by the engine: the journal is full or failed
 };
 
 [[nodiscard]] constexpr const char* to_string(RiskResult r) noexcept {
@@ -50,6 +77,11 @@ enum class RiskResult : std::uint8_t {
         case RiskResult::ExceedsMaxPosition:  return "ExceedsMaxPosition";
         case RiskResult::InsufficientBalance: return "InsufficientBalance";
         case RiskResult::UnknownTrader:       return "UnknownTrader";
+        case RiskResult::ExceedsMaxExposure:  return "ExceedsMaxExposure";
+        case RiskResult::RateLimited:         return "RateLimited";
+        case RiskResult::OutsidePriceBand:    return "OutsidePriceBand";
+        case RiskResult::Halted:              return "Halted";
+        case RiskResult::JournalUnavailable:  return "JournalUnavailable";
     }
     return "Unknown";
 }
@@ -59,11 +91,63 @@ enum class RiskResult : std::uint8_t {
  * 
  * Performs fast validation on incoming orders before they reach the book.
  * Designed to fail fast on obviously bad orders.
+ * 
+ * Position, exposure and balance limits read the trader's Account, where
+ * the engine keeps open (resting) quantity and notional per side, so they
+ * cost one directory lookup and never touch the book. They apply to new
+ * orders, and to modifies as the difference from the resting order the
+ * engine looks up for them.
+ * 
+ * Rate limits are token buckets kept as GCRA state (one "theoretical
+ * arrival time" per bucket) in a dense array indexed by TraderId, refilled
+ * lazily from the event's enqueue time: no lock, no clock read, no division
+ * on the hot path. The table is only allocated once a limit is configured;
+ * TraderIds at or above RiskConfig::throttle_traders are not throttled, and
+ * a cancel or modify without a TraderId counts against its order's owner.
+ * 
+ * Halts and the dynamic price band come from operator-published
+ * SymbolControls / MarketControls snapshots (one acquire load each per
+ * event), so an update takes effect on the next event checked.
+ * 
+ * Thread Safety: check() mutates throttle state; call it from one thread.
  */
 class RiskChecker {
 private:
+    /// One token bucket: a message at time t conforms if tat - t <= tolerance
+    struct Bucket {
+        Timestamp tat{0};        // When the bucket will be full again
+        Duration interval{0};    // ns per message (0 = unlimited)
+        Duration tolerance{0};   // (burst - 1) * interval
+        
+        void set(std::uint32_t per_sec, std::uint32_t burst) noexcept {
+            tat = 0;
+            interval = per_sec == 0 ? 0 : 1'000'000'000 / static_cast<Duration>(per_sec);
+            tolerance = interval * (static_cast<Duration>(std::max<std::uint32_t>(burst, 1)) - 1);
+        }
+        
+        [[nodiscard]] CES_FORCE_INLINE bool try_consume(Timestamp now) noexcept {
+            if (interval == 0) {
+                return true;
+            }
+            const Timestamp earliest = std::max(tat, now);
+            if CES_UNLIKELY(static_cast<Duration>(earliest - now) > tolerance) {
+                return false;
+            }
+            tat = earliest + static_cast<Timestamp>(interval);
+            return true;
+        }
+    };
+    
+    struct TraderThrottle {
+        Bucket new_orders;
+        Bucket cancels;
+    };
+    
     RiskConfig config_;
     const Accounts* accounts_;
+    std::vector<TraderThrottle> throttles_;  // Indexed by TraderId; empty = no limits
+    SymbolControlsHandle::Reader symbol_controls_;
+    MarketControlsHandle::Reader market_controls_;
 
 public:
     /**
@@ -74,6 +158,7 @@ public:
     explicit RiskChecker(RiskConfig config = {}, const Accounts* accounts = nullptr)
         : config_(std::move(config))
         , accounts_(accounts) {
+        reset_throttles();
     }
     
     /**
@@ -83,17 +168,104 @@ public:
         accounts_ = accounts;
     }
     
+    /**
+     * @brief Attach operator controls (either may be null)
+     *
+     * Registers as a reader of each, so both must outlive this checker.
+     * Each check() marks a quiescent point, which lets publishers free
+     * superseded snapshots; call quiescent() while idle, or offline()
+     * before blocking, for the same.
+     */
+    void set_controls(const SymbolControlsHandle* symbol, const MarketControlsHandle* market) {
+        symbol_controls_ = symbol ? symbol->register_reader() : SymbolControlsHandle::Reader{};
+        market_controls_ = market ? market->register_reader() : MarketControlsHandle::Reader{};
+    }
+    
+    /**
+     * @brief Declare that no controls snapshot from earlier checks is in use
+     */
+    CES_FORCE_INLINE void quiescent() noexcept {
+        symbol_controls_.quiescent();
+        market_controls_.quiescent();
+    }
+    
+    /**
+     * @brief Hold no controls snapshot until the next check() or quiescent()
+     *
+     * Call before blocking for a long time; halt_state() needs quiescent() first.
+     */
+    void offline() noexcept {
+        symbol_controls_.offline();
+        market_controls_.offline();
+    }
+    
+    /**
+     * @brief Whether new orders are currently halted, and what to do with them
+     * @return Action for halted orders, or nullopt if trading is open
+     */
+    [[nodiscard]] std::optional<HaltAction> halt_state() const noexcept {
+        if (const MarketControls* market = market_controls_.get(); market && market->halted) {
+            return market->halt_action;
+        }
+        if (const SymbolControls* symbol = symbol_controls_.get(); symbol && symbol->halted) {
+            return symbol->halt_action;
+        }
+        return std::nullopt;
+    }
+    
     /**
      * @brief Check if order passes risk limits
      * @param event Order event to validate
+     * @param resting For a cancel or modify, the order it refers to if it is
+     *        in the book. Its owner is throttled when the event carries no
+     *        trader, and a modify, which replaces it, is held to account
+     *        limits by the change. Without it the book rejects the event as
+     *        NotFound, so only per-message checks apply.
      * @return Risk check result
      */
-    [[nodiscard]] RiskResult check(const OrderEvent& event) const noexcept {
-        // Skip checks for cancels
+    [[nodiscard]] RiskResult check(const OrderEvent& event, const Order* resting = nullptr) noexcept {
+        quiescent();
+        
+        // Halts first (cancels are allowed while halted): a halted order uses
+        // no rate token, so one parked by a Queue-mode halt is charged once,
+        // as of its arrival, when it is released
+        const SymbolControls* controls = symbol_controls_.get();
+        if (event.type != OrderType::Cancel) {
+            if (const MarketControls* market = market_controls_.get(); market && market->halted) {
+                return RiskResult::Halted;
+            }
+            if CES_UNLIKELY(controls && controls->halted) {
+                return RiskResult::Halted;
+            }
+        }
+        
+        // Message rate (cancels included). Cancels and modifies may omit the
+        // trader: they are charged to the owner of the order they refer to.
+        if (!throttles_.empty()) {
+            TraderId sender = event.trader_id;
+            if (sender == constants::INVALID_TRADER_ID && resting != nullptr) {
+                sender = resting->trader_id;
+            }
+            const auto index = static_cast<std::size_t>(sender.get());
+            if CES_LIKELY(index < throttles_.size()) {
+                TraderThrottle& throttle = throttles_[index];
+                Bucket& bucket = event.type == OrderType::Cancel ? throttle.cancels : throttle.new_orders;
+                if CES_UNLIKELY(!bucket.try_consume(event.enqueue_time)) {
+                    return RiskResult::RateLimited;
+                }
+            }
+        }
+        
+        // No further checks for cancels
         if CES_LIKELY(event.type == OrderType::Cancel) {
             return RiskResult::Passed;
         }
         
+        // Dynamic price band
+        if (controls && event.type != OrderType::NewMarket && !controls->in_band(event.price)) {
+            return RiskResult::OutsidePriceBand;
+        }
+        
         // Price validation (skip for market orders)
         if (event.type == OrderType::NewLimit || event.type == OrderType::Modify) {
             if CES_UNLIKELY(event.price < config_.min_price || event.price > config_.max_price) {
@@ -107,17 +279,67 @@ public:
         }
         
         // Notional value check
-        std::int64_t notional = event.price.get() * event.qty.get();
+        std::int64_t notional = notional_value(event.price, event.qty);
         if CES_UNLIKELY(notional > config_.max_order_value) {
             return RiskResult::ExceedsMaxOrderValue;
         }
         
-        // Balance check (if enabled and accounts available)
-        if (config_.check_balance && accounts_ != nullptr) {
-            if (event.side == Side::Buy) {
-                if (!accounts_->has_sufficient_balance(event.trader_id, notional)) {
-                    return RiskResult::InsufficientBalance;
-                }
+        if (accounts_ == nullptr) {
+            return RiskResult::Passed;
+        }
+        
+        // A modify takes its side and owner from the resting order, whose
+        // open quantity and notional it releases
+        Side side = event.side;
+        TraderId owner = event.trader_id;
+        std::int64_t released_qty = 0;
+        std::int64_t released_notional = 0;
+        if (event.type == OrderType::Modify) {
+            if (resting == nullptr) {
+                return RiskResult::Passed;
+            }
+            side = resting->side;
+            owner = resting->trader_id;
+            released_qty = resting->qty_remaining.get();
+            released_notional = notional_value(resting->price, resting->qty_remaining);
+        }
+        
+        const Account* acc = accounts_->get(owner);
+        if CES_UNLIKELY(acc == nullptr) {
+            // No account (e.g. max_traders reached): nothing to buy with
+            return (config_.check_balance && side == Side::Buy)
+                ? RiskResult::InsufficientBalance
+                : RiskResult::Passed;
+        }
+        
+        // Worst-case position: every open order on this side fills, then this one
+        const std::int64_t position = acc->position.load(std::memory_order_relaxed);
+        const std::int64_t qty = event.qty.get() - released_qty;
+        if (side == Side::Buy) {
+            if CES_UNLIKELY(position + acc->open_buy_qty.load(std::memory_order_relaxed) + qty
+                            > config_.max_position) {
+                return RiskResult::ExceedsMaxPosition;
+            }
+        } else {
+            if CES_UNLIKELY(acc->open_sell_qty.load(std::memory_order_relaxed) + qty - position
+                            > config_.max_position) {
+                return RiskResult::ExceedsMaxPosition;
+            }
+        }
+        
+        // Resting exposure across both sides
+        const std::int64_t open_buy_notional = acc->open_buy_notional.load(std::memory_order_relaxed)
+            - (side == Side::Buy ? released_notional : 0);
+        const std::int64_t open_sell_notional = acc->open_sell_notional.load(std::memory_order_relaxed)
+            - (side == Side::Sell ? released_notional : 0);
+        if CES_UNLIKELY(open_buy_notional + open_sell_notional + notional > config_.max_open_notional) {
+            return RiskResult::ExceedsMaxExposure;
+        }
+        
+        // Balance must cover resting buys as well as this one
+        if (config_.check_balance && side == Side::Buy) {
+            if (acc->balance.load(std::memory_order_relaxed) - open_buy_notional < notional) {
+                return RiskResult::InsufficientBalance;
             }
         }
         
@@ -131,8 +353,44 @@ public:
     
     /**
      * @brief Update configuration
+     * 
+     * Resets every trader's rate limits to the new defaults.
+     */
+    void set_config(RiskConfig config) {
+        config_ = std::move(config);
+        reset_throttles();
+    }
+    
+    /**
+     * @brief Override rate limits for one trader
+     * @return false if the TraderId is outside the throttle table
      */
-    void set_config(RiskConfig config) noexcept { config_ = std::move(config); }
+    bool set_trader_limits(TraderId trader_id, const ThrottleLimits& limits) {
+        const auto index = static_cast<std::size_t>(trader_id.get());
+        if (index >= config_.throttle_traders) {
+            return false;
+        }
+        if (throttles_.empty()) {
+            throttles_.resize(config_.throttle_traders);
+        }
+        throttles_[index].new_orders.set(limits.new_orders_per_sec, limits.new_order_burst);
+        throttles_[index].cancels.set(limits.cancels_per_sec, limits.cancel_burst);
+        return true;
+    }
+
+private:
+    void reset_throttles() {
+        const ThrottleLimits& limits = config_.throttle;
+        if (limits.new_orders_per_sec == 0 && limits.cancels_per_sec == 0) {
+            throttles_.clear();  // Nothing to enforce until a trader gets limits
+            return;
+        }
+        throttles_.assign(config_.throttle_traders, TraderThrottle{});
+        for (TraderThrottle& throttle : throttles_) {
+            throttle.new_orders.set(limits.new_orders_per_sec, limits.new_order_burst);
+            throttle.cancels.set(limits.cancels_per_sec, limits.cancel_burst);
+        }
+    }
 };
 
 } // namespace ces
@@ -8,15 +8,23 @@
 
 #include <ces/common/types.hpp>
 #include <ces/common/time.hpp>
+#include <ces/common/concepts.hpp>
 #include <ces/lob/order.hpp>
 #include <ces/concurrency/spsc_semaphore_queue.hpp>
+#include <ces/concurrency/spsc_queue.hpp>
+#include <ces/concurrency/mpsc_queue.hpp>
 #include <ces/concurrency/pinning.hpp>
+#include <ces/engine/execution_report.hpp>
+#include <ces/metrics/latency.hpp>
 
 #include <random>
 #include <atomic>
 #include <thread>
 #include <stop_token>
 #include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace ces {
 
@@ -29,8 +37,8 @@ struct TraderConfig {
     std::uint64_t orders_to_generate{1000};
     
     // Price distribution
-    Price base_price{Price{10000}};  // Center price
-    std::int64_t price_range{100};   // +/- range from base
+    Price base_price{Price{10000}};       // Center price
+    Price::value_type price_range{100};   // +/- range from base, in ticks
     
     // Quantity distribution
     Qty min_qty{Qty{1}};
@@ -57,11 +65,21 @@ struct TraderConfig {
  * 
  * Generates random orders and pushes them to a queue.
  * Designed to run in a separate thread (std::jthread).
+ *
+ * With an execution report queue attached, the trader tracks which of its
+ * orders are actually resting (acked and not yet filled or cancelled) and
+ * only cancels/modifies those; it also records order-to-ack round trips.
+ * Without one it falls back to picking from every ID it has sent.
+ *
+ * @tparam QueueCapacity Capacity of output queue (must be power of 2)
+ * @tparam QueueT Output queue type, matching the engine's
  */
-template<std::size_t QueueCapacity>
+template<std::size_t QueueCapacity,
+         typename QueueT = SpscSemaphoreQueue<OrderEvent, QueueCapacity>>
+    requires EventQueue<QueueT, OrderEvent>
 class Trader {
 public:
-    using Queue = SpscSemaphoreQueue<OrderEvent, QueueCapacity>;
+    using Queue = QueueT;
 
 private:
     TraderConfig config_;
@@ -74,6 +92,17 @@ private:
     // Track sent orders for cancel/modify
     std::vector<OrderId> sent_order_ids_;
     std::atomic<std::uint64_t> next_order_id_;
+    
+    // Execution reports (optional)
+    ReportRouter::Queue* reports_;
+    struct LiveOrder {
+        std::size_t slot;  // Position in live_ids_
+        Qty leaves;
+    };
+    std::vector<OrderId> live_ids_;
+    std::unordered_map<std::uint64_t, LiveOrder> live_;
+    std::atomic<std::uint64_t> reports_received_{0};
+    LatencyHistogram round_trip_;
 
 public:
     /**
@@ -81,14 +110,20 @@ public:
      * @param config Trader configuration
      * @param queue Queue to push orders to
      * @param starting_order_id Starting order ID (must be unique across traders)
+     * @param reports Outbound report queue attached to the engine's ReportRouter (optional)
      */
-    Trader(TraderConfig config, Queue& queue, std::uint64_t starting_order_id)
+    Trader(TraderConfig config, Queue& queue, std::uint64_t starting_order_id,
+           ReportRouter::Queue* reports = nullptr)
         : config_(std::move(config))
         , queue_(queue)
         , rng_(config_.seed)
-        , next_order_id_(starting_order_id) {
+        , next_order_id_(starting_order_id)
+        , reports_(reports) {
         
         sent_order_ids_.reserve(config_.orders_to_generate);
+        if (reports_) {
+            live_.reserve(config_.orders_to_generate);
+        }
     }
     
     /**
@@ -109,11 +144,11 @@ public:
         }
         
         std::uniform_real_distribution<double> unit_dist(0.0, 1.0);
-        std::uniform_int_distribution<std::int64_t> price_dist(
+        std::uniform_int_distribution<Price::value_type> price_dist(
             config_.base_price.get() - config_.price_range,
             config_.base_price.get() + config_.price_range
         );
-        std::uniform_int_distribution<std::int64_t> qty_dist(
+        std::uniform_int_distribution<Qty::value_type> qty_dist(
             config_.min_qty.get(),
             config_.max_qty.get()
         );
@@ -143,6 +178,8 @@ public:
                 }
             }
             
+            poll_reports();
+            
             // Generate order
             OrderEvent event = generate_order(unit_dist, price_dist, qty_dist);
             
@@ -168,6 +205,48 @@ public:
         return orders_sent_.load(std::memory_order_relaxed);
     }
     
+    /**
+     * @brief Apply pending execution reports to the live-order set
+     * @return Number of reports consumed
+     *
+     * Called from run() before every order; call it directly (from the
+     * trader's own thread, or after run() returns) to drain the rest.
+     */
+    std::size_t poll_reports() {
+        if (reports_ == nullptr) {
+            return 0;
+        }
+        std::size_t count = 0;
+        ExecutionReport report;
+        while (reports_->try_pop(report)) {
+            on_report(report);
+            ++count;
+        }
+        if (count > 0) {
+            reports_received_.fetch_add(count, std::memory_order_relaxed);
+        }
+        return count;
+    }
+    
+    /**
+     * @brief Execution reports consumed so far
+     */
+    [[nodiscard]] std::uint64_t reports_received() const noexcept {
+        return reports_received_.load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Orders currently believed to be resting in the book
+     */
+    [[nodiscard]] std::size_t live_orders() const noexcept { return live_ids_.size(); }
+    
+    /**
+     * @brief Order-to-terminal-report round-trip latency
+     */
+    [[nodiscard]] LatencyStats round_trip_stats() const {
+        return round_trip_.compute_stats();
+    }
+    
     /**
      * @brief Check if still running
      */
@@ -187,25 +266,28 @@ private:
     OrderEvent generate_order(D1& unit_dist, D2& price_dist, D3& qty_dist) {
         double r = unit_dist(rng_);
         
+        // Cancel/modify targets: known-resting orders when reports are available
+        const std::vector<OrderId>& candidates = reports_ ? live_ids_ : sent_order_ids_;
+        
         // Decide order type
-        bool is_cancel = r < config_.prob_cancel && !sent_order_ids_.empty();
+        bool is_cancel = r < config_.prob_cancel && !candidates.empty();
         bool is_modify = !is_cancel && r < (config_.prob_cancel + config_.prob_modify) 
-                         && !sent_order_ids_.empty();
+                         && !candidates.empty();
         
         if (is_cancel) {
             // Random cancel
-            std::uniform_int_distribution<std::size_t> idx_dist(0, sent_order_ids_.size() - 1);
-            OrderId cancel_id = sent_order_ids_[idx_dist(rng_)];
-            return OrderEvent::cancel(cancel_id);
+            std::uniform_int_distribution<std::size_t> idx_dist(0, candidates.size() - 1);
+            OrderId cancel_id = candidates[idx_dist(rng_)];
+            return OrderEvent::cancel(cancel_id, config_.trader_id);
         }
         
         if (is_modify) {
             // Random modify
-            std::uniform_int_distribution<std::size_t> idx_dist(0, sent_order_ids_.size() - 1);
-            OrderId modify_id = sent_order_ids_[idx_dist(rng_)];
+            std::uniform_int_distribution<std::size_t> idx_dist(0, candidates.size() - 1);
+            OrderId modify_id = candidates[idx_dist(rng_)];
             Qty new_qty{qty_dist(rng_)};
             Price new_price{price_dist(rng_)};
-            return OrderEvent::modify(modify_id, new_qty, new_price);
+            return OrderEvent::modify(modify_id, new_qty, new_price, config_.trader_id);
         }
         
         // New order
@@ -220,6 +302,61 @@ private:
             return OrderEvent::new_market(order_id, config_.trader_id, side, qty);
         }
     }
+    
+    void on_report(const ExecutionReport& report) {
+        if (report.is_terminal()) {
+            round_trip_.record(elapsed_ns(report.enqueue_time));
+        }
+        
+        switch (report.type) {
+            case ExecType::Ack:
+            case ExecType::Modified:
+                // Taker fills arrive before the ack; leaves is what rests afterwards
+                set_leaves(report.order_id, report.leaves);
+                break;
+            case ExecType::Fill:
+                if (auto it = live_.find(report.order_id.get()); it != live_.end()) {
+                    set_leaves(report.order_id, it->second.leaves - report.qty);
+                }
+                break;
+            case ExecType::Cancelled:
+                set_leaves(report.order_id, Qty{0});
+                break;
+            case ExecType::Rejected:
+                // A risk reject never reaches the book: a rejected cancel or
+                // modify leaves its order resting (and a rejected new order
+                // was never live). Book rejects mean the order is gone.
+                if (report.risk == RiskResult::Passed) {
+                    set_leaves(report.order_id, Qty{0});
+                }
+                break;
+        }
+    }
+    
+    void set_leaves(OrderId order_id, Qty leaves) {
+        auto it = live_.find(order_id.get());
+        if (leaves.get() > 0) {
+            if (it == live_.end()) {
+                live_.emplace(order_id.get(), LiveOrder{live_ids_.size(), leaves});
+                live_ids_.push_back(order_id);
+            } else {
+                it->second.leaves = leaves;
+            }
+            return;
+        }
+        if (it == live_.end()) {
+            return;
+        }
+        // Swap-remove from the dense ID list
+        const std::size_t slot = it->second.slot;
+        const OrderId moved = live_ids_.back();
+        live_ids_[slot] = moved;
+        live_ids_.pop_back();
+        if (moved != order_id) {
+            live_.find(moved.get())->second.slot = slot;
+        }
+        live_.erase(it);
+    }
 };
 
 } // namespace ces
@@ -0,0 +1,94 @@
+#pragma once
+/**
+ * @file trading_controls.hpp
+ * @brief Operator-controlled price bands and trading halts
+ *
+ * Each engine (one symbol) holds its SymbolControls; MarketControls can be
+ * shared by every engine in the market. Both are immutable snapshots in a
+ * VersionedConfig, so operators update them from any thread and the risk
+ * check sees the change on the next event without taking a lock.
+ */
+
+#include <ces/common/types.hpp>
+#include <ces/concurrency/versioned_config.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace ces {
+
+/**
+ * @brief What the engine does with new orders and modifies during a halt
+ *
+ * Cancels are always processed so traders can pull resting orders.
+ */
+enum class HaltAction : std::uint8_t {
+    Reject = 0,  // Reject with RiskResult::Halted
+    Queue = 1    // Park in arrival order, process once trading resumes
+};
+
+[[nodiscard]] constexpr const char* to_string(HaltAction a) noexcept {
+    switch (a) {
+        case HaltAction::Reject: return "Reject";
+        case HaltAction::Queue:  return "Queue";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Per-symbol controls: dynamic price band and halt state
+ *
+ * The band is stored as precomputed tick bounds so the risk check is two
+ * compares; use with_band() to derive them from a reference price.
+ */
+struct SymbolControls {
+    Price band_low{std::numeric_limits<Price::value_type>::min()};
+    Price band_high{std::numeric_limits<Price::value_type>::max()};
+    Price reference_price{0};     // 0 = no dynamic band
+    std::uint32_t band_bps{0};    // Half-width in basis points of the reference
+    bool halted{false};
+    HaltAction halt_action{HaltAction::Reject};
+
+    /**
+     * @brief Copy with a band of +/- band_bps around reference
+     */
+    [[nodiscard]] constexpr SymbolControls with_band(Price reference, std::uint32_t bps) const noexcept {
+        SymbolControls next = *this;
+        next.reference_price = reference;
+        next.band_bps = bps;
+        const std::int64_t ref = reference.get();
+        const std::int64_t width = ref * static_cast<std::int64_t>(bps) / 10'000;
+        next.band_low = Price{static_cast<Price::value_type>(std::max<std::int64_t>(ref - width, 0))};
+        next.band_high = Price{static_cast<Price::value_type>(std::min<std::int64_t>(
+            ref + width, std::numeric_limits<Price::value_type>::max()))};
+        return next;
+    }
+
+    /**
+     * @brief Copy with the halt state changed
+     */
+    [[nodiscard]] constexpr SymbolControls with_halt(bool halt, HaltAction action = HaltAction::Reject) const noexcept {
+        SymbolControls next = *this;
+        next.halted = halt;
+        next.halt_action = action;
+        return next;
+    }
+
+    [[nodiscard]] constexpr bool in_band(Price price) const noexcept {
+        return price >= band_low && price <= band_high;
+    }
+};
+
+/**
+ * @brief Market-wide controls shared by every symbol's engine
+ */
+struct MarketControls {
+    bool halted{false};
+    HaltAction halt_action{HaltAction::Reject};
+};
+
+using SymbolControlsHandle = VersionedConfig<SymbolControls>;
+using MarketControlsHandle = VersionedConfig<MarketControls>;
+
+} // namespace ces
@@ -0,0 +1,82 @@
+#pragma once
+/**
+ * @file book_snapshot.hpp
+ * @brief On-disk format of OrderBook snapshots
+ *
+ * Layout (host byte order, no padding between records):
+ *   SnapshotHeader
+ *   SnapshotLevel x (bid_levels + ask_levels)   bids best-first, then asks best-first
+ *   SnapshotOrder x order_count                 per level, in time priority
+ *
+ * Side and price of an order are implied by the level it follows, so the
+ * image is the book in matching order and can be loaded without matching.
+ */
+
+#include <ces/common/types.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace ces {
+
+/**
+ * @brief Result of saving or loading a snapshot
+ */
+enum class SnapshotResult : std::uint8_t {
+    Ok = 0,
+    IoError = 1,           // File could not be opened, written or mapped
+    BadFormat = 2,         // Magic, sizes or ordering invalid
+    VersionMismatch = 3,   // Written by an incompatible format version
+    CapacityExceeded = 4   // Book cannot hold the snapshot's orders
+};
+
+[[nodiscard]] constexpr const char* to_string(SnapshotResult r) noexcept {
+    switch (r) {
+        case SnapshotResult::Ok:               return "Ok";
+        case SnapshotResult::IoError:          return "IoError";
+        case SnapshotResult::BadFormat:        return "BadFormat";
+        case SnapshotResult::VersionMismatch:  return "VersionMismatch";
+        case SnapshotResult::CapacityExceeded: return "CapacityExceeded";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Fixed-size snapshot file header
+ */
+struct SnapshotHeader {
+    static constexpr std::uint64_t MAGIC = 0x004B4F4F42534543ULL;  // "CESBOOK\0" on little-endian hosts
+    static constexpr std::uint32_t VERSION = 1;
+
+    std::uint64_t magic{MAGIC};
+    std::uint32_t version{VERSION};
+    std::uint32_t header_size{sizeof(SnapshotHeader)};
+    std::uint64_t order_count{0};
+    std::uint32_t bid_levels{0};
+    std::uint32_t ask_levels{0};
+    std::uint64_t total_trades{0};
+    std::uint64_t total_volume{0};
+};
+
+/**
+ * @brief One price level; followed in the order section by order_count orders
+ */
+struct SnapshotLevel {
+    Price price{0};
+    std::uint32_t order_count{0};
+};
+
+/**
+ * @brief One resting order
+ */
+struct SnapshotOrder {
+    OrderId order_id{0};
+    TraderId trader_id{0};
+    Qty qty{0};
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+static_assert(sizeof(SnapshotLevel) == 8);
+static_assert(sizeof(SnapshotOrder) == 16);
+
+} // namespace ces
@@ -23,32 +23,32 @@ constexpr std::uint32_t INVALID_POOL_INDEX = std::numeric_limits<std::uint32_t>:
  * 
  * Uses intrusive linked list via indices for O(1) insertion/removal
  * within a price level's FIFO queue.
+ * 
+ * Packed into half a cache line: time priority is positional within the
+ * level's FIFO, so no per-order timestamp is stored.
  */
 struct Order {
     OrderId order_id{constants::INVALID_ORDER_ID};
     TraderId trader_id{constants::INVALID_TRADER_ID};
-    Side side{Side::Buy};
     Price price{0};
     Qty qty_remaining{0};
-    Qty qty_original{0};
-    Timestamp timestamp{0};
     
     // Intrusive linked list (indices into OrderPool)
     std::uint32_t next_idx{INVALID_POOL_INDEX};
     std::uint32_t prev_idx{INVALID_POOL_INDEX};
     
+    Side side{Side::Buy};
+    
     Order() = default;
     
-    Order(OrderId id, TraderId trader, Side s, Price p, Qty qty, Timestamp ts = 0)
+    Order(OrderId id, TraderId trader, Side s, Price p, Qty qty)
         : order_id(id)
         , trader_id(trader)
-        , side(s)
         , price(p)
         , qty_remaining(qty)
-        , qty_original(qty)
-        , timestamp(ts == 0 ? now_ns() : ts)
         , next_idx(INVALID_POOL_INDEX)
-        , prev_idx(INVALID_POOL_INDEX) {
+        , prev_idx(INVALID_POOL_INDEX)
+        , side(s) {
     }
     
     [[nodiscard]] bool is_valid() const noexcept {
@@ -58,26 +58,25 @@ struct Order {
     [[nodiscard]] bool is_filled() const noexcept {
         return qty_remaining.get() <= 0;
     }
-    
-    [[nodiscard]] Qty qty_filled() const noexcept {
-        return qty_original - qty_remaining;
-    }
 };
 
+static_assert(sizeof(Order) <= CACHE_LINE_SIZE / 2, "Order must fit in half a cache line");
+
 /**
  * @brief Order event submitted to the matching engine queue
  * 
  * POD-like structure for efficient queue transfer.
  * Uses aggregate of event-specific data rather than union for simplicity.
+ * Fields are ordered widest-first so two events share a cache line.
  */
 struct OrderEvent {
-    OrderType type{OrderType::NewLimit};
     OrderId order_id{constants::INVALID_ORDER_ID};
+    Timestamp enqueue_time{0};  // For latency measurement
     TraderId trader_id{constants::INVALID_TRADER_ID};
-    Side side{Side::Buy};
     Price price{0};
     Qty qty{0};
-    Timestamp enqueue_time{0};  // For latency measurement
+    OrderType type{OrderType::NewLimit};
+    Side side{Side::Buy};
     
     // Factory methods for clarity
     
@@ -85,13 +84,13 @@ struct OrderEvent {
         OrderId id, TraderId trader, Side side, Price price, Qty qty
     ) noexcept {
         return OrderEvent{
-            .type = OrderType::NewLimit,
             .order_id = id,
+            .enqueue_time = now_ns(),
             .trader_id = trader,
-            .side = side,
             .price = price,
             .qty = qty,
-            .enqueue_time = now_ns()
+            .type = OrderType::NewLimit,
+            .side = side
         };
     }
     
@@ -99,69 +98,75 @@ struct OrderEvent {
         OrderId id, TraderId trader, Side side, Qty qty
     ) noexcept {
         return OrderEvent{
-            .type = OrderType::NewMarket,
             .order_id = id,
+            .enqueue_time = now_ns(),
             .trader_id = trader,
-            .side = side,
             .price = Price{0},
             .qty = qty,
-            .enqueue_time = now_ns()
+            .type = OrderType::NewMarket,
+            .side = side
         };
     }
     
-    [[nodiscard]] static OrderEvent cancel(OrderId id) noexcept {
+    /// trader is optional; set it to receive the execution report
+    [[nodiscard]] static OrderEvent cancel(
+        OrderId id, TraderId trader = constants::INVALID_TRADER_ID
+    ) noexcept {
         return OrderEvent{
-            .type = OrderType::Cancel,
             .order_id = id,
-            .trader_id = constants::INVALID_TRADER_ID,
-            .side = Side::Buy,
+            .enqueue_time = now_ns(),
+            .trader_id = trader,
             .price = Price{0},
             .qty = Qty{0},
-            .enqueue_time = now_ns()
+            .type = OrderType::Cancel,
+            .side = Side::Buy
         };
     }
     
     [[nodiscard]] static OrderEvent modify(
-        OrderId id, Qty new_qty, Price new_price = Price{0}
+        OrderId id, Qty new_qty, Price new_price = Price{0},
+        TraderId trader = constants::INVALID_TRADER_ID
     ) noexcept {
         return OrderEvent{
-            .type = OrderType::Modify,
             .order_id = id,
-            .trader_id = constants::INVALID_TRADER_ID,
-            .side = Side::Buy,
+            .enqueue_time = now_ns(),
+            .trader_id = trader,
             .price = new_price,
             .qty = new_qty,
-            .enqueue_time = now_ns()
+            .type = OrderType::Modify,
+            .side = Side::Buy
         };
     }
 };
 
+static_assert(sizeof(OrderEvent) == CACHE_LINE_SIZE / 2, "Two OrderEvents must share a cache line");
+
 /**
  * @brief Trade execution report
  */
 struct Trade {
     OrderId maker_order_id{constants::INVALID_ORDER_ID};
     OrderId taker_order_id{constants::INVALID_ORDER_ID};
+    Timestamp timestamp{0};
     TraderId maker_trader_id{constants::INVALID_TRADER_ID};
     TraderId taker_trader_id{constants::INVALID_TRADER_ID};
     Price price{0};
     Qty qty{0};
     Side taker_side{Side::Buy};
-    Timestamp timestamp{0};
     
     Trade() = default;
     
     Trade(OrderId maker_oid, OrderId taker_oid, 
           TraderId maker_tid, TraderId taker_tid,
-          Price p, Qty q, Side taker_s)
+          Price p, Qty q, Side taker_s, Timestamp ts = now_ns())
         : maker_order_id(maker_oid)
         , taker_order_id(taker_oid)
+        , timestamp(ts)
         , maker_trader_id(maker_tid)
         , taker_trader_id(taker_tid)
         , price(p)
         , qty(q)
-        , taker_side(taker_s)
-        , timestamp(now_ns()) {
+        , taker_side(taker_s) {
     }
 };
 
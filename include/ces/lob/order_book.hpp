@@ -5,6 +5,7 @@
  * 
  * Uses flat vectors for price levels (no std::map).
  * Orders stored in ObjectPool with intrusive linked lists per level.
+ * Books can be saved to and restored from a binary snapshot.
  * Protected by mutex for optional concurrent read access.
  */
 
@@ -14,16 +15,74 @@
 #include <ces/memory/object_pool.hpp>
 #include <ces/lob/order.hpp>
 #include <ces/lob/price_level.hpp>
+#include <ces/lob/order_index.hpp>
+#include <ces/lob/book_snapshot.hpp>
 
+#include <string>
 #include <vector>
-#include <unordered_map>
 #include <mutex>
 #include <algorithm>
 #include <functional>
 #include <optional>
+#include <span>
 
 namespace ces {
 
+/**
+ * @brief Memory footprint and occupancy of an OrderBook
+ *
+ * "Reserved" is memory obtained from the system (or vector capacity),
+ * "used" is what live contents occupy. Peaks are since construction.
+ */
+struct BookMemoryStats {
+    // Order pool
+    std::size_t pool_reserved_bytes{0};
+    std::size_t pool_used_bytes{0};
+    std::uint32_t pool_capacity{0};
+    std::uint32_t pool_live{0};
+    std::uint32_t pool_peak_live{0};
+    std::uint32_t pool_slots_touched{0};  // Slots ever initialized (faulted in)
+    std::size_t pool_segments{0};
+    std::uint32_t pool_inline_grows{0};
+    
+    // Order index
+    std::size_t index_reserved_bytes{0};
+    std::size_t index_used_bytes{0};
+    std::size_t index_slots{0};
+    std::size_t index_entries{0};
+    std::size_t index_peak_entries{0};
+    double index_load_factor{0.0};
+    double index_mean_probe{0.0};
+    std::uint32_t index_max_probe{0};
+    
+    // Price levels
+    std::size_t level_reserved_bytes{0};
+    std::size_t level_used_bytes{0};
+    std::size_t bid_levels{0};
+    std::size_t ask_levels{0};
+    std::size_t bid_level_capacity{0};
+    std::size_t ask_level_capacity{0};
+    std::size_t peak_bid_levels{0};
+    std::size_t peak_ask_levels{0};
+    std::uint64_t level_inserts{0};
+    std::uint64_t level_erases{0};
+    std::uint64_t level_elements_shifted{0};  // PriceLevels moved by vector insert/erase
+    std::uint64_t level_reallocations{0};     // Level vector outgrew its reservation
+    
+    [[nodiscard]] std::size_t total_reserved_bytes() const noexcept {
+        return pool_reserved_bytes + index_reserved_bytes + level_reserved_bytes;
+    }
+    
+    [[nodiscard]] std::size_t total_used_bytes() const noexcept {
+        return pool_used_bytes + index_used_bytes + level_used_bytes;
+    }
+    
+    /**
+     * @brief Print to stdout
+     */
+    void print() const;
+};
+
 /**
  * @brief Cache-aware limit order book with price-time priority
  * 
@@ -31,7 +90,8 @@ namespace ces {
  * - Uses std::vector<PriceLevel> instead of std::map for cache efficiency
  * - Bids sorted descending, asks sorted ascending
  * - Orders stored in ObjectPool with indices, not pointers
- * - order_id -> pool_index lookup via unordered_map (reserved big, low load factor)
+ * - Pool grows in segments; maintain() pre-allocates them off the hot path
+ * - order_id -> pool_index lookup via flat open-addressing OrderIndex (low load factor)
  * - Mutex protects all mutations (allows optional concurrent reads)
  * 
  * Thread Safety:
@@ -49,7 +109,7 @@ private:
     ObjectPool<Order> order_pool_;
     
     // Order lookup: order_id -> pool_index
-    std::unordered_map<std::uint64_t, std::uint32_t> order_map_;
+    OrderIndex order_index_;
     
     // Price levels (sorted vectors)
     std::vector<PriceLevel> bids_;  // Descending by price
@@ -58,34 +118,46 @@ private:
     // Trade callback
     TradeCallback trade_callback_;
     
+    // Stamped on trades instead of reading the clock per fill (0 = read it)
+    Timestamp trade_time_{0};
+    
     // Mutex for thread safety
     mutable std::mutex mutex_;
     
     // Statistics
     std::uint64_t total_trades_{0};
     std::uint64_t total_volume_{0};
+    
+    // Level container statistics (see memory_stats())
+    std::uint64_t level_inserts_{0};
+    std::uint64_t level_erases_{0};
+    std::uint64_t level_elements_shifted_{0};
+    std::uint64_t level_reallocations_{0};
+    std::size_t peak_bid_levels_{0};
+    std::size_t peak_ask_levels_{0};
 
 public:
     /**
      * @brief Construct order book with reserved capacity
-     * @param max_orders Maximum orders in pool
+     * @param max_orders Initial order pool capacity
      * @param max_levels Maximum price levels per side
-     * @param load_factor Hash map load factor (lower = faster, more memory)
+     * @param load_factor Order index load factor (lower = faster, more memory)
+     * @param memory_policy Allocation policy for the order pool
+     * @param pool_growth Segment size and growth limit for the order pool
      */
     explicit OrderBook(
         std::uint32_t max_orders = static_cast<std::uint32_t>(constants::DEFAULT_MAX_ORDERS),
         std::size_t max_levels = constants::DEFAULT_MAX_PRICE_LEVELS,
-        float load_factor = 0.5f
+        float load_factor = 0.5f,
+        const AllocationPolicy& memory_policy = {},
+        const PoolGrowth& pool_growth = {}
     )
-        : order_pool_(max_orders) {
+        : order_pool_(max_orders, memory_policy, pool_growth)
+        , order_index_(max_orders, load_factor) {
         
         // Reserve capacity to avoid reallocations
         bids_.reserve(max_levels);
         asks_.reserve(max_levels);
-        
-        // Configure hash map for performance
-        order_map_.reserve(max_orders);
-        order_map_.max_load_factor(load_factor);
     }
     
     ~OrderBook() = default;
@@ -102,6 +174,15 @@ public:
         trade_callback_ = std::move(callback);
     }
     
+    /**
+     * @brief Timestamp for the trades of the next operations
+     *
+     * The engine sets its event acceptance time so a sweep through many
+     * makers does not read the clock per fill; 0 restores per-trade clock
+     * reads.
+     */
+    void set_trade_time(Timestamp timestamp) noexcept { trade_time_ = timestamp; }
+    
     // ========================================================================
     // Order Operations
     // ========================================================================
@@ -221,16 +302,115 @@ public:
      */
     [[nodiscard]] bool has_order(OrderId order_id) const;
     
+    /**
+     * @brief Copy of a resting order (owner, side, price, remaining qty)
+     * @return Order, or nullopt if not in the book
+     */
+    [[nodiscard]] std::optional<Order> find_order(OrderId order_id) const;
+    
+    /**
+     * @brief Hash of the resting orders in matching order plus trade totals
+     *
+     * Two books that match identically from here on hash equal; used to
+     * check a journal replay against the live engine.
+     */
+    [[nodiscard]] std::uint64_t state_hash() const;
+    
+    /**
+     * @brief Memory backing of the order pool
+     */
+    [[nodiscard]] PageBacking pool_backing() const noexcept { return order_pool_.backing(); }
+    
+    /**
+     * @brief Currently installed order pool capacity
+     */
+    [[nodiscard]] std::size_t order_capacity() const;
+    
+    /**
+     * @brief Number of times the pool grew inline on the matching path
+     */
+    [[nodiscard]] std::uint32_t pool_inline_grows() const;
+    
+    /**
+     * @brief Memory footprint, high-water marks and container behaviour
+     *
+     * Walks the order index to measure probe lengths, so this is meant for
+     * sizing and diagnostics, not the hot path.
+     */
+    [[nodiscard]] BookMemoryStats memory_stats() const;
+    
+    /**
+     * @brief Fault in the order pool and index up front
+     *
+     * Storage is otherwise touched lazily as orders arrive, which keeps
+     * construction cheap but moves page faults onto the first orders.
+     */
+    void prefault();
+    
+    /**
+     * @brief Grow the order pool if free slots are below the low watermark
+     *
+     * The segment is allocated and initialized without holding the book
+     * mutex; only the freelist splice happens under the lock. Call from a
+     * housekeeping thread or when the matching loop is idle.
+     *
+     * @return true if a segment was installed
+     */
+    bool maintain();
+    
     /**
      * @brief Clear all orders
+     *
+     * Pool and index are reset by bumping their generations, so the cost is
+     * independent of max_orders (O(levels) for the level vectors).
      */
     void clear();
+    
+    // ========================================================================
+    // Snapshots
+    // ========================================================================
+    
+    /**
+     * @brief Write a binary image of all levels and resting orders
+     *
+     * Written to a temporary file, fsynced and renamed into place, so a
+     * crash never leaves a truncated snapshot at path.
+     */
+    SnapshotResult save_snapshot(const std::string& path) const;
+    
+    /**
+     * @brief Serialize the book into an in-memory snapshot image
+     * @param image Overwritten; its capacity is reused, so a caller that
+     *        keeps the buffer pays one copy of the book and no allocation
+     */
+    void capture_snapshot(std::vector<std::byte>& image) const;
+    
+    /**
+     * @brief Replace the book's contents with a snapshot
+     *
+     * Maps the file and bulk-loads levels and orders in priority order: no
+     * matching, no per-level searches. Header and file size are checked
+     * before the book is touched; a bad record found while loading (empty
+     * order, non-positive price, level counts that disagree with the
+     * header, a crossed book) leaves the book empty.
+     */
+    SnapshotResult load_snapshot(const std::string& path);
+    
+    /**
+     * @brief Replace the book's contents with an in-memory snapshot image
+     */
+    SnapshotResult load_snapshot(std::span<const std::byte> image);
 
 private:
     // ========================================================================
     // Internal Methods (must hold mutex)
     // ========================================================================
     
+    /**
+     * @brief Internal clear without locking (caller must hold mutex_)
+     */
+    void clear_internal();
+    
     /**
      * @brief Internal add_limit without locking (caller must hold mutex_)
      */
@@ -284,6 +464,23 @@ private:
         bool is_bid
     );
     
+    /**
+     * @brief Insert a level before it, recording shift/reallocation stats
+     */
+    std::vector<PriceLevel>::iterator insert_level(
+        std::vector<PriceLevel>& levels,
+        std::vector<PriceLevel>::iterator it,
+        Price price
+    );
+    
+    /**
+     * @brief Erase a level, recording shift stats
+     */
+    std::vector<PriceLevel>::iterator erase_level(
+        std::vector<PriceLevel>& levels,
+        std::vector<PriceLevel>::iterator it
+    );
+    
     /**
      * @brief Remove empty price level
      */
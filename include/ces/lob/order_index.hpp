@@ -0,0 +1,260 @@
+#pragma once
+/**
+ * @file order_index.hpp
+ * @brief Flat open-addressing map from order ID to pool index
+ *
+ * Replaces std::unordered_map on the order path: one contiguous slot array,
+ * linear probing and backward-shift deletion, so lookups never chase node
+ * pointers and inserts never allocate (outside of a rare resize).
+ * Slots carry a generation tag so clear() is O(1). The slot array comes
+ * from calloc: an all-zero slot is empty, so large tables are faulted in
+ * lazily by the OS instead of being written at construction.
+ */
+
+#include <ces/common/types.hpp>
+#include <ces/common/macros.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace ces {
+
+/**
+ * @brief Open-addressing hash index: order_id -> pool index
+ *
+ * Thread Safety: NOT thread-safe. Owned and locked by OrderBook.
+ */
+class OrderIndex {
+public:
+    /// Returned when a key is absent
+    static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+private:
+    /// Tag of an empty slot (generations start at 1)
+    static constexpr std::uint32_t EMPTY_TAG = 0;
+
+    struct Slot {
+        std::uint64_t key{0};
+        std::uint32_t value{INVALID_INDEX};
+        std::uint32_t tag{EMPTY_TAG};  // Occupied iff tag == generation_
+    };
+
+    struct FreeDeleter {
+        void operator()(Slot* p) const noexcept { std::free(p); }
+    };
+
+    std::unique_ptr<Slot[], FreeDeleter> slots_;
+    std::size_t slot_count_{0};
+    std::uint32_t generation_{1};
+    std::uint64_t mask_{0};
+    std::uint32_t shift_{64};
+    std::size_t size_{0};
+    std::size_t peak_size_{0};
+    std::size_t max_size_{0};   // Resize threshold
+    float max_load_factor_;
+
+public:
+    /**
+     * @brief Construct index sized for expected entries
+     * @param expected Expected number of live entries
+     * @param max_load_factor Load factor that triggers a resize (lower = shorter probes)
+     */
+    explicit OrderIndex(std::size_t expected = 0, float max_load_factor = 0.5f)
+        : max_load_factor_(max_load_factor > 0.05f && max_load_factor < 0.95f
+              ? max_load_factor : 0.5f) {
+        rehash(slots_for(expected));
+    }
+
+    /**
+     * @brief Look up pool index for order_id
+     * @return Pool index, or INVALID_INDEX if absent
+     */
+    [[nodiscard]] CES_FORCE_INLINE std::uint32_t find(std::uint64_t key) const noexcept {
+        for (std::uint64_t pos = home(key); ; pos = (pos + 1) & mask_) {
+            const Slot& slot = slots_[pos];
+            if (slot.tag != generation_) return INVALID_INDEX;
+            if (slot.key == key) return slot.value;
+        }
+    }
+
+    [[nodiscard]] bool contains(std::uint64_t key) const noexcept {
+        return find(key) != INVALID_INDEX;
+    }
+
+    /**
+     * @brief Insert key -> value
+     * @return false if key already present (value unchanged)
+     */
+    bool insert(std::uint64_t key, std::uint32_t value) {
+        if CES_UNLIKELY(size_ >= max_size_) {
+            rehash(slot_count_ * 2);
+        }
+
+        std::uint64_t pos = home(key);
+        for (; occupied(pos); pos = (pos + 1) & mask_) {
+            if (slots_[pos].key == key) return false;
+        }
+        slots_[pos] = Slot{key, value, generation_};
+        if (++size_ > peak_size_) {
+            peak_size_ = size_;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Remove key
+     * @return true if key was present
+     */
+    bool erase(std::uint64_t key) noexcept {
+        std::uint64_t pos = home(key);
+        for (;; pos = (pos + 1) & mask_) {
+            if (!occupied(pos)) return false;
+            if (slots_[pos].key == key) break;
+        }
+
+        // Backward-shift deletion: pull later members of the cluster into the hole
+        std::uint64_t hole = pos;
+        for (std::uint64_t next = (hole + 1) & mask_; occupied(next);
+             next = (next + 1) & mask_) {
+            const std::uint64_t ideal = home(slots_[next].key);
+            // Entry may move to hole only if hole lies cyclically in [ideal, next)
+            if (((next - ideal) & mask_) >= ((next - hole) & mask_)) {
+                slots_[hole] = slots_[next];
+                hole = next;
+            }
+        }
+        slots_[hole].tag = EMPTY_TAG;
+        --size_;
+        return true;
+    }
+
+    /**
+     * @brief Hint the cache to fetch the home slot of key
+     */
+    CES_FORCE_INLINE void prefetch(std::uint64_t key) const noexcept {
+        CES_PREFETCH_WRITE(&slots_[home(key)]);
+    }
+
+    /**
+     * @brief Ensure capacity for expected entries without resizing later
+     */
+    void reserve(std::size_t expected) {
+        const std::size_t needed = slots_for(expected);
+        if (needed > slot_count_) {
+            rehash(needed);
+        }
+    }
+
+    /**
+     * @brief Fault in the whole slot array now instead of on first use
+     */
+    void prefault() noexcept {
+        constexpr std::size_t PAGE = 4096;
+        auto* bytes = reinterpret_cast<volatile unsigned char*>(slots_.get());
+        const std::size_t total = slot_count_ * sizeof(Slot);
+        for (std::size_t offset = 0; offset < total; offset += PAGE) {
+            bytes[offset] = bytes[offset];
+        }
+    }
+
+    /**
+     * @brief Remove all entries in O(1) (keeps capacity)
+     */
+    void clear() noexcept {
+        // Every existing tag becomes stale; on wrap, stale tags could alias
+        if CES_UNLIKELY(++generation_ == EMPTY_TAG) {
+            for (std::size_t i = 0; i < slot_count_; ++i) {
+                slots_[i].tag = EMPTY_TAG;
+            }
+            generation_ = EMPTY_TAG + 1;
+        }
+        size_ = 0;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] std::size_t slot_count() const noexcept { return slot_count_; }
+    [[nodiscard]] float load_factor() const noexcept {
+        return static_cast<float>(size_) / static_cast<float>(slot_count_);
+    }
+    [[nodiscard]] float max_load_factor() const noexcept { return max_load_factor_; }
+    [[nodiscard]] std::size_t peak_size() const noexcept { return peak_size_; }
+    [[nodiscard]] static constexpr std::size_t slot_bytes() noexcept { return sizeof(Slot); }
+
+    /**
+     * @brief Probe length statistics over live entries
+     */
+    struct ProbeStats {
+        double mean{0.0};       // Average slots inspected by a successful lookup
+        std::uint32_t max{0};   // Longest probe sequence
+    };
+
+    /**
+     * @brief Measure probe lengths (O(slot_count), for diagnostics only)
+     */
+    [[nodiscard]] ProbeStats probe_stats() const noexcept {
+        ProbeStats stats;
+        std::uint64_t total = 0;
+        for (std::size_t pos = 0; pos < slot_count_; ++pos) {
+            if (!occupied(pos)) continue;
+            const auto length = static_cast<std::uint32_t>(((pos - home(slots_[pos].key)) & mask_) + 1);
+            total += length;
+            stats.max = std::max(stats.max, length);
+        }
+        if (size_ > 0) {
+            stats.mean = static_cast<double>(total) / static_cast<double>(size_);
+        }
+        return stats;
+    }
+
+private:
+    [[nodiscard]] CES_FORCE_INLINE bool occupied(std::uint64_t pos) const noexcept {
+        return slots_[pos].tag == generation_;
+    }
+
+    [[nodiscard]] CES_FORCE_INLINE std::uint64_t home(std::uint64_t key) const noexcept {
+        // Fibonacci hashing: sequential IDs spread across the table
+        return (key * 0x9E3779B97F4A7C15ULL) >> shift_;
+    }
+
+    [[nodiscard]] std::size_t slots_for(std::size_t expected) const noexcept {
+        const auto wanted = static_cast<std::size_t>(static_cast<double>(expected) / max_load_factor_) + 1;
+        return std::bit_ceil(std::max<std::size_t>(wanted, 16));
+    }
+
+    void rehash(std::size_t slot_count) {
+        // Zeroed memory is a table of empty slots (EMPTY_TAG == 0)
+        auto* fresh = static_cast<Slot*>(std::calloc(slot_count, sizeof(Slot)));
+        if (fresh == nullptr) {
+            throw std::bad_alloc();
+        }
+        std::unique_ptr<Slot[], FreeDeleter> old(fresh);
+        std::swap(old, slots_);
+        const std::size_t old_count = std::exchange(slot_count_, slot_count);
+        
+        mask_ = slot_count - 1;
+        shift_ = static_cast<std::uint32_t>(64 - std::countr_zero(slot_count));
+        max_size_ = static_cast<std::size_t>(static_cast<double>(slot_count) * max_load_factor_);
+        size_ = 0;
+
+        for (std::size_t i = 0; i < old_count; ++i) {
+            const Slot& slot = old[i];
+            if (slot.tag == generation_) {
+                std::uint64_t pos = home(slot.key);
+                while (occupied(pos)) {
+                    pos = (pos + 1) & mask_;
+                }
+                slots_[pos] = slot;
+                ++size_;
+            }
+        }
+    }
+};
+
+} // namespace ces
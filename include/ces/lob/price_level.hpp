@@ -69,6 +69,10 @@ struct PriceLevel {
         CES_ASSERT(pool.is_valid(order_idx));
         Order& order = pool[order_idx];
         
+        // Issue both neighbour fetches before either write so the misses overlap
+        pool.prefetch(order.prev_idx);
+        pool.prefetch(order.next_idx);
+        
         // Update prev link
         if (order.prev_idx != INVALID_POOL_INDEX) {
             pool[order.prev_idx].next_idx = order.next_idx;
@@ -112,6 +116,22 @@ struct PriceLevel {
         return &pool[head_idx];
     }
     
+    /**
+     * @brief Prefetch the two orders queued behind order
+     *
+     * Called while order is being filled: its successor was usually
+     * prefetched one fill earlier, so reading its next_idx is cheap and the
+     * chain is fetched two makers ahead instead of one dependent miss per fill.
+     */
+    static void prefetch_successors(const ObjectPool<Order>& pool, const Order& order) noexcept {
+        const std::uint32_t next = order.next_idx;
+        if (next == INVALID_POOL_INDEX) {
+            return;
+        }
+        pool.prefetch(next);
+        pool.prefetch(pool[next].next_idx);
+    }
+    
     /**
      * @brief Get front order index
      */
@@ -0,0 +1,54 @@
+#pragma once
+/**
+ * @file mapped_file.hpp
+ * @brief Read-only memory-mapped file
+ *
+ * Used to bulk-load binary images (book snapshots) without copying them
+ * through stream buffers. Falls back to reading into a heap buffer on
+ * platforms without mmap.
+ */
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ces {
+
+/**
+ * @brief RAII read-only view of a whole file
+ *
+ * Thread Safety: immutable after construction; safe to read concurrently.
+ */
+class MappedFile {
+private:
+    const std::byte* data_{nullptr};
+    std::size_t size_{0};
+    bool mapped_{false};
+    std::vector<std::byte> fallback_;  // Used when mmap is unavailable
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // Non-copyable, movable
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Map an existing file read-only
+     * @return Mapped file, or nullopt if it cannot be opened or mapped
+     */
+    [[nodiscard]] static std::optional<MappedFile> open_read(const std::string& path) noexcept;
+
+    [[nodiscard]] const std::byte* data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+private:
+    void release() noexcept;
+};
+
+} // namespace ces
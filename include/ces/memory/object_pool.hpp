@@ -1,9 +1,13 @@
 #pragma once
 /**
  * @file object_pool.hpp
- * @brief Fixed-capacity object pool with O(1) allocate/free using freelist indices
- * 
- * No heap allocation after construction. Uses intrusive freelist for O(1) operations.
+ * @brief Segmented object pool with O(1) allocate/free using freelist indices
+ *
+ * Storage grows in fixed-size segments, so indices stay stable for the
+ * lifetime of an object. Slots are handed out by a bump pointer first and
+ * recycled through an intrusive freelist; a pool-wide generation makes
+ * clear() O(1) for trivially destructible types.
+ * Storage is obtained through an AllocationPolicy (heap or huge pages).
  */
 
 // Prevent Windows min/max macros from conflicting with std::numeric_limits
@@ -16,24 +20,66 @@
 #include <ces/common/types.hpp>
 #include <ces/common/macros.hpp>
 #include <ces/common/concepts.hpp>
+#include <ces/memory/page_allocator.hpp>
 
+#include <algorithm>
 #include <memory>
 #include <cstdint>
+#include <limits>
 #include <new>
+#include <type_traits>
+#include <vector>
 
 namespace ces {
 
 /**
- * @brief Fixed-capacity object pool with freelist-based allocation
- * 
+ * @brief Growth parameters for a segmented ObjectPool
+ */
+struct PoolGrowth {
+    /// Default segment size: 64K entries
+    static constexpr std::uint32_t DEFAULT_SEGMENT_SHIFT = 16;
+
+    std::uint32_t segment_shift{DEFAULT_SEGMENT_SHIFT};  // Entries per segment = 1 << shift
+    std::uint32_t max_capacity{std::numeric_limits<std::uint32_t>::max()};  // Growth cap
+    std::uint32_t low_watermark{0};  // Free slots that trigger growth (0 = 1/8 segment)
+
+    /**
+     * @brief Growth disabled: the pool stays at its initial capacity
+     */
+    [[nodiscard]] static constexpr PoolGrowth fixed() noexcept {
+        return PoolGrowth{.segment_shift = DEFAULT_SEGMENT_SHIFT, .max_capacity = 0, .low_watermark = 0};
+    }
+};
+
+/**
+ * @brief Segmented object pool with freelist-based allocation
+ *
  * @tparam T Type of objects to store (must be Poolable)
- * 
+ *
  * Thread Safety: NOT thread-safe. External synchronization required.
- * 
+ * prepare_segment() is the exception: it only allocates memory and may run
+ * on any thread, so the expensive part of growth stays off the hot path.
+ *
  * Memory Layout:
- * - Objects stored contiguously in array (allocated at construction)
+ * - Objects stored in fixed-size segments of (1 << segment_shift) entries
+ * - Index = (segment << shift) | offset; lookup is one shift and one mask
+ * - Segments backed by PageAllocation (optionally huge pages, prefaulted, mlock'ed)
+ * - Never-used slots are taken from a bump pointer, freed ones from a freelist
+ * - Entries are constructed on first use, so untouched capacity is never
+ *   faulted in; prefault() pays that cost up front instead
  * - Freelist uses indices, not pointers, for cache efficiency
- * - No dynamic allocation after construction
+ * - Segments are never moved or freed before destruction (stable indices)
+ *
+ * Reset:
+ * - A slot is live iff its tag equals the pool generation; clear() bumps the
+ *   generation and rewinds the bump pointer, so no slot is touched (objects
+ *   with non-trivial destructors are still destroyed, O(slots used))
+ *
+ * Growth:
+ * - needs_growth() reports when free slots drop below the low watermark;
+ *   the owner then calls prepare_segment() + install_segment() off the hot path
+ * - If the pool is exhausted anyway, allocate() grows inline as a fallback
+ *   instead of rejecting, up to max_capacity
  */
 template<Poolable T>
 class ObjectPool {
@@ -42,182 +88,421 @@ public:
     static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
 
 private:
+    /// Tag of a slot that holds no object (generations start at 1)
+    static constexpr std::uint32_t FREE_TAG = 0;
+
     /// Storage entry: either holds an object or a freelist link
     struct Entry {
         alignas(T) unsigned char storage[sizeof(T)];
         std::uint32_t next_free{INVALID_INDEX};
-        bool in_use{false};
-        
+        std::uint32_t tag{FREE_TAG};  // Pool generation while live
+
         Entry() noexcept = default;
-        ~Entry() {
-            if (in_use) {
-                reinterpret_cast<T*>(storage)->~T();
-            }
-        }
-        
+        ~Entry() = default;  // Live objects are destroyed by the pool
+
         // Non-copyable, non-movable
         Entry(const Entry&) = delete;
         Entry& operator=(const Entry&) = delete;
         Entry(Entry&&) = delete;
         Entry& operator=(Entry&&) = delete;
-        
+
         T* get_object() noexcept { return reinterpret_cast<T*>(storage); }
         const T* get_object() const noexcept { return reinterpret_cast<const T*>(storage); }
     };
-    
-    std::unique_ptr<Entry[]> storage_;
+
+public:
+    /**
+     * @brief A segment allocated ahead of installation
+     *
+     * Raw memory; entries are constructed when the bump pointer first
+     * reaches them.
+     */
+    class Segment {
+        friend class ObjectPool;
+
+        PageAllocation memory_;
+
+    public:
+        Segment() = default;
+        [[nodiscard]] bool empty() const noexcept { return memory_.data() == nullptr; }
+    };
+
+private:
+    std::vector<Entry*> segments_;            // Lookup table: segment -> entries
+    std::vector<PageAllocation> segment_memory_;
+    AllocationPolicy policy_;
+
+    std::uint32_t shift_;
+    std::uint32_t mask_;
+    std::uint32_t max_capacity_;
+    std::uint32_t low_watermark_;
+
     std::uint32_t free_head_{INVALID_INDEX};
+    std::uint32_t bump_{0};          // First never-used slot this generation
+    std::uint32_t initialized_{0};   // Entries constructed so far (all-time high-water)
+    std::uint32_t generation_{1};
     std::uint32_t capacity_{0};
     std::uint32_t size_{0};
+    std::uint32_t peak_size_{0};
+    std::uint32_t inline_grows_{0};
 
 public:
     /**
-     * @brief Construct pool with given capacity
-     * @param capacity Maximum number of objects (fixed, no growth)
+     * @brief Construct pool with given initial capacity
+     * @param capacity Initial capacity (rounded up to whole segments)
+     * @param policy Storage allocation policy (heap by default)
+     * @param growth Segment size, growth cap and low watermark
      */
-    explicit ObjectPool(std::uint32_t capacity) 
-        : storage_(std::make_unique<Entry[]>(capacity))
-        , capacity_(capacity) {
-        
-        // Build freelist
-        for (std::uint32_t i = 0; i < capacity; ++i) {
-            storage_[i].next_free = (i + 1 < capacity) ? (i + 1) : INVALID_INDEX;
+    explicit ObjectPool(
+        std::uint32_t capacity,
+        const AllocationPolicy& policy = {},
+        const PoolGrowth& growth = {}
+    )
+        : policy_(policy)
+        , shift_(growth.segment_shift)
+        , mask_((std::uint32_t{1} << growth.segment_shift) - 1)
+        , low_watermark_(growth.low_watermark != 0
+              ? growth.low_watermark
+              : std::max<std::uint32_t>(1, segment_size() / 8)) {
+
+        CES_ASSERT(growth.segment_shift > 0 && growth.segment_shift < 32);
+
+        // Keep the last segment out of the index space so INVALID_INDEX is never valid
+        const std::uint64_t index_space = (std::uint64_t{1} << 32) - segment_size();
+        const std::uint64_t requested = std::max<std::uint64_t>(capacity, growth.max_capacity);
+        max_capacity_ = static_cast<std::uint32_t>(
+            std::min(round_to_segments(requested), index_space));
+
+        while (capacity_ < capacity && capacity_ < max_capacity_) {
+            install_segment(prepare_segment());
+        }
+    }
+
+    ~ObjectPool() {
+        destroy_live();
+        for (std::uint32_t i = 0; i < initialized_; ++i) {
+            entry_at(i).~Entry();
         }
-        
-        free_head_ = (capacity > 0) ? 0 : INVALID_INDEX;
     }
-    
-    ~ObjectPool() = default;
-    
+
     // Non-copyable, non-movable
     ObjectPool(const ObjectPool&) = delete;
     ObjectPool& operator=(const ObjectPool&) = delete;
     ObjectPool(ObjectPool&&) = delete;
     ObjectPool& operator=(ObjectPool&&) = delete;
-    
+
     /**
      * @brief Allocate an object from the pool
      * @tparam Args Constructor argument types
      * @param args Arguments forwarded to T's constructor
      * @return Index of allocated object, or INVALID_INDEX if pool exhausted
+     *         and already at max capacity
      */
     template<typename... Args>
     [[nodiscard]] std::uint32_t allocate(Args&&... args) noexcept(
         std::is_nothrow_constructible_v<T, Args...>
     ) {
-        if (free_head_ == INVALID_INDEX) [[unlikely]] {
-            return INVALID_INDEX;  // Pool exhausted
-        }
-        
         std::uint32_t idx = free_head_;
-        Entry& entry = storage_[idx];
-        
-        // Remove from freelist
-        free_head_ = entry.next_free;
-        
+        if (idx != INVALID_INDEX) {
+            // Reuse a freed slot
+            free_head_ = entry_at(idx).next_free;
+        } else {
+            if CES_UNLIKELY(bump_ == capacity_ && !grow_inline()) {
+                return INVALID_INDEX;  // Pool exhausted
+            }
+            idx = bump_++;
+            if (idx == initialized_) {
+                // First touch of this slot
+                new (&entry_at(idx)) Entry();
+                ++initialized_;
+            }
+        }
+
+        Entry& entry = entry_at(idx);
+
         // Construct object in-place
         new (entry.storage) T(std::forward<Args>(args)...);
-        entry.in_use = true;
-        ++size_;
-        
+        entry.tag = generation_;
+        if (++size_ > peak_size_) {
+            peak_size_ = size_;
+        }
+
         return idx;
     }
-    
+
     /**
      * @brief Deallocate an object and return it to the pool
      * @param index Index of object to deallocate
      */
     void deallocate(std::uint32_t index) noexcept {
-        CES_ASSERT(index < capacity_);
-        CES_ASSERT(storage_[index].in_use);
-        
-        Entry& entry = storage_[index];
-        
+        CES_ASSERT(is_valid(index));
+
+        Entry& entry = entry_at(index);
+
         // Destroy object
         entry.get_object()->~T();
-        entry.in_use = false;
-        
+        entry.tag = FREE_TAG;
+
         // Add to freelist head
         entry.next_free = free_head_;
         free_head_ = index;
         --size_;
     }
-    
+
     /**
      * @brief Access object at index (unchecked in release)
      */
     [[nodiscard]] CES_FORCE_INLINE T& operator[](std::uint32_t index) noexcept {
-        CES_ASSERT(index < capacity_);
-        CES_ASSERT(storage_[index].in_use);
-        return *storage_[index].get_object();
+        CES_ASSERT(is_valid(index));
+        return *entry_at(index).get_object();
     }
-    
+
     [[nodiscard]] CES_FORCE_INLINE const T& operator[](std::uint32_t index) const noexcept {
-        CES_ASSERT(index < capacity_);
-        CES_ASSERT(storage_[index].in_use);
-        return *storage_[index].get_object();
+        CES_ASSERT(is_valid(index));
+        return *entry_at(index).get_object();
     }
-    
+
     /**
      * @brief Get pointer to object at index
      * @param index Object index
      * @return Pointer to object, or nullptr if not in use
      */
     [[nodiscard]] T* get(std::uint32_t index) noexcept {
-        if (index >= capacity_ || !storage_[index].in_use) {
+        if (!is_valid(index)) {
             return nullptr;
         }
-        return storage_[index].get_object();
+        return entry_at(index).get_object();
     }
-    
+
     [[nodiscard]] const T* get(std::uint32_t index) const noexcept {
-        if (index >= capacity_ || !storage_[index].in_use) {
+        if (!is_valid(index)) {
             return nullptr;
         }
-        return storage_[index].get_object();
+        return entry_at(index).get_object();
     }
-    
+
+    /**
+     * @brief Hint the cache to fetch the entry at index ahead of a write
+     *
+     * No-op for INVALID_INDEX or out-of-range indices, so list successors
+     * can be passed without checking.
+     */
+    CES_FORCE_INLINE void prefetch(std::uint32_t index) const noexcept {
+        if (index < capacity_) {
+            CES_PREFETCH_WRITE(&segments_[index >> shift_][index & mask_]);
+        }
+    }
+
     /**
      * @brief Check if index is valid and in use
      */
     [[nodiscard]] bool is_valid(std::uint32_t index) const noexcept {
-        return index < capacity_ && storage_[index].in_use;
+        return index < bump_ && entry_at(index).tag == generation_;
+    }
+
+    // ========================================================================
+    // Growth
+    // ========================================================================
+
+    /**
+     * @brief Whether free slots have dropped below the low watermark
+     */
+    [[nodiscard]] bool needs_growth() const noexcept {
+        return capacity_ - size_ < low_watermark_ && capacity_ < max_capacity_;
+    }
+
+    /**
+     * @brief Reserve memory for the next segment without touching pool state
+     *
+     * Entries are left unconstructed (and, unless the policy prefaults,
+     * unfaulted). Safe to call without holding the pool's external lock.
+     */
+    [[nodiscard]] Segment prepare_segment() const {
+        Segment segment;
+        segment.memory_ = PageAllocation(sizeof(Entry) * segment_size(), policy_);
+        return segment;
+    }
+
+    /**
+     * @brief Fault in every installed segment now instead of on first use
+     */
+    void prefault() noexcept {
+        for (auto& memory : segment_memory_) {
+            memory.prefault();
+        }
     }
-    
+
+    /**
+     * @brief Install a prepared segment at the end of the index space
+     * @return true if installed, false if the pool is already at max capacity
+     */
+    bool install_segment(Segment&& segment) {
+        if (segment.empty() || capacity_ >= max_capacity_) {
+            return false;
+        }
+
+        Entry* entries = static_cast<Entry*>(segment.memory_.data());
+        segments_.push_back(entries);
+        segment_memory_.push_back(std::move(segment.memory_));
+        capacity_ += segment_size();
+        return true;
+    }
+
+    // ========================================================================
+    // Queries
+    // ========================================================================
+
     /**
      * @brief Current number of allocated objects
      */
     [[nodiscard]] std::uint32_t size() const noexcept { return size_; }
-    
+
     /**
-     * @brief Maximum capacity
+     * @brief Currently installed capacity (whole segments)
      */
     [[nodiscard]] std::uint32_t capacity() const noexcept { return capacity_; }
-    
+
+    /**
+     * @brief Capacity the pool may grow to
+     */
+    [[nodiscard]] std::uint32_t max_capacity() const noexcept { return max_capacity_; }
+
+    /**
+     * @brief Entries per segment
+     */
+    [[nodiscard]] std::uint32_t segment_size() const noexcept { return mask_ + 1; }
+
+    /**
+     * @brief Number of installed segments
+     */
+    [[nodiscard]] std::size_t segment_count() const noexcept { return segments_.size(); }
+
+    /**
+     * @brief Times allocate() had to grow inline because growth was not serviced in time
+     */
+    [[nodiscard]] std::uint32_t inline_grows() const noexcept { return inline_grows_; }
+
+    /**
+     * @brief Memory backing actually obtained for the storage (first segment)
+     */
+    [[nodiscard]] PageBacking backing() const noexcept {
+        return segment_memory_.empty() ? PageBacking::Heap : segment_memory_.front().backing();
+    }
+
+    /**
+     * @brief Whether every segment is mlock'ed
+     */
+    [[nodiscard]] bool locked() const noexcept {
+        for (const auto& memory : segment_memory_) {
+            if (!memory.locked()) return false;
+        }
+        return !segment_memory_.empty();
+    }
+
+    /**
+     * @brief Highest number of live objects since construction
+     */
+    [[nodiscard]] std::uint32_t peak_size() const noexcept { return peak_size_; }
+
+    /**
+     * @brief Entries ever constructed (faulted in by use)
+     */
+    [[nodiscard]] std::uint32_t slots_initialized() const noexcept { return initialized_; }
+
+    /**
+     * @brief Bytes per slot, including freelist link and tag
+     */
+    [[nodiscard]] static constexpr std::size_t slot_bytes() noexcept { return sizeof(Entry); }
+
+    /**
+     * @brief Bytes reserved for all installed segments
+     */
+    [[nodiscard]] std::size_t reserved_bytes() const noexcept {
+        std::size_t total = 0;
+        for (const auto& memory : segment_memory_) {
+            total += memory.reserved_bytes();
+        }
+        return total;
+    }
+
     /**
-     * @brief Check if pool is full
+     * @brief Number of slots handed out since the last clear (high-water mark)
      */
-    [[nodiscard]] bool full() const noexcept { return free_head_ == INVALID_INDEX; }
-    
+    [[nodiscard]] std::uint32_t slots_used() const noexcept { return bump_; }
+
+    /**
+     * @brief Check if pool has no free slot without growing
+     */
+    [[nodiscard]] bool full() const noexcept {
+        return free_head_ == INVALID_INDEX && bump_ == capacity_;
+    }
+
     /**
      * @brief Check if pool is empty
      */
     [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
-    
+
     /**
-     * @brief Clear all objects from pool
+     * @brief Clear all objects from pool (installed segments are kept)
+     *
+     * O(1) for trivially destructible T; otherwise O(slots used).
      */
     void clear() noexcept {
-        for (std::uint32_t i = 0; i < capacity_; ++i) {
-            if (storage_[i].in_use) {
-                storage_[i].get_object()->~T();
-                storage_[i].in_use = false;
+        destroy_live();
+
+        // Every existing tag becomes stale; on wrap, stale tags could alias
+        if CES_UNLIKELY(++generation_ == FREE_TAG) {
+            for (std::uint32_t i = 0; i < initialized_; ++i) {
+                entry_at(i).tag = FREE_TAG;
             }
-            storage_[i].next_free = (i + 1 < capacity_) ? (i + 1) : INVALID_INDEX;
+            generation_ = FREE_TAG + 1;
         }
-        free_head_ = (capacity_ > 0) ? 0 : INVALID_INDEX;
+
+        free_head_ = INVALID_INDEX;
+        bump_ = 0;
         size_ = 0;
     }
+
+private:
+    [[nodiscard]] CES_FORCE_INLINE Entry& entry_at(std::uint32_t index) noexcept {
+        return segments_[index >> shift_][index & mask_];
+    }
+
+    [[nodiscard]] CES_FORCE_INLINE const Entry& entry_at(std::uint32_t index) const noexcept {
+        return segments_[index >> shift_][index & mask_];
+    }
+
+    [[nodiscard]] std::uint64_t round_to_segments(std::uint64_t count) const noexcept {
+        const std::uint64_t seg = segment_size();
+        return (count + seg - 1) / seg * seg;
+    }
+
+    void destroy_live() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (std::uint32_t i = 0; i < bump_; ++i) {
+                Entry& entry = entry_at(i);
+                if (entry.tag == generation_) {
+                    entry.get_object()->~T();
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Fallback growth when no slot is left (cold path)
+     */
+    CES_NOINLINE bool grow_inline() noexcept {
+        if (capacity_ >= max_capacity_) {
+            return false;
+        }
+        try {
+            install_segment(prepare_segment());
+        } catch (...) {
+            return false;
+        }
+        ++inline_grows_;
+        return bump_ < capacity_;
+    }
 };
 
 } // namespace ces
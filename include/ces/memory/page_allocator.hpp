@@ -0,0 +1,113 @@
+#pragma once
+/**
+ * @file page_allocator.hpp
+ * @brief Page-level allocation policy for large preallocated containers
+ *
+ * Large pools and queues span thousands of 4K pages, so random access into
+ * them takes TLB misses. PageAllocation backs such storage with 2MB huge
+ * pages where the platform allows, optionally prefaulted and mlock'ed.
+ */
+
+#include <ces/common/macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ces {
+
+/**
+ * @brief Memory actually backing an allocation
+ */
+enum class PageBacking : std::uint8_t {
+    Heap = 0,             // Aligned operator new
+    HugeTlb = 1,          // mmap(MAP_HUGETLB) from the reserved hugetlbfs pool
+    TransparentHuge = 2,  // mmap + madvise(MADV_HUGEPAGE)
+    Regular = 3           // mmap with regular pages (huge pages unavailable)
+};
+
+[[nodiscard]] constexpr const char* to_string(PageBacking b) noexcept {
+    switch (b) {
+        case PageBacking::Heap:            return "Heap";
+        case PageBacking::HugeTlb:         return "HugeTlb";
+        case PageBacking::TransparentHuge: return "TransparentHuge";
+        case PageBacking::Regular:         return "Regular";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief How a container should obtain its storage
+ *
+ * The default (no huge pages, no prefault, no lock) is a plain heap
+ * allocation, matching the behaviour before policies existed.
+ */
+struct AllocationPolicy {
+    bool huge_pages{false};  // Try MAP_HUGETLB, fall back to MADV_HUGEPAGE
+    bool prefault{false};    // Touch every page up front
+    bool lock{false};        // mlock() the region (best effort)
+
+    [[nodiscard]] static constexpr AllocationPolicy heap() noexcept { return {}; }
+
+    [[nodiscard]] static constexpr AllocationPolicy huge(bool lock_pages = false) noexcept {
+        return AllocationPolicy{.huge_pages = true, .prefault = true, .lock = lock_pages};
+    }
+};
+
+/**
+ * @brief RAII owner of a page-aligned raw memory region
+ *
+ * Memory is uninitialized (zeroed when mmap-backed). Callers construct
+ * objects in place and must destroy them before the region is released.
+ *
+ * Thread Safety: NOT thread-safe.
+ */
+class PageAllocation {
+public:
+    /// Size of a huge page on the supported platforms (x86_64 / aarch64 default)
+    static constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    /// Size of a regular page
+    static constexpr std::size_t PAGE_SIZE = 4096;
+
+private:
+    void* data_{nullptr};
+    std::size_t size_{0};      // Bytes requested
+    std::size_t mapped_{0};    // Bytes actually reserved (rounded up)
+    PageBacking backing_{PageBacking::Heap};
+    bool locked_{false};
+
+public:
+    PageAllocation() = default;
+
+    /**
+     * @brief Allocate a region according to policy
+     * @param bytes Minimum size in bytes
+     * @param policy Allocation policy
+     * @throws std::bad_alloc if no backing could be obtained
+     */
+    PageAllocation(std::size_t bytes, const AllocationPolicy& policy);
+
+    ~PageAllocation();
+
+    // Non-copyable, movable
+    PageAllocation(const PageAllocation&) = delete;
+    PageAllocation& operator=(const PageAllocation&) = delete;
+    PageAllocation(PageAllocation&& other) noexcept;
+    PageAllocation& operator=(PageAllocation&& other) noexcept;
+
+    /**
+     * @brief Touch every page so later accesses do not fault
+     */
+    void prefault() noexcept;
+
+    [[nodiscard]] void* data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] std::size_t reserved_bytes() const noexcept { return mapped_; }
+    [[nodiscard]] PageBacking backing() const noexcept { return backing_; }
+    [[nodiscard]] bool locked() const noexcept { return locked_; }
+
+private:
+    void release() noexcept;
+};
+
+} // namespace ces
@@ -15,8 +15,10 @@
 #include <ces/common/time.hpp>
 #include <ces/common/macros.hpp>
 
+#include <array>
 #include <vector>
 #include <algorithm>
+#include <utility>
 #include <cmath>
 #include <limits>
 #include <mutex>
@@ -38,6 +40,28 @@ struct LatencyStats {
     Duration max_ns{0};
     std::size_t count{0};
     
+    /**
+     * @brief Same stats with every duration multiplied by factor
+     *
+     * For samples recorded in clock ticks (see TscClock).
+     */
+    [[nodiscard]] LatencyStats scaled(double factor) const noexcept {
+        if (factor == 1.0 || count == 0) {
+            return *this;
+        }
+        LatencyStats out = *this;
+        out.mean_ns *= factor;
+        out.median_ns *= factor;
+        out.p50_ns *= factor;
+        out.p90_ns *= factor;
+        out.p95_ns *= factor;
+        out.p99_ns *= factor;
+        out.p999_ns *= factor;
+        out.min_ns = static_cast<Duration>(static_cast<double>(min_ns) * factor);
+        out.max_ns = static_cast<Duration>(static_cast<double>(max_ns) * factor);
+        return out;
+    }
+    
     /**
      * @brief Print stats to stdout
      */
@@ -45,15 +69,11 @@ struct LatencyStats {
 };
 
 /**
- * @brief Latency histogram with preallocated buckets
- * 
- * Uses a ring buffer for samples to avoid unbounded growth.
- * Calculates percentiles on demand from stored samples.
+ * @brief Fixed-capacity ring of latency samples with running min/max/sum
+ *
+ * Not synchronized; the histograms below guard it with their mutex.
  */
-class LatencyHistogram {
-public:
-    static constexpr std::size_t DEFAULT_SAMPLE_SIZE = 100'000;
-
+class SampleRing {
 private:
     std::vector<Duration> samples_;
     std::size_t capacity_;
@@ -63,28 +83,18 @@ private:
     Duration min_{std::numeric_limits<Duration>::max()};
     Duration max_{0};
     Duration sum_{0};
-    
-    mutable std::mutex mutex_;
 
 public:
-    /**
-     * @brief Construct histogram with sample capacity
-     * @param capacity Maximum samples to store (older samples overwritten)
-     */
-    explicit LatencyHistogram(std::size_t capacity = DEFAULT_SAMPLE_SIZE)
+    explicit SampleRing(std::size_t capacity)
         : capacity_(capacity) {
         samples_.resize(capacity);
     }
     
-    /**
-     * @brief Record a latency sample
-     * @param latency_ns Latency in nanoseconds
-     */
-    void record(Duration latency_ns) noexcept {
-        std::lock_guard lock(mutex_);
-        
+    void push(Duration latency_ns) noexcept {
         samples_[write_pos_] = latency_ns;
-        write_pos_ = (write_pos_ + 1) % capacity_;
+        if (++write_pos_ == capacity_) {  // No division on the recording path
+            write_pos_ = 0;
+        }
         ++count_;
         
         min_ = std::min(min_, latency_ns);
@@ -93,12 +103,10 @@ public:
     }
     
     /**
-     * @brief Calculate statistics from recorded samples
-     * @return Latency statistics
+     * @brief Percentiles over the retained samples; count, mean, min and
+     *        max over everything pushed
      */
-    [[nodiscard]] LatencyStats compute_stats() const {
-        std::lock_guard lock(mutex_);
-        
+    [[nodiscard]] LatencyStats summarize() const {
         if (count_ == 0) {
             return {};
         }
@@ -139,11 +147,7 @@ public:
         return stats;
     }
     
-    /**
-     * @brief Clear all samples
-     */
     void clear() noexcept {
-        std::lock_guard lock(mutex_);
         write_pos_ = 0;
         count_ = 0;
         min_ = std::numeric_limits<Duration>::max();
@@ -151,12 +155,114 @@ public:
         sum_ = 0;
     }
     
+    [[nodiscard]] std::size_t count() const noexcept { return count_; }
+};
+
+/**
+ * @brief Latency histogram with preallocated buckets
+ * 
+ * Uses a ring buffer for samples to avoid unbounded growth.
+ * Calculates percentiles on demand from stored samples.
+ */
+class LatencyHistogram {
+public:
+    static constexpr std::size_t DEFAULT_SAMPLE_SIZE = 100'000;
+
+private:
+    SampleRing ring_;
+    mutable std::mutex mutex_;
+
+public:
+    /**
+     * @brief Construct histogram with sample capacity
+     * @param capacity Maximum samples to store (older samples overwritten)
+     */
+    explicit LatencyHistogram(std::size_t capacity = DEFAULT_SAMPLE_SIZE)
+        : ring_(capacity) {}
+    
+    /**
+     * @brief Record a latency sample
+     * @param latency_ns Latency in nanoseconds
+     */
+    void record(Duration latency_ns) noexcept {
+        std::lock_guard lock(mutex_);
+        ring_.push(latency_ns);
+    }
+    
+    /**
+     * @brief Calculate statistics from recorded samples
+     * @return Latency statistics
+     */
+    [[nodiscard]] LatencyStats compute_stats() const {
+        std::lock_guard lock(mutex_);
+        return ring_.summarize();
+    }
+    
+    /**
+     * @brief Clear all samples
+     */
+    void clear() noexcept {
+        std::lock_guard lock(mutex_);
+        ring_.clear();
+    }
+    
     /**
      * @brief Get sample count
      */
     [[nodiscard]] std::size_t count() const noexcept {
         std::lock_guard lock(mutex_);
-        return count_;
+        return ring_.count();
+    }
+};
+
+/**
+ * @brief One ring per stage, recorded together under a single lock
+ * @tparam Stages Number of stages an event passes through
+ *
+ * An event's stage times are one record() (one lock) rather than one per
+ * stage. Stages the event skipped are passed as SKIPPED and not counted.
+ */
+template <std::size_t Stages>
+class StageHistogram {
+public:
+    static constexpr Duration SKIPPED = -1;
+    using Sample = std::array<Duration, Stages>;
+
+private:
+    std::array<SampleRing, Stages> rings_;
+    mutable std::mutex mutex_;
+    
+    template <std::size_t... I>
+    static std::array<SampleRing, Stages> make_rings(std::size_t capacity, std::index_sequence<I...>) {
+        return {((void)I, SampleRing{capacity})...};
+    }
+
+public:
+    /**
+     * @param capacity Samples retained per stage
+     */
+    explicit StageHistogram(std::size_t capacity = LatencyHistogram::DEFAULT_SAMPLE_SIZE)
+        : rings_(make_rings(capacity, std::make_index_sequence<Stages>{})) {}
+    
+    void record(const Sample& sample) noexcept {
+        std::lock_guard lock(mutex_);
+        for (std::size_t i = 0; i < Stages; ++i) {
+            if (sample[i] != SKIPPED) {
+                rings_[i].push(sample[i]);
+            }
+        }
+    }
+    
+    [[nodiscard]] LatencyStats compute_stats(std::size_t stage) const {
+        std::lock_guard lock(mutex_);
+        return rings_[stage].summarize();
+    }
+    
+    void clear() noexcept {
+        std::lock_guard lock(mutex_);
+        for (SampleRing& ring : rings_) {
+            ring.clear();
+        }
     }
 };
 
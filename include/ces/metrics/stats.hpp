@@ -12,11 +12,50 @@
 #include <ces/common/macros.hpp>
 #include <ces/metrics/latency.hpp>
 
+#include <array>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 
 namespace ces {
 
+/**
+ * @brief Where an event spent its time on the engine thread
+ *
+ * QueueWait: enqueue to engine pickup. Risk: account lookup and pre-trade
+ * checks. Journal: journal append, its durability wait and the standby lag
+ * throttle. Matching: book update. PostTrade: counters, execution reports
+ * and checkpoints. Rejected events skip Matching; events are journaled
+ * only once accepted and only if the engine has a journal.
+ */
+enum class LatencyStage : std::uint8_t {
+    QueueWait = 0,
+    Risk = 1,
+    Journal = 2,
+    Matching = 3,
+    PostTrade = 4
+};
+
+inline constexpr std::size_t LATENCY_STAGE_COUNT = 5;
+inline constexpr std::size_t ORDER_TYPE_COUNT = 4;
+
+[[nodiscard]] constexpr const char* to_string(LatencyStage s) noexcept {
+    switch (s) {
+        case LatencyStage::QueueWait: return "QueueWait";
+        case LatencyStage::Risk:      return "Risk";
+        case LatencyStage::Journal:   return "Journal";
+        case LatencyStage::Matching:  return "Matching";
+        case LatencyStage::PostTrade: return "PostTrade";
+    }
+    return "Unknown";
+}
+
+/// One event's time per stage (StageHistogram::SKIPPED for stages it skipped)
+using StageSample = StageHistogram<LATENCY_STAGE_COUNT>::Sample;
+
+/// Stage stats indexed [OrderType][LatencyStage]
+using StageLatencyTable = std::array<std::array<LatencyStats, LATENCY_STAGE_COUNT>, ORDER_TYPE_COUNT>;
+
 /**
  * @brief Engine statistics container
  * 
@@ -39,6 +78,13 @@ struct EngineStats {
     // Latency tracking
     LatencyHistogram latency_histogram{100'000};
     
+    // Per-stage latency by OrderType; smaller rings since there are sixteen
+    static constexpr std::size_t STAGE_SAMPLE_SIZE = 16'384;
+    static_assert(ORDER_TYPE_COUNT == 4);
+    std::array<StageHistogram<LATENCY_STAGE_COUNT>, ORDER_TYPE_COUNT> stage_histograms{
+        StageHistogram<LATENCY_STAGE_COUNT>{STAGE_SAMPLE_SIZE}, StageHistogram<LATENCY_STAGE_COUNT>{STAGE_SAMPLE_SIZE},
+        StageHistogram<LATENCY_STAGE_COUNT>{STAGE_SAMPLE_SIZE}, StageHistogram<LATENCY_STAGE_COUNT>{STAGE_SAMPLE_SIZE}};
+    
     EngineStats() = default;
     
     // Non-copyable due to atomics
@@ -49,6 +95,13 @@ struct EngineStats {
     EngineStats(EngineStats&&) = default;
     EngineStats& operator=(EngineStats&&) = default;
     
+    /**
+     * @brief Set the length in ns of one recorded unit (ns per TSC tick when
+     *        the engine times with TscClock); applied when stats are read
+     */
+    void set_time_scale(double ns_per_unit) noexcept { ns_per_unit_ = ns_per_unit; }
+    [[nodiscard]] double time_scale() const noexcept { return ns_per_unit_; }
+    
     /**
      * @brief Record a latency sample
      */
@@ -56,11 +109,39 @@ struct EngineStats {
         latency_histogram.record(latency_ns);
     }
     
+    /**
+     * @brief Record an event's time in each stage (indexed by LatencyStage)
+     */
+    void record_stages(OrderType type, const StageSample& sample) {
+        stage_histograms[static_cast<std::size_t>(type)].record(sample);
+    }
+    
     /**
      * @brief Get latency statistics
      */
     [[nodiscard]] LatencyStats get_latency_stats() const {
-        return latency_histogram.compute_stats();
+        return latency_histogram.compute_stats().scaled(ns_per_unit_);
+    }
+    
+    /**
+     * @brief Get statistics for one stage of one order type
+     */
+    [[nodiscard]] LatencyStats get_stage_stats(OrderType type, LatencyStage stage) const {
+        return stage_histograms[static_cast<std::size_t>(type)]
+            .compute_stats(static_cast<std::size_t>(stage)).scaled(ns_per_unit_);
+    }
+    
+    /**
+     * @brief Get statistics for every stage of every order type
+     */
+    [[nodiscard]] StageLatencyTable get_stage_table() const {
+        StageLatencyTable table;
+        for (std::size_t t = 0; t < ORDER_TYPE_COUNT; ++t) {
+            for (std::size_t s = 0; s < LATENCY_STAGE_COUNT; ++s) {
+                table[t][s] = stage_histograms[t].compute_stats(s).scaled(ns_per_unit_);
+            }
+        }
+        return table;
     }
     
     /**
@@ -76,12 +157,18 @@ struct EngineStats {
         rejected_count.store(0, std::memory_order_relaxed);
         filled_qty.store(0, std::memory_order_relaxed);
         latency_histogram.clear();
+        for (auto& histogram : stage_histograms) {
+            histogram.clear();
+        }
     }
     
     /**
      * @brief Print summary to stdout
      */
     void print_summary() const;
+
+private:
+    double ns_per_unit_{1.0};  // Set before recording starts
 };
 
 /**
@@ -99,6 +186,7 @@ struct StatsSnapshot {
     std::uint64_t rejected_count{0};
     std::uint64_t filled_qty{0};
     LatencyStats latency;
+    StageLatencyTable stage_latency;  // [OrderType][LatencyStage]
     Timestamp timestamp{0};
     
     /**
@@ -114,7 +202,8 @@ struct StatsSnapshot {
         snap.orders_modified = stats.orders_modified.load(std::memory_order_relaxed);
         snap.rejected_count = stats.rejected_count.load(std::memory_order_relaxed);
         snap.filled_qty = stats.filled_qty.load(std::memory_order_relaxed);
-        snap.latency = stats.latency_histogram.compute_stats();
+        snap.latency = stats.get_latency_stats();
+        snap.stage_latency = stats.get_stage_table();
         snap.timestamp = now_ns();
         return snap;
     }
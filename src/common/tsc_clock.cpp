@@ -0,0 +1,117 @@
+/**
+ * @file tsc_clock.cpp
+ * @brief Invariant-TSC detection and rate calibration
+ */
+
+#include <ces/common/tsc_clock.hpp>
+
+#include <limits>
+
+#if (defined(__x86_64__) || defined(_M_X64))
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+    #define CES_HAS_TSC 1
+#else
+    #define CES_HAS_TSC 0
+#endif
+
+namespace ces {
+
+namespace {
+
+/**
+ * @brief A tick count and a reference clock reading taken together
+ */
+struct ClockPair {
+    std::uint64_t ticks{0};
+    std::int64_t ns{0};
+};
+
+/**
+ * @brief Bracket one reference read between two rdtscp, keeping the
+ *        tightest of a few attempts (an interrupt widens the bracket)
+ */
+template <typename ReadNs>
+ClockPair sample_pair(ReadNs read_ns) noexcept {
+    constexpr int ATTEMPTS = 16;
+
+    ClockPair best;
+    std::uint64_t best_width = std::numeric_limits<std::uint64_t>::max();
+    for (int i = 0; i < ATTEMPTS; ++i) {
+        const std::uint64_t before = rdtscp();
+        const std::int64_t ns = read_ns();
+        const std::uint64_t after = rdtscp();
+        if (after - before < best_width) {
+            best_width = after - before;
+            best = ClockPair{.ticks = before + (after - before) / 2, .ns = ns};
+        }
+    }
+    return best;
+}
+
+std::int64_t monotonic_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+bool TscClock::invariant_tsc() noexcept {
+#if CES_HAS_TSC
+    // CPUID.80000007H:EDX[8] = invariant TSC
+    unsigned int regs[4] = {0, 0, 0, 0};
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if (static_cast<unsigned int>(info[0]) < 0x80000007U) {
+        return false;
+    }
+    __cpuid(info, 0x80000007);
+    regs[3] = static_cast<unsigned int>(info[3]);
+#else
+    if (__get_cpuid(0x80000007U, &regs[0], &regs[1], &regs[2], &regs[3]) == 0) {
+        return false;
+    }
+#endif
+    return (regs[3] & (1U << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+std::optional<TscClock> TscClock::calibrate(std::chrono::milliseconds window) {
+    if (!invariant_tsc()) {
+        return std::nullopt;
+    }
+
+    const ClockPair start = sample_pair(monotonic_ns);
+    const std::int64_t window_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(window).count();
+    while (monotonic_ns() - start.ns < window_ns) {
+        CES_CPU_RELAX();
+    }
+    const ClockPair end = sample_pair(monotonic_ns);
+
+    // Sanity bounds: 100 MHz to 10 GHz
+    const double ticks_per_ns = static_cast<double>(end.ticks - start.ticks) /
+                                static_cast<double>(end.ns - start.ns);
+    if (!(ticks_per_ns > 0.1 && ticks_per_ns < 10.0)) {
+        return std::nullopt;
+    }
+
+    TscClock clock;
+    clock.ticks_per_ns_ = ticks_per_ns;
+    clock.ns_per_tick_ = 1.0 / ticks_per_ns;
+    clock.reanchor();
+    return clock;
+}
+
+void TscClock::reanchor() noexcept {
+    const ClockPair anchor = sample_pair([] { return static_cast<std::int64_t>(now_ns()); });
+    anchor_ticks_ = anchor.ticks;
+    anchor_ns_ = static_cast<Timestamp>(anchor.ns);
+}
+
+} // namespace ces
@@ -5,71 +5,52 @@
 
 #include <ces/engine/accounts.hpp>
 #include <ces/common/macros.hpp>
+#include <ces/common/instrument.hpp>
+#include <ces/common/state_hash.hpp>
 
 #include <algorithm>
 
 namespace ces {
 
 bool Accounts::create_account(TraderId trader_id, std::int64_t initial_balance) {
-    std::lock_guard lock(get_mutex(trader_id));
-    
-    // Check if exists
-    for (const auto& acc : accounts_) {
-        if (acc->trader_id == trader_id) {
-            return false;  // Already exists
-        }
-    }
-    
-    if (accounts_.size() >= max_traders_) {
-        return false;  // At capacity
-    }
-    
-    accounts_.push_back(std::make_unique<Account>(trader_id, initial_balance));
-    return true;
+    std::lock_guard lock(create_mutex_);
+    return create_locked(trader_id, initial_balance) != nullptr;
 }
 
 Account* Accounts::get_or_create(TraderId trader_id, std::int64_t initial_balance) {
-    // First, try to find existing (without lock for hot path)
-    for (auto& acc : accounts_) {
-        if (acc->trader_id == trader_id) {
-            return acc.get();
-        }
+    // Hot path: already exists
+    if CES_LIKELY(Account* acc = lookup(trader_id)) {
+        return acc;
     }
     
-    // Need to create - take lock
-    std::lock_guard lock(get_mutex(trader_id));
+    std::lock_guard lock(create_mutex_);
     
     // Double-check after acquiring lock
-    for (auto& acc : accounts_) {
-        if (acc->trader_id == trader_id) {
-            return acc.get();
-        }
-    }
-    
-    if (accounts_.size() >= max_traders_) {
-        return nullptr;
+    if (Account* acc = lookup(trader_id)) {
+        return acc;
     }
-    
-    accounts_.push_back(std::make_unique<Account>(trader_id, initial_balance));
-    return accounts_.back().get();
+    return create_locked(trader_id, initial_balance);
 }
 
-Account* Accounts::get(TraderId trader_id) {
-    for (auto& acc : accounts_) {
-        if (acc->trader_id == trader_id) {
-            return acc.get();
-        }
+Account* Accounts::create_locked(TraderId trader_id, std::int64_t initial_balance) {
+    if (lookup(trader_id) != nullptr || accounts_.size() >= max_traders_) {
+        return nullptr;  // Already exists or at capacity
     }
-    return nullptr;
-}
-
-const Account* Accounts::get(TraderId trader_id) const {
-    for (const auto& acc : accounts_) {
-        if (acc->trader_id == trader_id) {
-            return acc.get();
-        }
+    
+    const auto id = static_cast<std::size_t>(trader_id.get());
+    std::atomic<Page*>& entry = directory_[id >> PAGE_BITS];
+    Page* page = entry.load(std::memory_order_relaxed);
+    if (page == nullptr) {
+        pages_.push_back(std::make_unique<Page>());
+        page = pages_.back().get();
+        entry.store(page, std::memory_order_release);
     }
-    return nullptr;
+    
+    accounts_.push_back(std::make_unique<Account>(trader_id, initial_balance));
+    Account* acc = accounts_.back().get();
+    page->slots[id & (PAGE_SIZE - 1)].store(acc, std::memory_order_release);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    return acc;
 }
 
 void Accounts::apply_trade(
@@ -86,32 +67,85 @@ void Accounts::apply_trade(
         return;  // Should not happen in normal operation
     }
     
-    std::int64_t notional = price.get() * qty.get();
-    std::int64_t qty_val = qty.get();
+    const std::int64_t notional = notional_value(price, qty);
+    const std::int64_t qty_val = qty.get();
+    const auto volume = static_cast<std::uint64_t>(qty_val);
     
-    // Determine who is buying/selling
-    // Taker side is the aggressor
-    if (taker_side == Side::Buy) {
-        // Taker buys, maker sells
-        taker->balance.fetch_sub(notional, std::memory_order_relaxed);
-        taker->position.fetch_add(qty_val, std::memory_order_relaxed);
-        
-        maker->balance.fetch_add(notional, std::memory_order_relaxed);
-        maker->position.fetch_sub(qty_val, std::memory_order_relaxed);
+    // Taker side is the aggressor; maker takes the other side
+    const std::int64_t taker_sign = (taker_side == Side::Buy) ? 1 : -1;
+    settle(*taker, Delta{
+        .balance = -taker_sign * notional,
+        .position = taker_sign * qty_val,
+        .trades = 1,
+        .volume = volume
+    });
+    settle(*maker, Delta{
+        .balance = taker_sign * notional,
+        .position = -taker_sign * qty_val,
+        .trades = 1,
+        .volume = volume,
+        .open_side = opposite(taker_side),
+        .open_qty = -qty_val,
+        .open_notional = -notional
+    });
+}
+
+void Accounts::adjust_open(TraderId trader_id, Side side, std::int64_t qty, Price price) {
+    Account* acc = get(trader_id);
+    if CES_UNLIKELY(!acc) {
+        return;
+    }
+    settle(*acc, Delta{
+        .open_side = side,
+        .open_qty = qty,
+        .open_notional = qty * static_cast<std::int64_t>(price.get())
+    });
+}
+
+namespace {
+
+/// Shared: atomic RMW. SingleWriter: plain load/add/store.
+template<typename T>
+CES_FORCE_INLINE void add_field(AccountsMode mode, std::atomic<T>& field, T delta) noexcept {
+    if (mode == AccountsMode::Shared) {
+        field.fetch_add(delta, std::memory_order_relaxed);
     } else {
-        // Taker sells, maker buys
-        taker->balance.fetch_add(notional, std::memory_order_relaxed);
-        taker->position.fetch_sub(qty_val, std::memory_order_relaxed);
-        
-        maker->balance.fetch_sub(notional, std::memory_order_relaxed);
-        maker->position.fetch_add(qty_val, std::memory_order_relaxed);
+        field.store(field.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+void Accounts::settle(Account& acc, const Delta& delta) noexcept {
+    const bool single_writer = mode_ == AccountsMode::SingleWriter;
+    
+    // Single writer: bracket the update with an odd seq for snapshot readers
+    std::uint32_t seq = 0;
+    if (single_writer) {
+        seq = acc.seq.load(std::memory_order_relaxed);
+        acc.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    
+    if (delta.trades != 0 || delta.balance != 0) {
+        add_field(mode_, acc.balance, delta.balance);
+        add_field(mode_, acc.position, delta.position);
+        add_field(mode_, acc.trade_count, delta.trades);
+        add_field(mode_, acc.volume, delta.volume);
+    }
+    if (delta.open_qty != 0) {
+        if (delta.open_side == Side::Buy) {
+            add_field(mode_, acc.open_buy_qty, delta.open_qty);
+            add_field(mode_, acc.open_buy_notional, delta.open_notional);
+        } else {
+            add_field(mode_, acc.open_sell_qty, delta.open_qty);
+            add_field(mode_, acc.open_sell_notional, delta.open_notional);
+        }
     }
     
-    // Update trade counts
-    maker->trade_count.fetch_add(1, std::memory_order_relaxed);
-    maker->volume.fetch_add(qty_val, std::memory_order_relaxed);
-    taker->trade_count.fetch_add(1, std::memory_order_relaxed);
-    taker->volume.fetch_add(qty_val, std::memory_order_relaxed);
+    if (single_writer) {
+        acc.seq.store(seq + 2, std::memory_order_release);
+    }
 }
 
 bool Accounts::adjust_balance(TraderId trader_id, std::int64_t amount) {
@@ -120,7 +154,7 @@ bool Accounts::adjust_balance(TraderId trader_id, std::int64_t amount) {
         return false;
     }
     
-    acc->balance.fetch_add(amount, std::memory_order_relaxed);
+    settle(*acc, Delta{.balance = amount});
     return true;
 }
 
@@ -149,17 +183,87 @@ std::int64_t Accounts::get_position(TraderId trader_id) const {
     return acc->position.load(std::memory_order_relaxed);
 }
 
-void Accounts::clear() {
-    // Lock all stripes
-    for (auto& mutex : stripe_mutexes_) {
-        mutex.lock();
+std::optional<AccountSnapshot> Accounts::snapshot(TraderId trader_id) const noexcept {
+    const Account* acc = get(trader_id);
+    if (!acc) {
+        return std::nullopt;
     }
     
-    accounts_.clear();
+    AccountSnapshot snap;
+    snap.trader_id = acc->trader_id;
+    for (;;) {
+        const std::uint32_t before = acc->seq.load(std::memory_order_acquire);
+        if (before & 1U) {
+            CES_CPU_RELAX();  // Writer mid-update
+            continue;
+        }
+        snap.balance = acc->balance.load(std::memory_order_relaxed);
+        snap.position = acc->position.load(std::memory_order_relaxed);
+        snap.trade_count = acc->trade_count.load(std::memory_order_relaxed);
+        snap.volume = acc->volume.load(std::memory_order_relaxed);
+        snap.open_buy_qty = acc->open_buy_qty.load(std::memory_order_relaxed);
+        snap.open_sell_qty = acc->open_sell_qty.load(std::memory_order_relaxed);
+        snap.open_buy_notional = acc->open_buy_notional.load(std::memory_order_relaxed);
+        snap.open_sell_notional = acc->open_sell_notional.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (acc->seq.load(std::memory_order_relaxed) == before) {
+            return snap;
+        }
+    }
+}
+
+std::uint64_t Accounts::state_hash() const noexcept {
+    StateHash hash;
+    for_each_account([this, &hash](const Account& acc) {
+        const AccountSnapshot snap = *snapshot(acc.trader_id);
+        if (snap.trade_count == 0 && snap.open_buy_qty == 0 && snap.open_sell_qty == 0) {
+            return;
+        }
+        hash.add(snap.trader_id.get())
+            .add_signed(snap.balance)
+            .add_signed(snap.position)
+            .add(snap.trade_count)
+            .add(snap.volume)
+            .add_signed(snap.open_buy_qty)
+            .add_signed(snap.open_sell_qty)
+            .add_signed(snap.open_buy_notional)
+            .add_signed(snap.open_sell_notional);
+    });
+    return hash.value();
+}
+
+void Accounts::capture(std::vector<AccountSnapshot>& out) const {
+    out.clear();
+    for_each_account([this, &out](const Account& acc) {
+        out.push_back(*snapshot(acc.trader_id));
+    });
+}
+
+bool Accounts::restore(const AccountSnapshot& snap) {
+    Account* acc = get_or_create(snap.trader_id, snap.balance);
+    if (!acc) {
+        return false;
+    }
+    acc->balance.store(snap.balance, std::memory_order_relaxed);
+    acc->position.store(snap.position, std::memory_order_relaxed);
+    acc->trade_count.store(snap.trade_count, std::memory_order_relaxed);
+    acc->volume.store(snap.volume, std::memory_order_relaxed);
+    acc->open_buy_qty.store(snap.open_buy_qty, std::memory_order_relaxed);
+    acc->open_sell_qty.store(snap.open_sell_qty, std::memory_order_relaxed);
+    acc->open_buy_notional.store(snap.open_buy_notional, std::memory_order_relaxed);
+    acc->open_sell_notional.store(snap.open_sell_notional, std::memory_order_relaxed);
+    return true;
+}
+
+void Accounts::clear() {
+    std::lock_guard lock(create_mutex_);
     
-    for (auto& mutex : stripe_mutexes_) {
-        mutex.unlock();
+    for (std::size_t i = 0; i < DIRECTORY_SIZE; ++i) {
+        directory_[i].store(nullptr, std::memory_order_relaxed);
     }
+    pages_.clear();
+    accounts_.clear();
+    count_.store(0, std::memory_order_relaxed);
 }
 
 } // namespace ces
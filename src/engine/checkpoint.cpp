@@ -0,0 +1,167 @@
+/**
+ * @file checkpoint.cpp
+ * @brief Checkpoint file format, writer thread and loader
+ */
+
+#include <ces/engine/checkpoint.hpp>
+#include <ces/lob/order_book.hpp>
+#include <ces/memory/mapped_file.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+
+#if defined(__linux__) || defined(__APPLE__)
+    #include <unistd.h>
+    #define CES_HAS_FSYNC 1
+#else
+    #define CES_HAS_FSYNC 0
+#endif
+
+namespace ces {
+
+namespace {
+
+struct FileCloser {
+    void operator()(std::FILE* f) const noexcept { std::fclose(f); }
+};
+
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+} // namespace
+
+SnapshotResult write_checkpoint(const std::string& path, const CheckpointImage& image) {
+    CheckpointHeader header = image.header;
+    header.account_count = image.accounts.size();
+    header.book_bytes = image.book.size();
+
+    const std::string tmp_path = path + ".tmp";
+    FilePtr file(std::fopen(tmp_path.c_str(), "wb"));
+    if (!file) {
+        return SnapshotResult::IoError;
+    }
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file.get()) == 1;
+    ok = ok && std::fwrite(image.accounts.data(), sizeof(AccountSnapshot), image.accounts.size(),
+                           file.get()) == image.accounts.size();
+    ok = ok && std::fwrite(image.book.data(), 1, image.book.size(), file.get()) == image.book.size();
+    ok = (std::fflush(file.get()) == 0) && ok;
+#if CES_HAS_FSYNC
+    // The rename must not reach disk before the data it points at
+    ok = ok && ::fsync(::fileno(file.get())) == 0;
+#endif
+    file.reset();
+
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return SnapshotResult::IoError;
+    }
+    return SnapshotResult::Ok;
+}
+
+SnapshotResult load_checkpoint(const std::string& path, OrderBook& book,
+                               Accounts& accounts, CheckpointHeader& header) {
+    auto file = MappedFile::open_read(path);
+    if (!file) {
+        return SnapshotResult::IoError;
+    }
+
+    CheckpointHeader read;
+    if (file->size() < sizeof(read)) {
+        return SnapshotResult::BadFormat;
+    }
+    std::memcpy(&read, file->data(), sizeof(read));
+    if (read.magic != CheckpointHeader::MAGIC) {
+        return SnapshotResult::BadFormat;
+    }
+    if (read.version != CheckpointHeader::VERSION || read.header_size != sizeof(CheckpointHeader)) {
+        return SnapshotResult::VersionMismatch;
+    }
+    const std::uint64_t accounts_bytes = read.account_count * sizeof(AccountSnapshot);
+    if (file->size() != sizeof(CheckpointHeader) + accounts_bytes + read.book_bytes) {
+        return SnapshotResult::BadFormat;
+    }
+
+    const std::byte* account_ptr = file->data() + sizeof(CheckpointHeader);
+    const SnapshotResult book_result = book.load_snapshot(std::span<const std::byte>(
+        account_ptr + accounts_bytes, static_cast<std::size_t>(read.book_bytes)));
+    if (book_result != SnapshotResult::Ok) {
+        return book_result;
+    }
+
+    for (std::uint64_t i = 0; i < read.account_count; ++i, account_ptr += sizeof(AccountSnapshot)) {
+        AccountSnapshot snap;
+        std::memcpy(&snap, account_ptr, sizeof(snap));
+        if (!accounts.restore(snap)) {
+            return SnapshotResult::CapacityExceeded;
+        }
+    }
+
+    header = read;
+    return SnapshotResult::Ok;
+}
+
+// ============================================================================
+// Checkpointer
+// ============================================================================
+
+Checkpointer::Checkpointer(Journal& journal, CheckpointConfig config)
+    : journal_(journal)
+    , config_(std::move(config)) {
+    writer_ = std::jthread([this](std::stop_token st) { write_loop(st); });
+}
+
+Checkpointer::~Checkpointer() {
+    // Let an in-flight checkpoint finish: it may be the only one on disk
+    wait_idle();
+    writer_.request_stop();
+}
+
+CheckpointImage* Checkpointer::begin() noexcept {
+    if (busy_.load(std::memory_order_acquire)) {
+        skipped_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &image_;
+}
+
+void Checkpointer::submit(Duration capture_ns) {
+    last_capture_ns_.store(capture_ns, std::memory_order_relaxed);
+    busy_.store(true, std::memory_order_release);
+    {
+        std::lock_guard lock(mutex_);
+        pending_ = true;
+    }
+    cv_.notify_one();
+}
+
+void Checkpointer::wait_idle() const noexcept {
+    busy_.wait(true, std::memory_order_acquire);
+}
+
+void Checkpointer::write_loop(std::stop_token stop_token) {
+    std::unique_lock lock(mutex_);
+    while (cv_.wait(lock, stop_token, [this] { return pending_; })) {
+        pending_ = false;
+        lock.unlock();
+
+        const Timestamp start = now_ns();
+        // The rename replaces the previous checkpoint: the records this one
+        // covers must be on disk first, or a crash leaves it ahead of the journal
+        const bool journaled = journal_.durable() >= image_.header.journal_seq || journal_.sync();
+        if (journaled && write_checkpoint(config_.path, image_) == SnapshotResult::Ok) {
+            last_seq_.store(image_.header.journal_seq, std::memory_order_release);
+            written_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            failed_.fetch_add(1, std::memory_order_relaxed);
+        }
+        last_write_ns_.store(elapsed_ns(start), std::memory_order_relaxed);
+
+        busy_.store(false, std::memory_order_release);
+        busy_.notify_all();
+        lock.lock();
+    }
+}
+
+} // namespace ces
@@ -0,0 +1,321 @@
+/**
+ * @file journal.cpp
+ * @brief Write-ahead journal file, flusher and reader
+ */
+
+#include <ces/engine/journal.hpp>
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+#if defined(__linux__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+    #define CES_HAS_MMAP 1
+#else
+    #define CES_HAS_MMAP 0
+#endif
+
+namespace ces {
+
+namespace {
+
+constexpr std::size_t record_offset(std::uint64_t index) noexcept {
+    return sizeof(JournalHeader) + static_cast<std::size_t>(index) * sizeof(JournalRecord);
+}
+
+} // namespace
+
+Journal::~Journal() {
+    if (is_open()) {
+        (void)close();
+    }
+}
+
+JournalResult Journal::create(const std::string& path, const JournalConfig& config) {
+#if CES_HAS_MMAP
+    if (is_open() || config.capacity == 0) {
+        return JournalResult::IoError;
+    }
+
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return JournalResult::IoError;
+    }
+
+    // Reserve the blocks up front so appends never extend the file
+    const std::size_t size = record_offset(config.capacity);
+#if defined(__linux__)
+    const bool sized = ::posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0;
+#else
+    const bool sized = ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+    if (!sized) {
+        ::close(fd);
+        return JournalResult::IoError;
+    }
+
+    void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+        ::close(fd);
+        return JournalResult::IoError;
+    }
+
+    base_ = static_cast<std::byte*>(ptr);
+    mapped_size_ = size;
+    fd_ = fd;
+    config_ = config;
+    records_ = reinterpret_cast<JournalRecord*>(base_ + sizeof(JournalHeader));
+    capacity_ = config.capacity;
+    written_.store(0, std::memory_order_relaxed);
+    durable_.store(0, std::memory_order_relaxed);
+    overflowed_.store(0, std::memory_order_relaxed);
+    syncs_.store(0, std::memory_order_relaxed);
+    io_error_.store(false, std::memory_order_relaxed);
+
+    JournalHeader header;
+    header.record_size = sizeof(JournalRecord);
+    header.capacity = config.capacity;
+    header.created_ns = now_ns();
+    std::memcpy(base_, &header, sizeof(header));
+    if (::msync(base_, sizeof(header), MS_SYNC) != 0) {
+        release();
+        return JournalResult::IoError;
+    }
+
+    flusher_ = std::jthread([this](std::stop_token st) { flush_loop(st); });
+    return JournalResult::Ok;
+#else
+    (void)path;
+    (void)config;
+    return JournalResult::IoError;
+#endif
+}
+
+void Journal::flush_loop(std::stop_token stop_token) {
+    if (config_.durability == JournalDurability::PerEvent) {
+        // Woken by every append; one sync covers whatever piled up meanwhile
+        std::uint64_t synced = 0;
+        while (!stop_token.stop_requested()) {
+            const std::uint32_t wake = wake_.load(std::memory_order_acquire);
+            const std::uint64_t target = written_.load(std::memory_order_acquire);
+            if (target == synced) {
+                wake_.wait(wake, std::memory_order_acquire);
+                continue;
+            }
+            if CES_UNLIKELY(!sync_range(synced, target, true)) {
+                // Not durable: durable_ stays put and waiters see io_error();
+                // retry on the next append
+                io_error_.store(true, std::memory_order_release);
+                end_pass();
+                wake_.wait(wake, std::memory_order_acquire);
+                continue;
+            }
+            synced = target;
+            advance_durable(synced);
+            end_pass();
+        }
+        return;
+    }
+
+    const bool blocking = config_.durability == JournalDurability::GroupCommit;
+    std::mutex mutex;
+    std::condition_variable_any cv;
+    std::unique_lock lock(mutex);
+    std::uint64_t synced = 0;
+    while (!stop_token.stop_requested()) {
+        cv.wait_for(lock, stop_token, config_.flush_interval, [] { return false; });
+        const std::uint64_t target = written_.load(std::memory_order_acquire);
+        if (target == synced) {
+            continue;
+        }
+        if CES_UNLIKELY(!sync_range(synced, target, blocking)) {
+            io_error_.store(true, std::memory_order_release);
+            continue;  // Retried from the same point next interval
+        }
+        synced = target;
+        if (blocking) {
+            advance_durable(synced);
+        }
+    }
+}
+
+void Journal::advance_durable(std::uint64_t seq) noexcept {
+    std::uint64_t durable = durable_.load(std::memory_order_relaxed);
+    while (durable < seq &&
+           !durable_.compare_exchange_weak(durable, seq, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+void Journal::end_pass() noexcept {
+    passes_.fetch_add(1, std::memory_order_release);
+    passes_.notify_all();
+}
+
+bool Journal::sync_range(std::uint64_t from, std::uint64_t to, bool blocking) noexcept {
+#if CES_HAS_MMAP
+    static const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t begin = record_offset(from) & ~(page_size - 1);
+    const std::size_t end = record_offset(to);
+    syncs_.fetch_add(1, std::memory_order_relaxed);
+    return ::msync(base_ + begin, end - begin, blocking ? MS_SYNC : MS_ASYNC) == 0;
+#else
+    (void)from;
+    (void)to;
+    (void)blocking;
+    return false;
+#endif
+}
+
+bool Journal::wait_durable(std::uint64_t seq) noexcept {
+    // The flusher sleeps on wake_; wake it for this record
+    wake_.fetch_add(1, std::memory_order_release);
+    wake_.notify_one();
+    for (;;) {
+        // Read the pass first: a pass that ends after the checks below changes it
+        const std::uint32_t pass = passes_.load(std::memory_order_acquire);
+        if (durable_.load(std::memory_order_acquire) >= seq) {
+            return true;
+        }
+        if (io_error_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        passes_.wait(pass, std::memory_order_acquire);
+    }
+}
+
+bool Journal::sync() noexcept {
+    if (!is_open()) {
+        return false;
+    }
+    const std::uint64_t target = written_.load(std::memory_order_acquire);
+    if (!sync_range(0, target, true)) {
+        io_error_.store(true, std::memory_order_relaxed);
+        return false;
+    }
+    advance_durable(target);
+    end_pass();
+    return true;
+}
+
+JournalResult Journal::close(std::optional<std::uint64_t> state_hash) noexcept {
+    if (!is_open()) {
+        return JournalResult::IoError;
+    }
+
+    if (flusher_.joinable()) {
+        flusher_.request_stop();
+        // A PerEvent flusher may be asleep on wake_
+        wake_.fetch_add(1, std::memory_order_release);
+        wake_.notify_all();
+        flusher_.join();
+    }
+
+    // After a failed sync the records may not all be on disk: leave the
+    // header unmarked so readers find the valid prefix themselves
+    bool ok = sync() && !io_error();
+#if CES_HAS_MMAP
+    if (ok) {
+        JournalHeader header;
+        std::memcpy(&header, base_, sizeof(header));
+        header.record_count = written_.load(std::memory_order_relaxed);
+        header.flags |= JournalHeader::FLAG_CLEAN_CLOSE;
+        if (state_hash) {
+            header.state_hash = *state_hash;
+            header.flags |= JournalHeader::FLAG_STATE_HASH;
+        }
+        std::memcpy(base_, &header, sizeof(header));
+        ok = ::msync(base_, sizeof(header), MS_SYNC) == 0;
+#if defined(__linux__)
+        ok = ok && ::fdatasync(fd_) == 0;
+#else
+        ok = ok && ::fsync(fd_) == 0;
+#endif
+    }
+#endif
+    release();
+    return ok ? JournalResult::Ok : JournalResult::IoError;
+}
+
+void Journal::release() noexcept {
+#if CES_HAS_MMAP
+    if (base_ != nullptr) {
+        ::munmap(base_, mapped_size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+    base_ = nullptr;
+    mapped_size_ = 0;
+    fd_ = -1;
+    records_ = nullptr;
+    capacity_ = 0;
+}
+
+// ============================================================================
+// JournalReader
+// ============================================================================
+
+std::optional<JournalReader> JournalReader::open(const std::string& path,
+                                                 JournalResult& result) {
+    auto file = MappedFile::open_read(path);
+    if (!file) {
+        result = JournalResult::IoError;
+        return std::nullopt;
+    }
+
+    JournalReader reader;
+    if (file->size() < sizeof(JournalHeader)) {
+        result = JournalResult::BadFormat;
+        return std::nullopt;
+    }
+    std::memcpy(&reader.header_, file->data(), sizeof(JournalHeader));
+    const JournalHeader& header = reader.header_;
+
+    if (header.magic != JournalHeader::MAGIC) {
+        result = JournalResult::BadFormat;
+        return std::nullopt;
+    }
+    if (header.version != JournalHeader::VERSION) {
+        result = JournalResult::VersionMismatch;
+        return std::nullopt;
+    }
+    if (header.header_size != sizeof(JournalHeader) ||
+        header.record_size != sizeof(JournalRecord) ||
+        file->size() < record_offset(header.capacity)) {
+        result = JournalResult::BadFormat;
+        return std::nullopt;
+    }
+
+    reader.file_ = std::move(*file);
+
+    if (reader.clean_close() && header.record_count <= header.capacity) {
+        reader.count_ = header.record_count;
+    } else {
+        // Crashed writer: the valid prefix ends at the first unexpected seq
+        // or at a record torn mid-write
+        std::uint64_t count = 0;
+        while (count < header.capacity) {
+            const JournalRecord record = reader.record(count);
+            if (record.seq != count + 1 || record.checksum != record.compute_checksum()) {
+                break;
+            }
+            ++count;
+        }
+        reader.count_ = count;
+    }
+
+    result = JournalResult::Ok;
+    return reader;
+}
+
+JournalRecord JournalReader::record(std::uint64_t i) const noexcept {
+    JournalRecord record;
+    std::memcpy(&record, file_.data() + record_offset(i), sizeof(JournalRecord));
+    return record;
+}
+
+} // namespace ces
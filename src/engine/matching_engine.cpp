@@ -22,4 +22,14 @@ template class MatchingEngine<16384>;
 // 4K capacity  
 template class MatchingEngine<4096>;
 
+// Lock-free SPSC queue variants
+template class MatchingEngine<65536, SpscQueue<OrderEvent, 65536>>;
+template class MatchingEngine<16384, SpscQueue<OrderEvent, 16384>>;
+template class MatchingEngine<4096, SpscQueue<OrderEvent, 4096>>;
+
+// Multi-producer queue variants
+template class MatchingEngine<65536, MpscQueue<OrderEvent, 65536>>;
+template class MatchingEngine<16384, MpscQueue<OrderEvent, 16384>>;
+template class MatchingEngine<4096, MpscQueue<OrderEvent, 4096>>;
+
 } // namespace ces
@@ -0,0 +1,16 @@
+/**
+ * @file pipeline_engine.cpp
+ * @brief Template instantiations for the staged pipeline
+ */
+
+#include <ces/engine/pipeline_engine.hpp>
+
+namespace ces {
+
+// Template instantiations for common ring sizes
+
+template class PipelineEngine<65536>;
+template class PipelineEngine<16384>;
+template class PipelineEngine<4096>;
+
+} // namespace ces
@@ -0,0 +1,410 @@
+/**
+ * @file replication.cpp
+ * @brief Journal streaming to a hot standby over a Unix-domain socket
+ */
+
+#include <ces/engine/replication.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+    #define CES_HAS_UNIX_SOCKETS 1
+#else
+    #define CES_HAS_UNIX_SOCKETS 0
+#endif
+
+namespace ces {
+
+#if CES_HAS_UNIX_SOCKETS
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;  // A vanished peer is an error, not SIGPIPE
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+bool make_address(const std::string& path, sockaddr_un& addr) noexcept {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+int open_socket() noexcept {
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+#ifdef SO_NOSIGPIPE
+    if (fd >= 0) {
+        const int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+    }
+#endif
+    return fd;
+}
+
+/**
+ * @brief Write all of buf to a blocking socket
+ */
+bool send_all(int fd, const void* buf, std::size_t size) noexcept {
+    const auto* p = static_cast<const std::byte*>(buf);
+    while (size > 0) {
+        const ssize_t n = ::send(fd, p, size, SEND_FLAGS);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Read exactly size bytes, waiting at most timeout_ms for each chunk
+ */
+bool receive_all(int fd, void* buf, std::size_t size, int timeout_ms) noexcept {
+    auto* p = static_cast<std::byte*>(buf);
+    while (size > 0) {
+        pollfd pfd{.fd = fd, .events = POLLIN, .revents = 0};
+        if (::poll(&pfd, 1, timeout_ms) <= 0) {
+            return false;
+        }
+        const ssize_t n = ::recv(fd, p, size, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// ReplicationPrimary
+// ============================================================================
+
+ReplicationPrimary::ReplicationPrimary(const Journal& journal, ReplicationConfig config)
+    : journal_(journal)
+    , config_(std::move(config)) {
+    config_.batch = std::max<std::size_t>(config_.batch, 1);
+}
+
+ReplicationPrimary::~ReplicationPrimary() {
+    stop();
+}
+
+ReplicationResult ReplicationPrimary::start() {
+    if (listen_fd_ >= 0 || !journal_.is_open()) {
+        return ReplicationResult::IoError;
+    }
+    sockaddr_un addr;
+    if (!make_address(config_.socket_path, addr)) {
+        return ReplicationResult::IoError;
+    }
+
+    listen_fd_ = open_socket();
+    if (listen_fd_ < 0) {
+        return ReplicationResult::IoError;
+    }
+    ::unlink(config_.socket_path.c_str());
+    if (::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 1) != 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return ReplicationResult::IoError;
+    }
+
+    sender_ = std::jthread([this](std::stop_token st) { send_loop(st); });
+    return ReplicationResult::Ok;
+}
+
+void ReplicationPrimary::stop() noexcept {
+    if (sender_.joinable()) {
+        sender_.request_stop();
+        sender_.join();
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        ::unlink(config_.socket_path.c_str());
+    }
+}
+
+void ReplicationPrimary::send_loop(std::stop_token stop_token) {
+    constexpr int ACCEPT_POLL_MS = 20;  // Bounds how long stop() waits on an idle listener
+
+    while (!stop_token.stop_requested()) {
+        pollfd pfd{.fd = listen_fd_, .events = POLLIN, .revents = 0};
+        if (::poll(&pfd, 1, ACCEPT_POLL_MS) <= 0) {
+            continue;
+        }
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        serve(fd, stop_token);
+        ::close(fd);
+    }
+}
+
+void ReplicationPrimary::serve(int fd, std::stop_token stop_token) {
+    constexpr int HELLO_TIMEOUT_MS = 1000;
+
+    ReplicaHello hello{.magic = 0, .next_seq = 0};
+    if (!receive_all(fd, &hello, sizeof(hello), HELLO_TIMEOUT_MS) ||
+        hello.magic != ReplicaHello::MAGIC || hello.next_seq == 0 ||
+        hello.next_seq - 1 > journal_.written()) {
+        return;
+    }
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    // Stream position in bytes from the first record; a send may end mid-record
+    constexpr std::size_t RECORD = sizeof(JournalRecord);
+    std::uint64_t sent_bytes = (hello.next_seq - 1) * RECORD;
+    const auto* stream = reinterpret_cast<const std::byte*>(journal_.records());
+
+    std::array<std::uint64_t, 64> acks;
+    std::size_t ack_bytes = 0;
+
+    sent_.store(hello.next_seq - 1, std::memory_order_relaxed);
+    acked_.store(hello.next_seq - 1, std::memory_order_release);
+    limit_.store(hello.next_seq - 1 + config_.max_lag, std::memory_order_release);
+    connected_.store(true, std::memory_order_release);
+    connections_.fetch_add(1, std::memory_order_relaxed);
+
+    bool alive = true;
+    while (alive && !stop_token.stop_requested()) {
+        bool progress = false;
+
+        const std::uint64_t written_bytes = journal_.written() * RECORD;
+        if (sent_bytes < written_bytes) {
+            const std::size_t chunk = static_cast<std::size_t>(
+                std::min<std::uint64_t>(written_bytes - sent_bytes, config_.batch * RECORD));
+            const ssize_t n = ::send(fd, stream + sent_bytes, chunk, SEND_FLAGS);
+            if (n > 0) {
+                sent_bytes += static_cast<std::uint64_t>(n);
+                sent_.store(sent_bytes / RECORD, std::memory_order_relaxed);
+                progress = true;
+            } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                alive = false;
+            }
+        }
+
+        // Only the newest ack matters; a partial one stays buffered
+        auto* ack_buf = reinterpret_cast<std::byte*>(acks.data());
+        const ssize_t n = ::recv(fd, ack_buf + ack_bytes, sizeof(acks) - ack_bytes, 0);
+        if (n > 0) {
+            ack_bytes += static_cast<std::size_t>(n);
+            const std::size_t complete = ack_bytes / sizeof(std::uint64_t);
+            if (complete > 0) {
+                const std::uint64_t acked = acks[complete - 1];
+                acked_.store(acked, std::memory_order_release);
+                limit_.store(acked + config_.max_lag, std::memory_order_release);
+                ack_bytes -= complete * sizeof(std::uint64_t);
+                std::memmove(ack_buf, ack_buf + complete * sizeof(std::uint64_t), ack_bytes);
+            }
+            progress = true;
+        } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            alive = false;  // Standby closed or failed
+        }
+
+        if (!progress) {
+            std::this_thread::sleep_for(config_.poll_interval);
+        }
+    }
+
+    // Stop throttling before anyone can observe the disconnect
+    limit_.store(NO_LIMIT, std::memory_order_release);
+    connected_.store(false, std::memory_order_release);
+}
+
+void ReplicationPrimary::wait_for_standby(std::uint64_t seq) noexcept {
+    constexpr std::uint32_t SPINS_BEFORE_YIELD = 1'000;
+
+    const Timestamp start = now_ns();
+    std::uint32_t spins = 0;
+    while (seq > limit_.load(std::memory_order_acquire)) {
+        if (++spins < SPINS_BEFORE_YIELD) {
+            CES_CPU_RELAX();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    const Duration waited = elapsed_ns(start);
+    stalls_.fetch_add(1, std::memory_order_relaxed);
+    stall_ns_.fetch_add(waited, std::memory_order_relaxed);
+    stall_histogram_.record(waited);
+}
+
+// ============================================================================
+// ReplicationStandby
+// ============================================================================
+
+ReplicationStandby::ReplicationStandby(ReplicationConfig config)
+    : config_(std::move(config)) {
+    config_.batch = std::max<std::size_t>(config_.batch, 1);
+    buffer_.resize(config_.batch);
+}
+
+ReplicationStandby::~ReplicationStandby() {
+    disconnect();
+}
+
+ReplicationResult ReplicationStandby::connect(std::uint64_t next_seq, std::chrono::milliseconds timeout) {
+    constexpr auto RETRY_INTERVAL = std::chrono::milliseconds{10};
+
+    sockaddr_un addr;
+    if (fd_ >= 0 || next_seq == 0 || !make_address(config_.socket_path, addr)) {
+        return ReplicationResult::IoError;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        fd_ = open_socket();
+        if (fd_ < 0) {
+            return ReplicationResult::IoError;
+        }
+        if (::connect(fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0) {
+            break;
+        }
+        const int error = errno;
+        ::close(fd_);
+        fd_ = -1;
+        if (error != ENOENT && error != ECONNREFUSED) {
+            return ReplicationResult::IoError;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return ReplicationResult::Timeout;
+        }
+        std::this_thread::sleep_for(RETRY_INTERVAL);
+    }
+
+    const ReplicaHello hello{.magic = ReplicaHello::MAGIC, .next_seq = next_seq};
+    if (!send_all(fd_, &hello, sizeof(hello))) {
+        disconnect();
+        return ReplicationResult::IoError;
+    }
+
+    buffered_bytes_ = 0;
+    consumed_bytes_ = 0;
+    gap_.store(false, std::memory_order_relaxed);
+    applied_.store(next_seq - 1, std::memory_order_release);
+    connected_.store(true, std::memory_order_release);
+    return ReplicationResult::Ok;
+}
+
+void ReplicationStandby::disconnect() noexcept {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    connected_.store(false, std::memory_order_release);
+}
+
+std::span<const JournalRecord> ReplicationStandby::receive() {
+    if (fd_ < 0) {
+        return {};
+    }
+
+    // Move the partial record left by the last receive to the front
+    auto* bytes = reinterpret_cast<std::byte*>(buffer_.data());
+    const std::size_t leftover = buffered_bytes_ - consumed_bytes_;
+    std::memmove(bytes, bytes + consumed_bytes_, leftover);
+    buffered_bytes_ = leftover;
+    consumed_bytes_ = 0;
+
+    pollfd pfd{.fd = fd_, .events = POLLIN, .revents = 0};
+    if (::poll(&pfd, 1, static_cast<int>(config_.receive_timeout.count())) <= 0) {
+        return {};
+    }
+    const ssize_t n = ::recv(fd_, bytes + buffered_bytes_,
+                             buffer_.size() * sizeof(JournalRecord) - buffered_bytes_, 0);
+    if (n < 0 && errno == EINTR) {
+        return {};
+    }
+    if (n <= 0) {
+        disconnect();  // Primary gone: stay at applied(), ready to take over
+        return {};
+    }
+    buffered_bytes_ += static_cast<std::size_t>(n);
+
+    const std::size_t count = buffered_bytes_ / sizeof(JournalRecord);
+    const std::uint64_t first = applied_.load(std::memory_order_relaxed) + 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        if CES_UNLIKELY(buffer_[i].seq != first + i ||
+                        buffer_[i].checksum != buffer_[i].compute_checksum()) {
+            gap_.store(true, std::memory_order_relaxed);
+            disconnect();
+            return {};
+        }
+    }
+    consumed_bytes_ = count * sizeof(JournalRecord);
+    return {buffer_.data(), count};
+}
+
+void ReplicationStandby::acknowledge(const JournalRecord& last) noexcept {
+    applied_.store(last.seq, std::memory_order_release);
+    const Duration lag = elapsed_ns(last.timestamp);
+    last_lag_ns_.store(lag, std::memory_order_relaxed);
+    lag_histogram_.record(lag);
+
+    if (!send_all(fd_, &last.seq, sizeof(last.seq))) {
+        disconnect();
+    }
+}
+
+#else  // !CES_HAS_UNIX_SOCKETS
+
+ReplicationPrimary::ReplicationPrimary(const Journal& journal, ReplicationConfig config)
+    : journal_(journal)
+    , config_(std::move(config)) {}
+
+ReplicationPrimary::~ReplicationPrimary() = default;
+
+ReplicationResult ReplicationPrimary::start() { return ReplicationResult::IoError; }
+
+void ReplicationPrimary::stop() noexcept {}
+
+void ReplicationPrimary::send_loop(std::stop_token) {}
+
+void ReplicationPrimary::serve(int, std::stop_token) {}
+
+void ReplicationPrimary::wait_for_standby(std::uint64_t) noexcept {}
+
+ReplicationStandby::ReplicationStandby(ReplicationConfig config)
+    : config_(std::move(config)) {}
+
+ReplicationStandby::~ReplicationStandby() = default;
+
+ReplicationResult ReplicationStandby::connect(std::uint64_t, std::chrono::milliseconds) {
+    return ReplicationResult::IoError;
+}
+
+void ReplicationStandby::disconnect() noexcept {}
+
+std::span<const JournalRecord> ReplicationStandby::receive() { return {}; }
+
+void ReplicationStandby::acknowledge(const JournalRecord&) noexcept {}
+
+#endif
+
+} // namespace ces
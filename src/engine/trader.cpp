@@ -16,4 +16,12 @@ template class Trader<65536>;
 template class Trader<16384>;
 template class Trader<4096>;
 
+template class Trader<65536, SpscQueue<OrderEvent, 65536>>;
+template class Trader<16384, SpscQueue<OrderEvent, 16384>>;
+template class Trader<4096, SpscQueue<OrderEvent, 4096>>;
+
+template class Trader<65536, MpscQueue<OrderEvent, 65536>>;
+template class Trader<16384, MpscQueue<OrderEvent, 16384>>;
+template class Trader<4096, MpscQueue<OrderEvent, 4096>>;
+
 } // namespace ces
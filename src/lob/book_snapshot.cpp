@@ -0,0 +1,211 @@
+/**
+ * @file book_snapshot.cpp
+ * @brief OrderBook snapshot save/restore
+ */
+
+#include <ces/lob/order_book.hpp>
+#include <ces/lob/book_snapshot.hpp>
+#include <ces/memory/mapped_file.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+    #include <unistd.h>
+    #define CES_HAS_FSYNC 1
+#else
+    #define CES_HAS_FSYNC 0
+#endif
+
+namespace ces {
+
+namespace {
+
+struct FileCloser {
+    void operator()(std::FILE* f) const noexcept { std::fclose(f); }
+};
+
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+template<typename T>
+void append_record(std::vector<std::byte>& image, std::size_t& offset, const T& record) noexcept {
+    std::memcpy(image.data() + offset, &record, sizeof(T));
+    offset += sizeof(T);
+}
+
+/// Copy a record out of the mapping (the mapping has no alignment guarantee)
+template<typename T>
+[[nodiscard]] T read_record(const std::byte* src) noexcept {
+    T record;
+    std::memcpy(&record, src, sizeof(T));
+    return record;
+}
+
+} // namespace
+
+void OrderBook::capture_snapshot(std::vector<std::byte>& image) const {
+    std::lock_guard lock(mutex_);
+    
+    SnapshotHeader header;
+    header.order_count = order_pool_.size();
+    header.bid_levels = static_cast<std::uint32_t>(bids_.size());
+    header.ask_levels = static_cast<std::uint32_t>(asks_.size());
+    header.total_trades = total_trades_;
+    header.total_volume = total_volume_;
+    
+    // resize() only grows the buffer; a reused image does not reallocate
+    image.resize(sizeof(SnapshotHeader)
+        + (std::size_t{header.bid_levels} + header.ask_levels) * sizeof(SnapshotLevel)
+        + header.order_count * sizeof(SnapshotOrder));
+    
+    std::size_t offset = 0;
+    append_record(image, offset, header);
+    
+    for (const auto* levels : {&bids_, &asks_}) {
+        for (const PriceLevel& level : *levels) {
+            append_record(image, offset, SnapshotLevel{level.price, level.order_count});
+        }
+    }
+    
+    for (const auto* levels : {&bids_, &asks_}) {
+        for (const PriceLevel& level : *levels) {
+            for (std::uint32_t idx = level.head_idx; idx != INVALID_POOL_INDEX; ) {
+                const Order& order = order_pool_[idx];
+                append_record(image, offset,
+                    SnapshotOrder{order.order_id, order.trader_id, order.qty_remaining});
+                idx = order.next_idx;
+            }
+        }
+    }
+}
+
+SnapshotResult OrderBook::save_snapshot(const std::string& path) const {
+    std::vector<std::byte> image;
+    capture_snapshot(image);
+    
+    const std::string tmp_path = path + ".tmp";
+    FilePtr file(std::fopen(tmp_path.c_str(), "wb"));
+    if (!file) {
+        return SnapshotResult::IoError;
+    }
+    
+    bool ok = std::fwrite(image.data(), 1, image.size(), file.get()) == image.size();
+    ok = (std::fflush(file.get()) == 0) && ok;
+#if CES_HAS_FSYNC
+    // The rename must not reach disk before the data it points at
+    ok = ok && ::fsync(::fileno(file.get())) == 0;
+#endif
+    file.reset();
+    
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return SnapshotResult::IoError;
+    }
+    return SnapshotResult::Ok;
+}
+
+SnapshotResult OrderBook::load_snapshot(const std::string& path) {
+    auto file = MappedFile::open_read(path);
+    if (!file) {
+        return SnapshotResult::IoError;
+    }
+    return load_snapshot(std::span<const std::byte>(file->data(), file->size()));
+}
+
+SnapshotResult OrderBook::load_snapshot(std::span<const std::byte> image) {
+    if (image.size() < sizeof(SnapshotHeader)) {
+        return SnapshotResult::BadFormat;
+    }
+    const auto header = read_record<SnapshotHeader>(image.data());
+    if (header.magic != SnapshotHeader::MAGIC) {
+        return SnapshotResult::BadFormat;
+    }
+    if (header.version != SnapshotHeader::VERSION || header.header_size != sizeof(SnapshotHeader)) {
+        return SnapshotResult::VersionMismatch;
+    }
+    
+    const std::uint64_t level_count = std::uint64_t{header.bid_levels} + header.ask_levels;
+    const std::uint64_t expected_size = sizeof(SnapshotHeader)
+        + level_count * sizeof(SnapshotLevel)
+        + header.order_count * sizeof(SnapshotOrder);
+    if (image.size() != expected_size) {
+        return SnapshotResult::BadFormat;
+    }
+    
+    std::lock_guard lock(mutex_);
+    clear_internal();
+    
+    if (header.order_count > order_pool_.max_capacity()) {
+        return SnapshotResult::CapacityExceeded;
+    }
+    
+    // Size everything once up front so the load loop never reallocates
+    while (order_pool_.capacity() < header.order_count) {
+        order_pool_.install_segment(order_pool_.prepare_segment());
+    }
+    order_index_.reserve(header.order_count);
+    bids_.reserve(header.bid_levels);
+    asks_.reserve(header.ask_levels);
+    
+    const std::byte* level_ptr = image.data() + sizeof(SnapshotHeader);
+    const std::byte* order_ptr = level_ptr + level_count * sizeof(SnapshotLevel);
+    const std::byte* const order_end = image.data() + image.size();
+    
+    auto fail = [this](SnapshotResult result) {
+        clear_internal();
+        return result;
+    };
+    
+    for (std::uint64_t l = 0; l < level_count; ++l, level_ptr += sizeof(SnapshotLevel)) {
+        const bool is_bid = l < header.bid_levels;
+        const Side side = is_bid ? Side::Buy : Side::Sell;
+        auto& levels = is_bid ? bids_ : asks_;
+        const auto record = read_record<SnapshotLevel>(level_ptr);
+        
+        // Levels must arrive best-first and strictly ordered, and be non-empty
+        if (record.order_count == 0 || record.price.get() <= 0 ||
+            (!levels.empty() && (is_bid ? !(record.price < levels.back().price)
+                                        : !(levels.back().price < record.price)))) {
+            return fail(SnapshotResult::BadFormat);
+        }
+        if (static_cast<std::size_t>(order_end - order_ptr) <
+            std::size_t{record.order_count} * sizeof(SnapshotOrder)) {
+            return fail(SnapshotResult::BadFormat);
+        }
+        
+        levels.emplace_back(record.price);
+        PriceLevel& level = levels.back();
+        
+        for (std::uint32_t i = 0; i < record.order_count; ++i, order_ptr += sizeof(SnapshotOrder)) {
+            const auto order = read_record<SnapshotOrder>(order_ptr);
+            if (order.qty.get() <= 0) {
+                return fail(SnapshotResult::BadFormat);
+            }
+            
+            std::uint32_t pool_idx = order_pool_.allocate(
+                order.order_id, order.trader_id, side, record.price, order.qty
+            );
+            if (!order_index_.insert(order.order_id.get(), pool_idx)) {
+                return fail(SnapshotResult::BadFormat);  // Duplicate order ID
+            }
+            level.push_back(order_pool_, pool_idx);
+        }
+    }
+    
+    // Level order counts must add up to the header's, and the book must not be crossed
+    if (order_ptr != order_end) {
+        return fail(SnapshotResult::BadFormat);
+    }
+    if (!bids_.empty() && !asks_.empty() && !(bids_.front().price < asks_.front().price)) {
+        return fail(SnapshotResult::BadFormat);
+    }
+    
+    total_trades_ = header.total_trades;
+    total_volume_ = header.total_volume;
+    return SnapshotResult::Ok;
+}
+
+} // namespace ces
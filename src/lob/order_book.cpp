@@ -5,8 +5,11 @@
 
 #include <ces/lob/order_book.hpp>
 #include <ces/common/macros.hpp>
+#include <ces/common/state_hash.hpp>
 
 #include <algorithm>
+#include <iomanip>
+#include <iostream>
 
 namespace ces {
 
@@ -26,7 +29,7 @@ OrderResponse OrderBook::add_limit_internal(
     response.order_id = order_id;
     
     // Check for duplicate order ID
-    if CES_UNLIKELY(order_map_.contains(order_id.get())) {
+    if CES_UNLIKELY(order_index_.contains(order_id.get())) {
         response.result = OrderResult::Rejected;
         return response;
     }
@@ -54,8 +57,8 @@ OrderResponse OrderBook::add_limit_internal(
         return response;
     }
     
-    // Add to lookup map
-    order_map_[order_id.get()] = pool_idx;
+    // Add to lookup index
+    order_index_.insert(order_id.get(), pool_idx);
     
     // Add to appropriate price level
     auto& levels = (side == Side::Buy) ? bids_ : asks_;
@@ -109,19 +112,18 @@ OrderResponse OrderBook::cancel(OrderId order_id) {
     response.order_id = order_id;
     
     // Find order
-    auto it = order_map_.find(order_id.get());
-    if CES_UNLIKELY(it == order_map_.end()) {
+    std::uint32_t pool_idx = order_index_.find(order_id.get());
+    if CES_UNLIKELY(pool_idx == OrderIndex::INVALID_INDEX) {
         response.result = OrderResult::NotFound;
         return response;
     }
     
-    std::uint32_t pool_idx = it->second;
     const Order& order = order_pool_[pool_idx];
     response.qty_remaining = order.qty_remaining;
     
     // Remove from book
     remove_order_internal(pool_idx);
-    order_map_.erase(it);
+    order_index_.erase(order_id.get());
     
     response.result = OrderResult::Cancelled;
     return response;
@@ -134,13 +136,12 @@ OrderResponse OrderBook::modify(OrderId order_id, Qty new_qty, Price new_price)
     response.order_id = order_id;
     
     // Find existing order
-    auto it = order_map_.find(order_id.get());
-    if CES_UNLIKELY(it == order_map_.end()) {
+    std::uint32_t pool_idx = order_index_.find(order_id.get());
+    if CES_UNLIKELY(pool_idx == OrderIndex::INVALID_INDEX) {
         response.result = OrderResult::NotFound;
         return response;
     }
     
-    std::uint32_t pool_idx = it->second;
     Order& order = order_pool_[pool_idx];
     
     // If price changed, treat as cancel + new (loses priority)
@@ -150,7 +151,7 @@ OrderResponse OrderBook::modify(OrderId order_id, Qty new_qty, Price new_price)
         
         // Cancel existing (remove_order_internal handles deallocation)
         remove_order_internal(pool_idx);
-        order_map_.erase(it);
+        order_index_.erase(order_id.get());
         
         // Add new (reuse same order_id for simplicity) - use internal to avoid deadlock
         return add_limit_internal(order_id, trader_id, side, new_price, new_qty);
@@ -178,7 +179,7 @@ OrderResponse OrderBook::modify(OrderId order_id, Qty new_qty, Price new_price)
         
         // remove_order_internal handles deallocation
         remove_order_internal(pool_idx);
-        order_map_.erase(it);
+        order_index_.erase(order_id.get());
         
         // Use internal to avoid deadlock
         return add_limit_internal(order_id, trader_id, side, price, new_qty);
@@ -292,24 +293,162 @@ std::uint64_t OrderBook::total_volume() const {
 
 bool OrderBook::has_order(OrderId order_id) const {
     std::lock_guard lock(mutex_);
-    return order_map_.contains(order_id.get());
+    return order_index_.contains(order_id.get());
 }
 
-void OrderBook::clear() {
+std::optional<Order> OrderBook::find_order(OrderId order_id) const {
+    std::lock_guard lock(mutex_);
+    std::uint32_t pool_idx = order_index_.find(order_id.get());
+    if (pool_idx == OrderIndex::INVALID_INDEX) {
+        return std::nullopt;
+    }
+    return order_pool_[pool_idx];
+}
+
+std::uint64_t OrderBook::state_hash() const {
+    std::lock_guard lock(mutex_);
+    
+    StateHash hash;
+    hash.add(total_trades_).add(total_volume_);
+    for (const auto* levels : {&bids_, &asks_}) {
+        hash.add(levels->size());
+        for (const PriceLevel& level : *levels) {
+            hash.add_signed(level.price.get()).add(level.order_count);
+            for (std::uint32_t idx = level.head_idx; idx != INVALID_POOL_INDEX; ) {
+                const Order& order = order_pool_[idx];
+                hash.add(order.order_id.get())
+                    .add(order.trader_id.get())
+                    .add_signed(order.qty_remaining.get());
+                idx = order.next_idx;
+            }
+        }
+    }
+    return hash.value();
+}
+
+std::size_t OrderBook::order_capacity() const {
+    std::lock_guard lock(mutex_);
+    return order_pool_.capacity();
+}
+
+std::uint32_t OrderBook::pool_inline_grows() const {
+    std::lock_guard lock(mutex_);
+    return order_pool_.inline_grows();
+}
+
+BookMemoryStats OrderBook::memory_stats() const {
     std::lock_guard lock(mutex_);
     
+    BookMemoryStats stats;
+    
+    stats.pool_reserved_bytes = order_pool_.reserved_bytes();
+    stats.pool_used_bytes = order_pool_.size() * ObjectPool<Order>::slot_bytes();
+    stats.pool_capacity = order_pool_.capacity();
+    stats.pool_live = order_pool_.size();
+    stats.pool_peak_live = order_pool_.peak_size();
+    stats.pool_slots_touched = order_pool_.slots_initialized();
+    stats.pool_segments = order_pool_.segment_count();
+    stats.pool_inline_grows = order_pool_.inline_grows();
+    
+    const auto probes = order_index_.probe_stats();
+    stats.index_reserved_bytes = order_index_.slot_count() * OrderIndex::slot_bytes();
+    stats.index_used_bytes = order_index_.size() * OrderIndex::slot_bytes();
+    stats.index_slots = order_index_.slot_count();
+    stats.index_entries = order_index_.size();
+    stats.index_peak_entries = order_index_.peak_size();
+    stats.index_load_factor = order_index_.load_factor();
+    stats.index_mean_probe = probes.mean;
+    stats.index_max_probe = probes.max;
+    
+    stats.bid_levels = bids_.size();
+    stats.ask_levels = asks_.size();
+    stats.bid_level_capacity = bids_.capacity();
+    stats.ask_level_capacity = asks_.capacity();
+    stats.level_reserved_bytes = (bids_.capacity() + asks_.capacity()) * sizeof(PriceLevel);
+    stats.level_used_bytes = (bids_.size() + asks_.size()) * sizeof(PriceLevel);
+    stats.peak_bid_levels = peak_bid_levels_;
+    stats.peak_ask_levels = peak_ask_levels_;
+    stats.level_inserts = level_inserts_;
+    stats.level_erases = level_erases_;
+    stats.level_elements_shifted = level_elements_shifted_;
+    stats.level_reallocations = level_reallocations_;
+    
+    return stats;
+}
+
+void BookMemoryStats::print() const {
+    constexpr double MB = 1024.0 * 1024.0;
+    
+    std::cout << "\n=== Order Book Memory ===\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Total:          " << total_used_bytes() / MB << " / "
+              << total_reserved_bytes() / MB << " MB used/reserved\n";
+    std::cout << "  Order pool:     " << pool_used_bytes / MB << " / "
+              << pool_reserved_bytes / MB << " MB, " << pool_live << " live, peak "
+              << pool_peak_live << ", touched " << pool_slots_touched << " of "
+              << pool_capacity << " (" << pool_segments << " segments, "
+              << pool_inline_grows << " inline grows)\n";
+    std::cout << "  Order index:    " << index_used_bytes / MB << " / "
+              << index_reserved_bytes / MB << " MB, " << index_entries << " of "
+              << index_slots << " slots, peak " << index_peak_entries << "\n";
+    std::cout << "                  load " << index_load_factor << ", probe mean "
+              << index_mean_probe << " max " << index_max_probe << "\n";
+    std::cout << "  Price levels:   " << bid_levels << "/" << bid_level_capacity << " bid, "
+              << ask_levels << "/" << ask_level_capacity << " ask, peak "
+              << peak_bid_levels << "/" << peak_ask_levels << "\n";
+    std::cout << "                  " << level_inserts << " inserts, " << level_erases
+              << " erases, " << level_elements_shifted << " levels shifted, "
+              << level_reallocations << " reallocations\n";
+    std::cout << "=========================\n";
+}
+
+void OrderBook::prefault() {
+    std::lock_guard lock(mutex_);
+    order_pool_.prefault();
+    order_index_.prefault();
+}
+
+bool OrderBook::maintain() {
+    {
+        std::lock_guard lock(mutex_);
+        if (!order_pool_.needs_growth()) {
+            return false;
+        }
+    }
+    
+    // Allocate and initialize outside the lock; matching continues meanwhile
+    auto segment = order_pool_.prepare_segment();
+    
+    {
+        std::lock_guard lock(mutex_);
+        // Another caller (idle engine vs. housekeeping thread) may have
+        // installed a segment while this one was being prepared
+        if (order_pool_.needs_growth()) {
+            return order_pool_.install_segment(std::move(segment));
+        }
+    }
+    // Unused segment is unmapped here, outside the lock
+    return false;
+}
+
+void OrderBook::clear() {
+    std::lock_guard lock(mutex_);
+    clear_internal();
+}
+
+// ============================================================================
+// Internal Methods
+// ============================================================================
+
+void OrderBook::clear_internal() {
     order_pool_.clear();
-    order_map_.clear();
+    order_index_.clear();
     bids_.clear();
     asks_.clear();
     total_trades_ = 0;
     total_volume_ = 0;
 }
 
-// ============================================================================
-// Internal Methods
-// ============================================================================
-
 Qty OrderBook::match_order(
     OrderId taker_order_id,
     TraderId taker_trader_id,
@@ -338,18 +477,29 @@ Qty OrderBook::match_order(
             }
         }
         
+        // Next level header is read as soon as this one drains
+        if (level_it + 1 != levels.end()) {
+            CES_PREFETCH_READ(&*(level_it + 1));
+        }
+        
         // Match against orders at this level
         while (remaining.get() > 0 && !level_it->empty()) {
             std::uint32_t maker_idx = level_it->front_idx();
             Order& maker = order_pool_[maker_idx];
             
+            // Pull in the next makers, and this maker's index slot in case it
+            // fills, while the trade is processed
+            PriceLevel::prefetch_successors(order_pool_, maker);
+            order_index_.prefetch(maker.order_id.get());
+            
             Qty fill_qty{std::min(remaining.get(), maker.qty_remaining.get())};
             
             // Create trade
             Trade trade(
                 maker.order_id, taker_order_id,
                 maker.trader_id, taker_trader_id,
-                maker.price, fill_qty, side
+                maker.price, fill_qty, side,
+                trade_time_ != 0 ? trade_time_ : now_ns()
             );
             
             // Update maker
@@ -367,14 +517,14 @@ Qty OrderBook::match_order(
             if (maker.qty_remaining.get() <= 0) {
                 std::uint32_t idx_to_remove = maker_idx;
                 level_it->remove(order_pool_, idx_to_remove);
-                order_map_.erase(maker.order_id.get());
+                order_index_.erase(maker.order_id.get());
                 order_pool_.deallocate(idx_to_remove);
             }
         }
         
         // Remove empty level or advance
         if (level_it->empty()) {
-            level_it = levels.erase(level_it);
+            level_it = erase_level(levels, level_it);
         } else {
             ++level_it;
         }
@@ -401,7 +551,34 @@ std::vector<PriceLevel>::iterator OrderBook::find_or_create_level(
     }
     
     // Insert new level
-    return levels.insert(it, PriceLevel{price});
+    return insert_level(levels, it, price);
+}
+
+std::vector<PriceLevel>::iterator OrderBook::insert_level(
+    std::vector<PriceLevel>& levels,
+    std::vector<PriceLevel>::iterator it,
+    Price price
+) {
+    ++level_inserts_;
+    level_elements_shifted_ += static_cast<std::uint64_t>(levels.end() - it);
+    if (levels.size() == levels.capacity()) {
+        ++level_reallocations_;
+    }
+    
+    it = levels.insert(it, PriceLevel{price});
+    
+    std::size_t& peak = (&levels == &bids_) ? peak_bid_levels_ : peak_ask_levels_;
+    peak = std::max(peak, levels.size());
+    return it;
+}
+
+std::vector<PriceLevel>::iterator OrderBook::erase_level(
+    std::vector<PriceLevel>& levels,
+    std::vector<PriceLevel>::iterator it
+) {
+    ++level_erases_;
+    level_elements_shifted_ += static_cast<std::uint64_t>(levels.end() - it - 1);
+    return levels.erase(it);
 }
 
 std::vector<PriceLevel>::iterator OrderBook::find_level(
@@ -426,7 +603,7 @@ void OrderBook::remove_level_if_empty(
     std::vector<PriceLevel>::iterator it
 ) {
     if (it != levels.end() && it->empty()) {
-        levels.erase(it);
+        erase_level(levels, it);
     }
 }
 
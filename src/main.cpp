@@ -4,22 +4,42 @@
  * 
  * CLI flags:
  *   --orders N      Total orders to generate
- *   --traders T     Number of trader threads
+ *   --traders T     Number of trader threads (T > 1 uses the MPSC queue)
  *   --capacity C    Ring buffer capacity (must be power of 2)
  *   --seed S        Random seed
  *   --pin           Enable thread pinning
+ *   --huge-pages    Back order pool and queue with huge pages
+ *   --prefault      Fault in order book storage at startup
+ *   --wait W        Engine wait strategy: busy, yield, park, block
+ *   --clock C       Engine time source: system, tsc
+ *   --queue Q       Event queue: semaphore, lockfree
  *   --log FILE      Log file path
+ *   --journal FILE  Write-ahead journal of accepted events
+ *   --durability D  Journal durability: event, group, async
+ *   --checkpoint FILE  Periodic checkpoint (requires --journal)
+ *   --checkpoint-interval N  Journal records between checkpoints
+ *   --replicate SOCKET  Stream the journal to an in-process hot standby
+ *   --max-lag N     Events the standby may trail by
  */
 
 #include <ces/common/types.hpp>
 #include <ces/common/time.hpp>
 #include <ces/concurrency/spsc_semaphore_queue.hpp>
+#include <ces/concurrency/spsc_queue.hpp>
+#include <ces/concurrency/mpsc_queue.hpp>
 #include <ces/concurrency/pinning.hpp>
+#include <ces/concurrency/wait_strategy.hpp>
 #include <ces/engine/matching_engine.hpp>
 #include <ces/engine/trader.hpp>
+#include <ces/engine/journal.hpp>
+#include <ces/engine/checkpoint.hpp>
+#include <ces/engine/replication.hpp>
 #include <ces/logging/async_logger.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <thread>
@@ -31,7 +51,7 @@ using namespace ces;
 // Default configuration
 static constexpr std::size_t DEFAULT_QUEUE_CAPACITY = 65536;  // 64K
 static constexpr std::uint64_t DEFAULT_ORDERS = 10'000;
-static constexpr std::size_t DEFAULT_TRADERS = 1;  // Must be 1 for SPSC queue
+static constexpr std::size_t DEFAULT_TRADERS = 1;
 static constexpr std::uint64_t DEFAULT_SEED = 12345;
 
 struct Config {
@@ -39,17 +59,41 @@ struct Config {
     std::size_t traders{DEFAULT_TRADERS};
     std::uint64_t seed{DEFAULT_SEED};
     bool enable_pinning{false};
+    bool huge_pages{false};
+    bool prefault{false};
+    WaitStrategy wait{WaitStrategy::Blocking};
+    TimeSource clock{TimeSource::System};
+    bool lock_free_queue{false};
     std::string log_file;
+    std::string journal_file;
+    JournalDurability durability{JournalDurability::GroupCommit};
+    std::string checkpoint_file;
+    std::uint64_t checkpoint_interval{CheckpointConfig{}.interval};
+    std::string replication_socket;
+    std::uint64_t max_lag{ReplicationConfig{}.max_lag};
 };
 
 void print_usage(const char* program) {
     std::cout << "Usage: " << program << " [options]\n"
               << "\nOptions:\n"
               << "  --orders N      Total orders to generate (default: " << DEFAULT_ORDERS << ")\n"
-              << "  --traders T     Number of trader threads (default: " << DEFAULT_TRADERS << ")\n"
+              << "  --traders T     Number of trader threads (default: " << DEFAULT_TRADERS
+              << "; more than 1 uses the MPSC queue)\n"
               << "  --seed S        Random seed (default: " << DEFAULT_SEED << ")\n"
               << "  --pin           Enable thread pinning\n"
+              << "  --huge-pages    Back order pool and queue with huge pages\n"
+              << "  --prefault      Fault in order book storage at startup\n"
+              << "  --wait W        Engine wait strategy: busy, yield, park, block (default: block)\n"
+              << "  --clock C       Engine time source: system, tsc (default: system)\n"
+              << "  --queue Q       Event queue: semaphore, lockfree (default: semaphore)\n"
               << "  --log FILE      Log file path (default: none)\n"
+              << "  --journal FILE  Write-ahead journal of accepted events (default: none)\n"
+              << "  --durability D  Journal durability: event, group, async (default: group)\n"
+              << "  --checkpoint FILE  Periodic checkpoint, requires --journal (default: none)\n"
+              << "  --checkpoint-interval N  Journal records between checkpoints (default: "
+              << CheckpointConfig{}.interval << ")\n"
+              << "  --replicate SOCKET  Stream the journal to an in-process hot standby, requires --journal\n"
+              << "  --max-lag N     Events the standby may trail by (default: " << ReplicationConfig{}.max_lag << ")\n"
               << "  --help          Show this help message\n";
 }
 
@@ -67,8 +111,55 @@ Config parse_args(int argc, char* argv[]) {
             config.seed = std::stoull(argv[++i]);
         } else if (arg == "--pin") {
             config.enable_pinning = true;
+        } else if (arg == "--huge-pages") {
+            config.huge_pages = true;
+        } else if (arg == "--prefault") {
+            config.prefault = true;
+        } else if (arg == "--wait" && i + 1 < argc) {
+            auto strategy = parse_wait_strategy(argv[++i]);
+            if (!strategy) {
+                std::cerr << "Unknown wait strategy: " << argv[i] << "\n";
+                std::exit(1);
+            }
+            config.wait = *strategy;
+        } else if (arg == "--clock" && i + 1 < argc) {
+            auto source = parse_time_source(argv[++i]);
+            if (!source) {
+                std::cerr << "Unknown time source: " << argv[i] << "\n";
+                std::exit(1);
+            }
+            config.clock = *source;
+        } else if (arg == "--queue" && i + 1 < argc) {
+            std::string queue = argv[++i];
+            if (queue != "semaphore" && queue != "lockfree") {
+                std::cerr << "Unknown queue: " << queue << "\n";
+                std::exit(1);
+            }
+            config.lock_free_queue = (queue == "lockfree");
         } else if (arg == "--log" && i + 1 < argc) {
             config.log_file = argv[++i];
+        } else if (arg == "--journal" && i + 1 < argc) {
+            config.journal_file = argv[++i];
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            config.checkpoint_file = argv[++i];
+        } else if (arg == "--checkpoint-interval" && i + 1 < argc) {
+            config.checkpoint_interval = std::max<std::uint64_t>(std::stoull(argv[++i]), 1);
+        } else if (arg == "--replicate" && i + 1 < argc) {
+            config.replication_socket = argv[++i];
+        } else if (arg == "--max-lag" && i + 1 < argc) {
+            config.max_lag = std::max<std::uint64_t>(std::stoull(argv[++i]), 1);
+        } else if (arg == "--durability" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "event") {
+                config.durability = JournalDurability::PerEvent;
+            } else if (mode == "group") {
+                config.durability = JournalDurability::GroupCommit;
+            } else if (mode == "async") {
+                config.durability = JournalDurability::Async;
+            } else {
+                std::cerr << "Unknown journal durability: " << mode << "\n";
+                std::exit(1);
+            }
         } else if (arg == "--help") {
             print_usage(argv[0]);
             std::exit(0);
@@ -78,46 +169,134 @@ Config parse_args(int argc, char* argv[]) {
     return config;
 }
 
-int main(int argc, char* argv[]) {
-    try {
-        std::cout << "=== Concurrent Exchange Simulator ===\n" << std::endl;
-        
-        Config config = parse_args(argc, argv);
-        
-        std::cout << "Configuration:\n";
-        std::cout << "  Orders:      " << config.orders << "\n";
-        std::cout << "  Traders:     " << config.traders << "\n";
-        std::cout << "  Seed:        " << config.seed << "\n";
-        std::cout << "  Pinning:     " << (config.enable_pinning ? "enabled" : "disabled") << "\n";
-    std::cout << "  Log file:    " << (config.log_file.empty() ? "none" : config.log_file) << "\n";
-    std::cout << "  CPU cores:   " << get_num_cores() << "\n\n";
-    
-    // Create optional logger
-    std::unique_ptr<AsyncLogger> logger;
-    if (!config.log_file.empty()) {
-        logger = std::make_unique<AsyncLogger>(config.log_file);
-        std::cout << "Logging enabled: " << config.log_file << "\n";
-    }
-    
+/**
+ * @brief Run engine and traders over the given event queue type
+ */
+template<typename Queue>
+void run_simulation(const Config& config, AsyncLogger* logger) {
     // Create event queue
-    using Queue = SpscSemaphoreQueue<OrderEvent, DEFAULT_QUEUE_CAPACITY>;
-    Queue queue;
+    const AllocationPolicy memory_policy = config.huge_pages
+        ? AllocationPolicy::huge()
+        : AllocationPolicy::heap();
+    
+    Queue queue(memory_policy);
     
     // Create matching engine
     EngineConfig engine_config;
+    engine_config.memory_policy = memory_policy;
+    engine_config.prefault_book = config.prefault;
+    engine_config.wait.strategy = config.wait;
+    engine_config.time_source = config.clock;
     engine_config.enable_logging = !config.log_file.empty();
     if (config.enable_pinning && get_num_cores() > 1) {
         engine_config.pin_to_core = 0;  // Pin engine to core 0
     }
     
-    MatchingEngine<DEFAULT_QUEUE_CAPACITY> engine(queue, engine_config, logger.get());
+    Timestamp construct_start = now_ns();
+    MatchingEngine<DEFAULT_QUEUE_CAPACITY, Queue> engine(queue, engine_config, logger);
+    double startup_ms = static_cast<double>(now_ns() - construct_start) / 1e6;
+    
+    std::cout << "Engine startup:     " << startup_ms << " ms"
+              << (config.prefault ? " (prefaulted)" : " (lazy)") << "\n";
+    std::cout << "Engine wait:        " << to_string(config.wait) << "\n";
+    std::cout << "Engine clock:       " << to_string(engine.time_source());
+    if (engine.tsc_clock()) {
+        std::cout << " (" << engine.tsc_clock()->ticks_per_ns() << " ticks/ns)";
+    } else if (config.clock == TimeSource::Tsc) {
+        std::cout << " (no invariant TSC)";
+    }
+    std::cout << "\n";
+    std::cout << "Event queue:        "
+              << (config.traders > 1 ? "MPSC lock-free" : config.lock_free_queue ? "SPSC lock-free" : "SPSC semaphore")
+              << "\n";
+    std::cout << "Queue backing:      " << to_string(queue.backing()) << "\n";
+    std::cout << "Order pool backing: " << to_string(engine.book().pool_backing()) << "\n";
     
     // Start matching engine thread
+    // Execution reports: one outbound queue per trader
+    ReportRouter report_router;
+    std::vector<std::unique_ptr<ReportRouter::Queue>> report_queues;
+    for (std::size_t i = 0; i < config.traders; ++i) {
+        report_queues.push_back(std::make_unique<ReportRouter::Queue>());
+        report_router.attach(TraderId{static_cast<std::uint32_t>(i)}, *report_queues.back());
+    }
+    engine.set_report_router(&report_router);
+    
+    // Write-ahead journal sized for every generated order
+    Journal journal;
+    if (!config.journal_file.empty()) {
+        JournalConfig journal_config;
+        journal_config.capacity = std::max<std::uint64_t>(config.orders, 1);
+        journal_config.durability = config.durability;
+        const JournalResult result = journal.create(config.journal_file, journal_config);
+        if (result != JournalResult::Ok) {
+            throw std::runtime_error("Cannot create journal " + config.journal_file +
+                                     ": " + to_string(result));
+        }
+        engine.set_journal(&journal);
+        std::cout << "Journal:            " << config.journal_file
+                  << " (" << to_string(config.durability) << ")\n";
+    }
+    
+    std::unique_ptr<Checkpointer> checkpointer;
+    if (!config.checkpoint_file.empty() && journal.is_open()) {
+        checkpointer = std::make_unique<Checkpointer>(journal, CheckpointConfig{
+            .path = config.checkpoint_file,
+            .interval = config.checkpoint_interval
+        });
+        engine.set_checkpointer(checkpointer.get());
+        std::cout << "Checkpoint:         " << config.checkpoint_file
+                  << " (every " << config.checkpoint_interval << " records)\n";
+    }
+    
+    // Hot standby: a second engine fed by the journal stream over a Unix socket
+    std::unique_ptr<ReplicationPrimary> replication;
+    std::unique_ptr<Queue> standby_queue;
+    std::unique_ptr<MatchingEngine<DEFAULT_QUEUE_CAPACITY, Queue>> standby_engine;
+    std::unique_ptr<ReplicationStandby> standby;
+    std::jthread standby_thread;
+    if (!config.replication_socket.empty() && journal.is_open()) {
+        const ReplicationConfig replication_config{
+            .socket_path = config.replication_socket,
+            .max_lag = config.max_lag
+        };
+        replication = std::make_unique<ReplicationPrimary>(journal, replication_config);
+        if (const ReplicationResult result = replication->start(); result != ReplicationResult::Ok) {
+            throw std::runtime_error("Cannot listen on " + config.replication_socket + ": " + to_string(result));
+        }
+        engine.set_replication(replication.get());
+        
+        EngineConfig standby_config = engine_config;
+        standby_config.enable_logging = false;
+        standby_config.pin_to_core.reset();
+        standby_queue = std::make_unique<Queue>(memory_policy);
+        standby_engine = std::make_unique<MatchingEngine<DEFAULT_QUEUE_CAPACITY, Queue>>(*standby_queue, standby_config);
+        standby = std::make_unique<ReplicationStandby>(replication_config);
+        if (const ReplicationResult result = standby->connect(1); result != ReplicationResult::Ok) {
+            throw std::runtime_error("Standby cannot connect: " + std::string(to_string(result)));
+        }
+        standby_thread = std::jthread([&standby, &standby_engine](std::stop_token st) {
+            while (!st.stop_requested() && standby->connected()) {
+                standby->poll([&](const JournalRecord& record) { standby_engine->replay(record); });
+            }
+        });
+        std::cout << "Replication:        " << config.replication_socket
+                  << " (max lag " << config.max_lag << " events)\n";
+    }
+    
     std::cout << "Starting matching engine...\n";
     std::jthread engine_thread([&engine](std::stop_token st) {
         engine.run(st);
     });
     
+    // Housekeeping: grow the order pool ahead of demand, off the matching path
+    std::jthread housekeeping_thread([&engine](std::stop_token st) {
+        while (!st.stop_requested()) {
+            engine.maintain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    
     // Calculate orders per trader
     std::uint64_t orders_per_trader = config.orders / config.traders;
     std::uint64_t remaining_orders = config.orders % config.traders;
@@ -125,7 +304,7 @@ int main(int argc, char* argv[]) {
     // Create and start trader threads
     std::cout << "Starting " << config.traders << " trader threads...\n";
     
-    std::vector<std::unique_ptr<Trader<DEFAULT_QUEUE_CAPACITY>>> traders;
+    std::vector<std::unique_ptr<Trader<DEFAULT_QUEUE_CAPACITY, Queue>>> traders;
     std::vector<std::jthread> trader_threads;
     
     std::uint64_t next_order_id = 1;
@@ -140,8 +319,8 @@ int main(int argc, char* argv[]) {
             trader_config.pin_to_core = static_cast<std::uint32_t>(i + 1);
         }
         
-        traders.push_back(std::make_unique<Trader<DEFAULT_QUEUE_CAPACITY>>(
-            trader_config, queue, next_order_id
+        traders.push_back(std::make_unique<Trader<DEFAULT_QUEUE_CAPACITY, Queue>>(
+            trader_config, queue, next_order_id, report_queues[i].get()
         ));
         
         next_order_id += trader_config.orders_to_generate;
@@ -166,15 +345,52 @@ int main(int argc, char* argv[]) {
     std::cout << "All traders completed.\n";
     
     // Give engine time to process remaining events
+    // Trader threads are joined, so their report queues can be drained here
     std::cout << "Draining event queue...\n";
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const auto drain_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while (std::chrono::steady_clock::now() < drain_deadline) {
+        for (auto& trader : traders) {
+            trader->poll_reports();
+        }
+        std::this_thread::yield();
+    }
     
     // Stop engine
+    housekeeping_thread.request_stop();
+    housekeeping_thread.join();
     engine_thread.request_stop();
     engine_thread.join();
     
     Timestamp end_time = now_ns();
     
+    const std::uint64_t journal_syncs = journal.syncs();
+    const std::uint64_t journal_written = journal.written();
+    const bool journal_open = journal.is_open();
+    if (checkpointer) {
+        checkpointer->wait_idle();
+    }
+    const std::uint64_t state_hash = engine.state_hash();
+    
+    // Let the standby apply the tail, then stop streaming before the journal unmaps
+    std::uint64_t standby_hash = 0;
+    if (replication) {
+        const auto catch_up_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (standby->applied() < journal_written && standby->connected() &&
+               std::chrono::steady_clock::now() < catch_up_deadline) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        standby_thread.request_stop();
+        standby_thread.join();
+        standby_hash = standby_engine->state_hash();
+        replication->stop();
+    }
+    const JournalResult journal_close = journal_open ? journal.close(state_hash) : JournalResult::Ok;
+    
+    // Engine is stopped: pick up the last reports
+    for (auto& trader : traders) {
+        trader->poll_reports();
+    }
+    
     // Print results
     double total_time_s = static_cast<double>(end_time - start_time) / 1e9;
     double trader_time_s = static_cast<double>(traders_done_time - start_time) / 1e9;
@@ -189,22 +405,101 @@ int main(int argc, char* argv[]) {
     // Print engine stats
     engine.stats().print_summary();
     
+    std::uint64_t reports_received = 0;
+    LatencyStats round_trip;
+    for (const auto& trader : traders) {
+        reports_received += trader->reports_received();
+    }
+    if (!traders.empty()) {
+        round_trip = traders.front()->round_trip_stats();
+    }
+    std::cout << "\n=== Execution Reports ===\n";
+    std::cout << "  Sent:           " << report_router.sent() << "\n";
+    std::cout << "  Dropped:        " << report_router.dropped() << "\n";
+    std::cout << "  Received:       " << reports_received << "\n";
+    std::cout << "  Round trip (trader 0): p50 " << round_trip.p50_ns / 1000.0
+              << " us, p99 " << round_trip.p99_ns / 1000.0 << " us\n";
+    
+    if (journal_open) {
+        std::cout << "\n=== Journal ===\n";
+        std::cout << "  Records:        " << journal_written << "\n";
+        std::cout << "  Syncs:          " << journal_syncs << "\n";
+        std::cout << "  Close:          " << to_string(journal_close) << "\n";
+        std::cout << "  State hash:     " << std::hex << state_hash << std::dec << "\n";
+    }
+    if (replication) {
+        const LatencyStats lag = standby->lag_stats();
+        const LatencyStats stall = replication->stall_stats();
+        std::cout << "\n=== Replication ===\n";
+        std::cout << "  Applied:        " << standby->applied() << " of " << journal_written << "\n";
+        std::cout << "  Standby hash:   " << std::hex << standby_hash << std::dec
+                  << (standby_hash == state_hash ? " (matches)" : " (MISMATCH)") << "\n";
+        std::cout << "  Lag:            p50 " << lag.p50_ns / 1000.0 << " us, p99 " << lag.p99_ns / 1000.0
+                  << " us, max " << lag.max_ns / 1000.0 << " us\n";
+        std::cout << "  Primary stalls: " << replication->stalls() << " (" << ns_to_ms(replication->stall_ns())
+                  << " ms total, p99 " << stall.p99_ns / 1000.0 << " us)\n";
+    }
+    if (checkpointer) {
+        std::cout << "\n=== Checkpoints ===\n";
+        std::cout << "  Written:        " << checkpointer->written()
+                  << " (skipped " << checkpointer->skipped() << ", failed " << checkpointer->failed() << ")\n";
+        std::cout << "  Last seq:       " << checkpointer->last_seq() << "\n";
+        std::cout << "  Capture pause:  " << ns_to_us(checkpointer->last_capture_ns()) << " us\n";
+        std::cout << "  Write time:     " << ns_to_ms(checkpointer->last_write_ns()) << " ms\n";
+    }
+    
     // Print book state
     std::cout << "\n=== Final Book State ===\n";
     std::cout << "  Active orders:  " << engine.book().order_count() << "\n";
     std::cout << "  Bid levels:     " << engine.book().bid_levels() << "\n";
     std::cout << "  Ask levels:     " << engine.book().ask_levels() << "\n";
+    std::cout << "  Pool capacity:  " << engine.book().order_capacity()
+              << " (inline grows: " << engine.book().pool_inline_grows() << ")\n";
     
+    const Instrument& instrument = engine.instrument();
     auto best_bid = engine.book().best_bid();
     auto best_ask = engine.book().best_ask();
     if (best_bid) {
-        std::cout << "  Best bid:       " << best_bid->get() << "\n";
+        std::cout << "  Best bid:       " << instrument.raw_price(*best_bid) << "\n";
     }
     if (best_ask) {
-        std::cout << "  Best ask:       " << best_ask->get() << "\n";
+        std::cout << "  Best ask:       " << instrument.raw_price(*best_ask) << "\n";
     }
     if (auto spread = engine.book().spread()) {
-        std::cout << "  Spread:         " << *spread << "\n";
+        std::cout << "  Spread:         " << *spread << " ticks\n";
+    }
+    
+    engine.book().memory_stats().print();
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        std::cout << "=== Concurrent Exchange Simulator ===\n" << std::endl;
+        
+        Config config = parse_args(argc, argv);
+        
+        std::cout << "Configuration:\n";
+        std::cout << "  Orders:      " << config.orders << "\n";
+        std::cout << "  Traders:     " << config.traders << "\n";
+        std::cout << "  Seed:        " << config.seed << "\n";
+        std::cout << "  Pinning:     " << (config.enable_pinning ? "enabled" : "disabled") << "\n";
+    std::cout << "  Log file:    " << (config.log_file.empty() ? "none" : config.log_file) << "\n";
+    std::cout << "  CPU cores:   " << get_num_cores() << "\n\n";
+    
+    // Create optional logger
+    std::unique_ptr<AsyncLogger> logger;
+    if (!config.log_file.empty()) {
+        logger = std::make_unique<AsyncLogger>(config.log_file);
+        std::cout << "Logging enabled: " << config.log_file << "\n";
+    }
+    
+    // Several producers need the multi-producer queue regardless of --queue
+    if (config.traders > 1) {
+        run_simulation<MpscQueue<OrderEvent, DEFAULT_QUEUE_CAPACITY>>(config, logger.get());
+    } else if (config.lock_free_queue) {
+        run_simulation<SpscQueue<OrderEvent, DEFAULT_QUEUE_CAPACITY>>(config, logger.get());
+    } else {
+        run_simulation<SpscSemaphoreQueue<OrderEvent, DEFAULT_QUEUE_CAPACITY>>(config, logger.get());
     }
     
     if (logger) {
@@ -0,0 +1,113 @@
+/**
+ * @file mapped_file.cpp
+ * @brief Implementation of read-only memory-mapped files
+ */
+
+#include <ces/memory/mapped_file.hpp>
+
+#include <fstream>
+#include <utility>
+
+#if defined(__linux__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define CES_HAS_MMAP 1
+#else
+    #define CES_HAS_MMAP 0
+#endif
+
+namespace ces {
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , mapped_(std::exchange(other.mapped_, false))
+    , fallback_(std::move(other.fallback_)) {
+    if (!mapped_ && !fallback_.empty()) {
+        data_ = fallback_.data();
+    }
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+        fallback_ = std::move(other.fallback_);
+        if (!mapped_ && !fallback_.empty()) {
+            data_ = fallback_.data();
+        }
+    }
+    return *this;
+}
+
+std::optional<MappedFile> MappedFile::open_read(const std::string& path) noexcept {
+    MappedFile file;
+
+#if CES_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    file.size_ = static_cast<std::size_t>(st.st_size);
+    if (file.size_ > 0) {
+        void* ptr = ::mmap(nullptr, file.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) {
+            ::close(fd);
+            return std::nullopt;
+        }
+        // Whole file is read front to back
+        ::madvise(ptr, file.size_, MADV_SEQUENTIAL);
+        file.data_ = static_cast<const std::byte*>(ptr);
+        file.mapped_ = true;
+    }
+    ::close(fd);
+    return file;
+#else
+    try {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) {
+            return std::nullopt;
+        }
+        file.size_ = static_cast<std::size_t>(in.tellg());
+        file.fallback_.resize(file.size_);
+        in.seekg(0);
+        if (!in.read(reinterpret_cast<char*>(file.fallback_.data()),
+                     static_cast<std::streamsize>(file.size_))) {
+            return std::nullopt;
+        }
+        file.data_ = file.fallback_.data();
+        return file;
+    } catch (...) {
+        return std::nullopt;
+    }
+#endif
+}
+
+void MappedFile::release() noexcept {
+#if CES_HAS_MMAP
+    if (mapped_ && data_ != nullptr) {
+        ::munmap(const_cast<std::byte*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    fallback_.clear();
+}
+
+} // namespace ces
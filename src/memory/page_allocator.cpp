@@ -0,0 +1,169 @@
+/**
+ * @file page_allocator.cpp
+ * @brief Implementation of huge-page backed allocations
+ */
+
+#include <ces/memory/page_allocator.hpp>
+
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #define CES_HAS_MMAP 1
+#else
+    #define CES_HAS_MMAP 0
+#endif
+
+namespace ces {
+
+namespace {
+
+[[nodiscard]] std::size_t round_up(std::size_t value, std::size_t multiple) noexcept {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+#if CES_HAS_MMAP
+
+/// Map an anonymous region whose start is aligned to a huge page boundary
+[[nodiscard]] void* map_aligned(std::size_t bytes, int extra_flags) noexcept {
+    const std::size_t span = bytes + PageAllocation::HUGE_PAGE_SIZE;
+    void* raw = ::mmap(nullptr, span, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+
+    auto base = reinterpret_cast<std::uintptr_t>(raw);
+    auto aligned = round_up(base, PageAllocation::HUGE_PAGE_SIZE);
+
+    // Trim the unaligned head and the unused tail
+    if (aligned > base) {
+        ::munmap(raw, aligned - base);
+    }
+    std::size_t tail = (base + span) - (aligned + bytes);
+    if (tail > 0) {
+        ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+#endif
+
+} // namespace
+
+PageAllocation::PageAllocation(std::size_t bytes, const AllocationPolicy& policy)
+    : size_(bytes) {
+
+    if (bytes == 0) {
+        return;
+    }
+
+#if CES_HAS_MMAP
+    if (policy.huge_pages) {
+        mapped_ = round_up(bytes, HUGE_PAGE_SIZE);
+        const int populate = policy.prefault ? MAP_POPULATE : 0;
+
+        // 1. Explicit huge pages from the hugetlbfs pool
+        void* ptr = ::mmap(nullptr, mapped_, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+        if (ptr != MAP_FAILED) {
+            data_ = ptr;
+            backing_ = PageBacking::HugeTlb;
+        } else {
+            // 2. Transparent huge pages on a 2MB-aligned regular mapping
+            ptr = map_aligned(mapped_, 0);
+            if (ptr == nullptr) {
+                mapped_ = 0;
+                throw std::bad_alloc();
+            }
+            data_ = ptr;
+            backing_ = (::madvise(ptr, mapped_, MADV_HUGEPAGE) == 0)
+                ? PageBacking::TransparentHuge
+                : PageBacking::Regular;
+
+            // Populate after madvise so faults are served with huge pages
+            if (policy.prefault) {
+                prefault();
+            }
+        }
+
+        if (policy.lock) {
+            locked_ = (::mlock(data_, mapped_) == 0);
+        }
+        return;
+    }
+#endif
+
+    mapped_ = round_up(bytes, CACHE_LINE_SIZE);
+    data_ = ::operator new(mapped_, std::align_val_t{PAGE_SIZE});
+    backing_ = PageBacking::Heap;
+
+    if (policy.prefault) {
+        prefault();
+    }
+
+#if CES_HAS_MMAP
+    if (policy.lock) {
+        locked_ = (::mlock(data_, mapped_) == 0);
+    }
+#endif
+}
+
+PageAllocation::~PageAllocation() {
+    release();
+}
+
+PageAllocation::PageAllocation(PageAllocation&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , mapped_(std::exchange(other.mapped_, 0))
+    , backing_(other.backing_)
+    , locked_(std::exchange(other.locked_, false)) {
+}
+
+PageAllocation& PageAllocation::operator=(PageAllocation&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, 0);
+        backing_ = other.backing_;
+        locked_ = std::exchange(other.locked_, false);
+    }
+    return *this;
+}
+
+void PageAllocation::prefault() noexcept {
+    if (data_ == nullptr) {
+        return;
+    }
+
+    // One write per page is enough to fault it in; content is preserved
+    auto* bytes = static_cast<volatile unsigned char*>(data_);
+    for (std::size_t offset = 0; offset < mapped_; offset += PAGE_SIZE) {
+        bytes[offset] = bytes[offset];
+    }
+}
+
+void PageAllocation::release() noexcept {
+    if (data_ == nullptr) {
+        return;
+    }
+
+#if CES_HAS_MMAP
+    if (locked_) {
+        ::munlock(data_, mapped_);
+    }
+    if (backing_ != PageBacking::Heap) {
+        ::munmap(data_, mapped_);
+        data_ = nullptr;
+        return;
+    }
+#endif
+
+    ::operator delete(data_, std::align_val_t{PAGE_SIZE});
+    data_ = nullptr;
+}
+
+} // namespace ces
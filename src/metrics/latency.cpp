@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 
 namespace ces {
 
@@ -40,6 +41,28 @@ void EngineStats::print_summary() const {
     
     auto latency_stats = get_latency_stats();
     latency_stats.print();
+    
+    // One row per order type seen: p50 / p99 per stage
+    std::cout << "\n=== Latency by Stage (p50 / p99 µs) ===\n";
+    std::cout << "  " << std::left << std::setw(11) << "Type";
+    for (std::size_t s = 0; s < LATENCY_STAGE_COUNT; ++s) {
+        std::cout << std::setw(18) << to_string(static_cast<LatencyStage>(s));
+    }
+    std::cout << "\n";
+    const StageLatencyTable table = get_stage_table();
+    for (std::size_t t = 0; t < ORDER_TYPE_COUNT; ++t) {
+        if (table[t][0].count == 0) {
+            continue;
+        }
+        std::cout << "  " << std::setw(11) << to_string(static_cast<OrderType>(t));
+        for (const LatencyStats& stage : table[t]) {
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(2) << stage.p50_ns / 1000.0 << " / " << stage.p99_ns / 1000.0;
+            std::cout << std::setw(18) << (stage.count > 0 ? cell.str() : "-");
+        }
+        std::cout << "\n";
+    }
+    std::cout << std::right << "=======================================\n";
 }
 
 } // namespace ces
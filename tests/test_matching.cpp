@@ -6,13 +6,28 @@
 #include <gtest/gtest.h>
 
 #include <ces/engine/matching_engine.hpp>
+#include <ces/engine/pipeline_engine.hpp>
 #include <ces/engine/accounts.hpp>
+#include <ces/engine/trader.hpp>
+#include <ces/engine/journal.hpp>
+#include <ces/engine/checkpoint.hpp>
+#include <ces/engine/replication.hpp>
+#include <ces/common/tsc_clock.hpp>
 #include <ces/concurrency/spsc_semaphore_queue.hpp>
+#include <ces/concurrency/spsc_queue.hpp>
+#include <ces/concurrency/mpsc_queue.hpp>
 #include <ces/lob/order.hpp>
 #include <ces/common/types.hpp>
 
 #include <thread>
 #include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <vector>
 
 using namespace ces;
 
@@ -123,6 +138,858 @@ TEST_F(MatchingEngineTest, AccountsCreatedAutomatically) {
     EXPECT_NE(engine->accounts().get(TraderId{42}), nullptr);
 }
 
+TEST_F(MatchingEngineTest, OpenExposureTracksRestingOrders) {
+    auto open = [this](TraderId id) { return *engine->accounts().snapshot(id); };
+    
+    process_event(OrderEvent::new_limit(OrderId{1}, TraderId{0}, Side::Buy, Price{100}, Qty{10}));
+    EXPECT_EQ(open(TraderId{0}).open_buy_qty, 10);
+    EXPECT_EQ(open(TraderId{0}).open_buy_notional, 1000);
+    
+    // Partial fill of the resting buy; the taker's sell never rests
+    process_event(OrderEvent::new_limit(OrderId{2}, TraderId{1}, Side::Sell, Price{100}, Qty{4}));
+    EXPECT_EQ(open(TraderId{0}).open_buy_qty, 6);
+    EXPECT_EQ(open(TraderId{0}).open_buy_notional, 600);
+    EXPECT_EQ(open(TraderId{1}).open_sell_qty, 0);
+    
+    // Qty reduction in place, then a price change (cancel + re-add)
+    process_event(OrderEvent::modify(OrderId{1}, Qty{3}, Price{100}));
+    EXPECT_EQ(open(TraderId{0}).open_buy_notional, 300);
+    process_event(OrderEvent::modify(OrderId{1}, Qty{3}, Price{101}));
+    EXPECT_EQ(open(TraderId{0}).open_buy_qty, 3);
+    EXPECT_EQ(open(TraderId{0}).open_buy_notional, 303);
+    
+    // Sell rests partially after crossing: only the remainder is open
+    process_event(OrderEvent::new_limit(OrderId{3}, TraderId{1}, Side::Sell, Price{101}, Qty{5}));
+    EXPECT_EQ(open(TraderId{0}).open_buy_qty, 0);
+    EXPECT_EQ(open(TraderId{1}).open_sell_qty, 2);
+    EXPECT_EQ(open(TraderId{1}).open_sell_notional, 202);
+    
+    // Cancel without trader_id still releases the owner's exposure
+    process_event(OrderEvent::cancel(OrderId{3}));
+    EXPECT_EQ(open(TraderId{1}).open_sell_qty, 0);
+    EXPECT_EQ(open(TraderId{1}).open_sell_notional, 0);
+}
+
+TEST(RiskCheckerTest, PositionExposureAndBalanceIncludeOpenOrders) {
+    Accounts accounts(10);
+    accounts.create_account(TraderId{0}, 10'000);
+    RiskConfig config;
+    config.max_position = 100;
+    config.max_open_notional = 5'000;
+    RiskChecker risk(config, &accounts);
+    
+    auto buy = [](Qty qty, Price price) {
+        return OrderEvent::new_limit(OrderId{1}, TraderId{0}, Side::Buy, price, qty);
+    };
+    auto sell = [](Qty qty, Price price) {
+        return OrderEvent::new_limit(OrderId{1}, TraderId{0}, Side::Sell, price, qty);
+    };
+    
+    EXPECT_EQ(risk.check(buy(Qty{40}, Price{10})), RiskResult::Passed);
+    
+    // 60 open buys + 41 more would exceed the 100 position limit if all filled
+    accounts.adjust_open(TraderId{0}, Side::Buy, 60, Price{10});
+    EXPECT_EQ(risk.check(buy(Qty{41}, Price{10})), RiskResult::ExceedsMaxPosition);
+    EXPECT_EQ(risk.check(buy(Qty{40}, Price{10})), RiskResult::Passed);
+    // Sells are bounded by open sells, not open buys
+    EXPECT_EQ(risk.check(sell(Qty{100}, Price{10})), RiskResult::Passed);
+    
+    // Resting notional 600 + 4500 exceeds 5000
+    EXPECT_EQ(risk.check(sell(Qty{90}, Price{50})), RiskResult::ExceedsMaxExposure);
+    
+    // Balance 10'000 minus 600 committed to open buys
+    config.max_open_notional = 1'000'000;
+    config.max_position = 1'000'000;
+    risk.set_config(config);
+    EXPECT_EQ(risk.check(buy(Qty{94}, Price{100})), RiskResult::Passed);
+    EXPECT_EQ(risk.check(buy(Qty{95}, Price{100})), RiskResult::InsufficientBalance);
+    
+    accounts.adjust_open(TraderId{0}, Side::Buy, -60, Price{10});
+    EXPECT_EQ(risk.check(buy(Qty{100}, Price{100})), RiskResult::Passed);
+}
+
+TEST(RiskCheckerTest, ModifyLimitedByChangeFromRestingOrder) {
+    Accounts accounts(10);
+    accounts.create_account(TraderId{0}, 10'000);
+    RiskConfig config;
+    config.max_position = 100;
+    config.max_open_notional = 1'000'000;
+    RiskChecker risk(config, &accounts);
+    
+    // Resting buy of 60 @ 10, already counted as open
+    const Order resting(OrderId{1}, TraderId{0}, Side::Buy, Price{10}, Qty{60});
+    accounts.adjust_open(TraderId{0}, Side::Buy, 60, Price{10});
+    auto modify = [](Qty qty, Price price) {
+        return OrderEvent::modify(OrderId{1}, qty, price, TraderId{0});
+    };
+    
+    // Growing to 100 replaces the 60, it does not add to them
+    EXPECT_EQ(risk.check(modify(Qty{100}, Price{10}), &resting), RiskResult::Passed);
+    EXPECT_EQ(risk.check(modify(Qty{101}, Price{10}), &resting), RiskResult::ExceedsMaxPosition);
+    
+    // Balance covers 10'000 of buys; the 600 resting are released
+    EXPECT_EQ(risk.check(modify(Qty{100}, Price{100}), &resting), RiskResult::Passed);
+    config.max_position = 1'000;
+    risk.set_config(config);
+    EXPECT_EQ(risk.check(modify(Qty{101}, Price{100}), &resting), RiskResult::InsufficientBalance);
+    
+    // Open notional limit applies to the change too
+    config.max_open_notional = 5'000;
+    risk.set_config(config);
+    EXPECT_EQ(risk.check(modify(Qty{50}, Price{100}), &resting), RiskResult::Passed);
+    EXPECT_EQ(risk.check(modify(Qty{51}, Price{100}), &resting), RiskResult::ExceedsMaxExposure);
+    
+    // Per-order limits still apply, and an unknown order is left to the book
+    EXPECT_EQ(risk.check(modify(Qty{config.max_order_qty.get() + 1}, Price{10}), &resting),
+              RiskResult::InvalidQty);
+    EXPECT_EQ(risk.check(modify(Qty{1'000}, Price{10})), RiskResult::Passed);
+}
+
+TEST(RiskCheckerTest, TokenBucketThrottlesPerTraderAndMessageType) {
+    RiskConfig config;
+    config.check_balance = false;
+    config.throttle.new_orders_per_sec = 10;  // One per 100 ms
+    config.throttle.new_order_burst = 2;
+    config.throttle.cancels_per_sec = 1000;
+    RiskChecker risk(config);
+    
+    constexpr Timestamp MS = 1'000'000;
+    auto at = [](OrderEvent event, Timestamp t) {
+        event.enqueue_time = t;
+        return event;
+    };
+    auto order = [&](TraderId trader, Timestamp t) {
+        return at(OrderEvent::new_limit(OrderId{1}, trader, Side::Buy, Price{100}, Qty{1}), t);
+    };
+    const Timestamp t0 = 10'000 * MS;
+    
+    // Burst of two, then throttled until the bucket refills
+    EXPECT_EQ(risk.check(order(TraderId{0}, t0)), RiskResult::Passed);
+    EXPECT_EQ(risk.check(order(TraderId{0}, t0)), RiskResult::Passed);
+    EXPECT_EQ(risk.check(order(TraderId{0}, t0 + 50 * MS)), RiskResult::RateLimited);
+    EXPECT_EQ(risk.check(order(TraderId{0}, t0 + 100 * MS)), RiskResult::Passed);
+    EXPECT_EQ(risk.check(order(TraderId{0}, t0 + 100 * MS)), RiskResult::RateLimited);
+    
+    // Other traders and cancels have their own buckets
+    EXPECT_EQ(risk.check(order(TraderId{1}, t0 + 100 * MS)), RiskResult::Passed);
+    EXPECT_EQ(risk.check(at(OrderEvent::cancel(OrderId{1}, TraderId{0}), t0 + 100 * MS)),
+              RiskResult::Passed);
+    
+    // Per-trader override: unlimited new orders, no cancels beyond 1/s
+    EXPECT_TRUE(risk.set_trader_limits(TraderId{0}, ThrottleLimits{.cancels_per_sec = 1}));
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(risk.check(order(TraderId{0}, t0 + 100 * MS)), RiskResult::Passed);
+    }
+    auto cancel = at(OrderEvent::cancel(OrderId{1}, TraderId{0}), t0 + 200 * MS);
+    EXPECT_EQ(risk.check(cancel), RiskResult::Passed);
+    EXPECT_EQ(risk.check(cancel), RiskResult::RateLimited);
+    
+    // A cancel without a trader is charged to the resting order's owner
+    const Order resting(OrderId{1}, TraderId{0}, Side::Buy, Price{100}, Qty{1});
+    auto anonymous = at(OrderEvent::cancel(OrderId{1}), t0 + 200 * MS);
+    EXPECT_EQ(risk.check(anonymous, &resting), RiskResult::RateLimited);
+    EXPECT_EQ(risk.check(at(OrderEvent::cancel(OrderId{1}), t0 + 1200 * MS), &resting),
+              RiskResult::Passed);
+    EXPECT_EQ(risk.check(cancel), RiskResult::RateLimited);
+    
+    // Outside the table: not throttled
+    EXPECT_FALSE(risk.set_trader_limits(TraderId{static_cast<std::uint32_t>(config.throttle_traders)}, {}));
+}
+
+TEST(AccountsTest, SparseIdsAcrossPages) {
+    Accounts accounts(10);
+    const TraderId low{3};
+    const TraderId high{std::numeric_limits<std::uint32_t>::max() - 1};
+    const TraderId next_page{static_cast<std::uint32_t>(Accounts::PAGE_SIZE + 3)};
+    
+    EXPECT_TRUE(accounts.create_account(low, 100));
+    EXPECT_TRUE(accounts.create_account(high, 200));
+    EXPECT_FALSE(accounts.create_account(low, 999));  // Already exists
+    
+    EXPECT_EQ(accounts.get_balance(low), 100);
+    EXPECT_EQ(accounts.get_balance(high), 200);
+    EXPECT_EQ(accounts.get(next_page), nullptr);  // Same slot, other page
+    EXPECT_EQ(accounts.get_or_create(next_page, 300)->balance.load(), 300);
+    EXPECT_EQ(accounts.size(), 3u);
+    
+    accounts.apply_trade(low, high, Side::Buy, Price{10}, Qty{2});
+    EXPECT_EQ(accounts.get_position(high), 2);
+    EXPECT_EQ(accounts.get_position(low), -2);
+    
+    accounts.clear();
+    EXPECT_EQ(accounts.size(), 0u);
+    EXPECT_EQ(accounts.get(low), nullptr);
+    EXPECT_EQ(accounts.get(high), nullptr);
+}
+
+TEST(AccountsTest, CapacityLimit) {
+    Accounts accounts(2);
+    EXPECT_NE(accounts.get_or_create(TraderId{0}), nullptr);
+    EXPECT_NE(accounts.get_or_create(TraderId{1}), nullptr);
+    EXPECT_EQ(accounts.get_or_create(TraderId{2}), nullptr);
+    EXPECT_NE(accounts.get_or_create(TraderId{1}), nullptr);  // Existing still found
+}
+
+TEST(AccountsTest, SingleWriterSnapshotsAreConsistent) {
+    Accounts accounts(2, AccountsMode::SingleWriter);
+    constexpr std::int64_t START = 1'000'000;
+    constexpr Price PRICE{7};
+    accounts.create_account(TraderId{0}, START);
+    accounts.create_account(TraderId{1}, START);
+    
+    // Every trade is at one price, so balance + position * price is invariant
+    std::atomic<bool> done{false};
+    std::jthread writer([&]() {
+        for (int i = 0; i < 200'000; ++i) {
+            const Side side = (i % 3 == 0) ? Side::Sell : Side::Buy;
+            accounts.apply_trade(TraderId{0}, TraderId{1}, side, PRICE, Qty{1 + i % 5});
+            if (i % 256 == 0) {
+                std::this_thread::yield();
+            }
+        }
+        done.store(true);
+    });
+    
+    std::uint64_t reads = 0;
+    while (!done.load() || reads == 0) {
+        auto snap = accounts.snapshot(TraderId{1});
+        ASSERT_TRUE(snap.has_value());
+        ASSERT_EQ(snap->balance + snap->position * PRICE.get(), START);
+        ++reads;
+        std::this_thread::yield();
+    }
+    writer.join();
+    
+    auto final_snap = accounts.snapshot(TraderId{1});
+    EXPECT_EQ(final_snap->trade_count, 200'000u);
+    EXPECT_EQ(final_snap->position, accounts.get_position(TraderId{1}));
+    EXPECT_EQ(accounts.snapshot(TraderId{0})->position, -final_snap->position);
+    EXPECT_FALSE(accounts.snapshot(TraderId{5}).has_value());
+}
+
+// ============================================================================
+// Trading Controls Tests
+// ============================================================================
+
+TEST_F(MatchingEngineTest, DynamicPriceBandRejectsOutsideOrders) {
+    auto& controls = engine->controls();
+    controls.publish(controls.get()->with_band(Price{1000}, 500));  // +/- 5%
+    EXPECT_EQ(controls.get()->band_low.get(), 950);
+    EXPECT_EQ(controls.get()->band_high.get(), 1050);
+    
+    process_event(OrderEvent::new_limit(OrderId{1}, TraderId{0}, Side::Buy, Price{950}, Qty{1}));
+    process_event(OrderEvent::new_limit(OrderId{2}, TraderId{0}, Side::Buy, Price{949}, Qty{1}));
+    process_event(OrderEvent::new_limit(OrderId{3}, TraderId{0}, Side::Sell, Price{1051}, Qty{1}));
+    EXPECT_EQ(engine->book().order_count(), 1);
+    EXPECT_EQ(engine->stats().rejected_count.load(), 2);
+    
+    // Re-centre the band: 1051 is now inside
+    controls.publish(controls.get()->with_band(Price{1100}, 500));
+    process_event(OrderEvent::new_limit(OrderId{4}, TraderId{0}, Side::Sell, Price{1051}, Qty{1}));
+    EXPECT_EQ(engine->book().order_count(), 2);
+}
+
+TEST_F(MatchingEngineTest, HaltQueueModeParksOrdersUntilResume) {
+    process_event(OrderEvent::new_limit(OrderId{1}, TraderId{0}, Side::Buy, Price{100}, Qty{5}));
+    
+    auto& controls = engine->controls();
+    controls.publish(controls.get()->with_halt(true, HaltAction::Queue));
+    
+    process_event(OrderEvent::new_limit(OrderId{2}, TraderId{1}, Side::Sell, Price{100}, Qty{5}));
+    process_event(OrderEvent::new_limit(OrderId{3}, TraderId{1}, Side::Sell, Price{101}, Qty{5}));
+    EXPECT_EQ(engine->halted_events(), 2u);
+    EXPECT_EQ(engine->stats().trade_count.load(), 0);
+    
+    // Cancels still go through during a halt
+    process_event(OrderEvent::cancel(OrderId{1}));
+    EXPECT_EQ(engine->book().order_count(), 0);
+    EXPECT_FALSE(engine->release_halted());
+    
+    // Resume: parked orders are processed in arrival order
+    controls.publish(controls.get()->with_halt(false));
+    EXPECT_TRUE(engine->release_halted());
+    EXPECT_EQ(engine->halted_events(), 0u);
+    EXPECT_EQ(engine->book().order_count(), 2);
+    EXPECT_EQ(engine->book().best_ask()->get(), 100);
+    EXPECT_EQ(engine->stats().rejected_count.load(), 0);
+}
+
+TEST(MatchingEngineHaltTest, ParkedOrdersAreAmendableBoundedAndThrottledOnce) {
+    using Queue = SpscSemaphoreQueue<OrderEvent, TEST_QUEUE_CAPACITY>;
+    Queue queue;
+    EngineConfig config;
+    config.max_orders = 1000;
+    config.risk.check_balance = false;
+    config.risk.throttle.new_orders_per_sec = 1;
+    config.risk.throttle.new_order_burst = 2;
+    config.halt_queue_capacity = 3;
+    MatchingEngine<TEST_QUEUE_CAPACITY> engine(queue, config);
+    
+    const Timestamp t0 = now_ns();
+    auto at_t0 = [t0](OrderEvent event) {
+        event.enqueue_time = t0;
+        return event;
+    };
+    
+    auto& controls = engine.controls();
+    controls.publish(controls.get()->with_halt(true, HaltAction::Queue));
+    engine.process_event(at_t0(OrderEvent::new_limit(OrderId{1}, TraderId{0}, Side::Buy, Price{100}, Qty{5})));
+    engine.process_event(at_t0(OrderEvent::new_limit(OrderId{2}, TraderId{0}, Side::Sell, Price{101}, Qty{5})));
+    engine.process_event(at_t0(OrderEvent::new_limit(OrderId{3}, TraderId{1}, Side::Sell, Price{102}, Qty{5})));
+    
+    // Park buffer full: rejected as Halted rather than grown
+    engine.process_event(at_t0(OrderEvent::new_limit(OrderId{4}, TraderId{1}, Side::Sell, Price{102}, Qty{5})));
+    EXPECT_EQ(engine.halted_events(), 3u);
+    EXPECT_EQ(engine.stats().rejected_count.load(), 1);
+    
+    // Cancel and modify act on the parked orders
+    engine.process_event(at_t0(OrderEvent::cancel(OrderId{1})));
+    engine.process_event(at_t0(OrderEvent::modify(OrderId{2}, Qty{7}, Price{103}, TraderId{0})));
+    EXPECT_EQ(engine.halted_events(), 2u);
+    
+    // Trader 0 used no token while parked, so its burst of two covers the
+    // modify-amended order on release
+    controls.publish(controls.get()->with_halt(false));
+    EXPECT_TRUE(engine.release_halted());
+    EXPECT_EQ(engine.stats().rejected_count.load(), 1);
+    EXPECT_EQ(engine.book().order_count(), 2);
+    EXPECT_FALSE(engine.book().has_order(OrderId{1}));
+    const auto modified = engine.book().find_order(OrderId{2});
+    ASSERT_TRUE(modified.has_value());
+    EXPECT_EQ(modified->qty_remaining.get(), 7);
+    EXPECT_EQ(modified->price.get(), 103);
+}
+
+TEST(TradingControlsTest, MarketHaltAppliesToEveryEngineOnNextEvent) {
+    constexpr std::size_t Capacity = 1024;
+    using Queue = SpscQueue<OrderEvent, Capacity>;
+    Queue queue_a;
+    Queue queue_b;
+    EngineConfig config;
+    config.wait.strategy = WaitStrategy::SpinYield;
+    MatchingEngine<Capacity, Queue> engine_a(queue_a, config);
+    MatchingEngine<Capacity, Queue> engine_b(queue_b, config);
+    
+    MarketControlsHandle market;
+    engine_a.set_market_controls(&market);
+    engine_b.set_market_controls(&market);
+    
+    std::jthread thread_a([&](std::stop_token st) { engine_a.run(st); });
+    std::jthread thread_b([&](std::stop_token st) { engine_b.run(st); });
+    
+    auto wait_for = [](auto& engine, std::uint64_t done) {
+        while (engine.events_processed() + engine.stats().rejected_count.load() < done) {
+            std::this_thread::yield();
+        }
+    };
+    
+    // Published from this thread before the events are queued
+    market.publish(MarketControls{.halted = true});
+    queue_a.push(OrderEvent::new_limit(OrderId{1}, TraderId{0}, Side::Buy, Price{100}, Qty{1}));
+    queue_b.push(OrderEvent::new_limit(OrderId{1}, TraderId{0}, Side::Buy, Price{100}, Qty{1}));
+    wait_for(engine_a, 1);
+    wait_for(engine_b, 1);
+    EXPECT_EQ(engine_a.stats().rejected_count.load(), 1);
+    EXPECT_EQ(engine_b.stats().rejected_count.load(), 1);
+    
+    market.publish(MarketControls{.halted = false});
+    queue_a.push(OrderEvent::new_limit(OrderId{2}, TraderId{0}, Side::Buy, Price{100}, Qty{1}));
+    wait_for(engine_a, 2);
+    EXPECT_EQ(engine_a.events_processed(), 1u);
+    EXPECT_EQ(market.version(), 2u);
+    
+    thread_a.request_stop();
+    thread_b.request_stop();
+}
+
+// ============================================================================
+// Journal Tests
+// ============================================================================
+
+class JournalTest : public MatchingEngineTest {
+protected:
+    std::string path = (std::filesystem::temp_directory_path() /
+        ("ces_journal_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + ".bin")).string();
+    
+    void TearDown() override {
+        std::remove(path.c_str());
+        std::remove((path + ".copy").c_str());
+        std::remove((path + ".ckpt").c_str());
+    }
+};
+
+TEST_F(JournalTest, RecordsAcceptedEventsInOrder) {
+    Journal journal;
+    ASSERT_EQ(journal.create(path, JournalConfig{.capacity = 16}), JournalResult::Ok);
+    engine->set_journal(&journal);
+    engine->controls().publish(engine->controls().get()->with_band(Price{100}, 1000));
+    
+    process_event(OrderEvent::new_limit(OrderId{1}, TraderId{1}, Side::Buy, Price{100}, Qty{10}));
+    process_event(OrderEvent::new_limit(OrderId{2}, TraderId{1}, Side::Buy, Price{500}, Qty{10}));  // Band reject
+    process_event(OrderEvent::new_limit(OrderId{3}, TraderId{2}, Side::Sell, Price{100}, Qty{4}));
+    process_event(OrderEvent::cancel(OrderId{1}, TraderId{1}));
+    EXPECT_EQ(journal.written(), 3u);
+    
+    // Journaling is timed apart from matching; the band reject skips both
+    EXPECT_EQ(engine->stats().get_stage_stats(OrderType::NewLimit, LatencyStage::Journal).count, 2u);
+    EXPECT_EQ(engine->stats().get_stage_stats(OrderType::NewLimit, LatencyStage::Matching).count, 2u);
+    EXPECT_EQ(engine->stats().get_stage_stats(OrderType::Cancel, LatencyStage::Journal).count, 1u);
+    ASSERT_EQ(journal.close(), JournalResult::Ok);
+    
+    JournalResult result;
+    auto reader = JournalReader::open(path, result);
+    ASSERT_TRUE(reader) << to_string(result);
+    EXPECT_TRUE(reader->clean_close());
+    ASSERT_EQ(reader->count(), 3u);
+    EXPECT_EQ(reader->record(0).event.order_id, OrderId{1});
+    EXPECT_EQ(reader->record(1).event.order_id, OrderId{3});
+    EXPECT_EQ(reader->record(1).event.qty.get(), 4);
+    EXPECT_EQ(reader->record(2).event.type, OrderType::Cancel);
+    EXPECT_EQ(reader->record(2).seq, 3u);
+    EXPECT_LE(reader->record(0).timestamp, reader->record(2).timestamp);
+}
+
+TEST_F(JournalTest, EventsThatCannotBeJournaledAreNotApplied) {
+    Journal journal;
+    ASSERT_EQ(journal.create(path, JournalConfig{.capacity = 2}), JournalResult::Ok);
+    engine->set_journal(&journal);
+    
+    ReportRouter router;
+    ReportRouter::Queue reports;
+    router.attach(TraderId{1}, reports);
+    engine->set_report_router(&router);
+    
+    process_event(OrderEvent::new_limit(OrderId{1}, TraderId{1}, Side::Buy, Price{100}, Qty{10}));
+    process_event(OrderEvent::new_limit(OrderId{2}, TraderId{1}, Side::Buy, Price{99}, Qty{10}));
+    
+    // Full: the order is rejected, not applied without a record
+    process_event(OrderEvent::new_limit(OrderId{3}, TraderId{1}, Side::Buy, Price{98}, Qty{10}));
+    process_event(OrderEvent::cancel(OrderId{1}, TraderId{1}));
+    EXPECT_EQ(journal.overflowed(), 2u);
+    EXPECT_EQ(engine->book().order_count(), 2u);
+    EXPECT_TRUE(engine->book().has_order(OrderId{1}));
+    EXPECT_EQ(engine->stats().rejected_count.load(), 2);
+    
+    ExecutionReport report;
+    ASSERT_TRUE(reports.try_pop(report));
+    ASSERT_TRUE(reports.try_pop(report));
+    ASSERT_TRUE(reports.try_pop(report));
+    EXPECT_EQ(report.order_id, OrderId{3});
+    EXPECT_EQ(report.type, ExecType::Rejected);
+    EXPECT_EQ(report.risk, RiskResult::JournalUnavailable);
+    
+    // Journal and book still agree
+    engine->set_journal(nullptr);
+    ASSERT_EQ(journal.close(engine->state_hash()), JournalResult::Ok);
+    JournalResult result;
+    auto reader = JournalReader::open(path, result);
+    ASSERT_TRUE(reader) << to_string(result);
+    EXPECT_EQ(reader->count(), 2u);
+    Queue replay_queue;
+    EngineConfig config;
+    config.max_traders = 100;
+    MatchingEngine<TEST_QUEUE_CAPACITY> replayed(replay_queue, config);
+    for (std::uint64_t i = 0; i < reader->count(); ++i) {
+        replayed.replay(reader->record(i));
+    }
+    EXPECT_EQ(replayed.state_hash(), reader->state_hash());
+}
+
+TEST_F(JournalTest, ReplayReproducesRecordedStateHash) {
+    Journal journal;
+    ASSERT_EQ(journal.create(path, JournalConfig{.capacity = 64}), JournalResult::Ok);
+    engine->set_journal(&journal);
+    engine->controls().publish(engine->controls().get()->with_band(Price{100}, 1000));
+    
+    process_event(OrderEvent::new_limit(OrderId{1}, TraderId{1}, Side::Buy, Price{100}, Qty{10}));
+    process_event(OrderEvent::new_limit(OrderId{2}, TraderId{2}, Side::Buy, Price{99}, Qty{5}));
+    process_event(OrderEvent::new_limit(OrderId{3}, TraderId{9}, Side::Buy, Price{500}, Qty{5}));  // Rejected
+    process_event(OrderEvent::new_limit(OrderId{4}, TraderId{3}, Side::Sell, Price{100}, Qty{4}));
+    process_event(OrderEvent::modify(OrderId{2}, Qty{3}, Price{98}, TraderId{2}));
+    process_event(OrderEvent::new_market(OrderId{5}, TraderId{3}, Side::Sell, Qty{8}));
+    process_event(OrderEvent::new_limit(OrderId{6}, TraderId{4}, Side::Sell, Price{105}, Qty{7}));
+    process_event(OrderEvent::cancel(OrderId{6}, TraderId{4}));
+    
+    const std::uint64_t live_hash = engine->state_hash();
+    ASSERT_EQ(journal.close(live_hash), JournalResult::Ok);
+    
+    JournalResult result;
+    auto reader = JournalReader::open(path, result);
+    ASSERT_TRUE(reader) << to_string(result);
+    ASSERT_EQ(reader->state_hash(), live_hash);
+    EXPECT_EQ(reader->count(), 7u);
+    
+    Queue replay_queue;
+    EngineConfig config;
+    config.max_traders = 100;
+    MatchingEngine<TEST_QUEUE_CAPACITY> replayed(replay_queue, config);
+    for (std::uint64_t i = 0; i < reader->count(); ++i) {
+        replayed.replay(reader->record(i));
+    }
+    EXPECT_EQ(replayed.state_hash(), live_hash);
+    EXPECT_EQ(replayed.book().order_count(), engine->book().order_count());
+    EXPECT_EQ(replayed.accounts().get_position(TraderId{3}), engine->accounts().get_position(TraderId{3}));
+    
+    // Dropping one record diverges
+    MatchingEngine<TEST_QUEUE_CAPACITY> partial(replay_queue, config);
+    for (std::uint64_t i = 0; i + 1 < reader->count(); ++i) {
+        partial.replay(reader->record(i));
+    }
+    EXPECT_NE(partial.state_hash(), live_hash);
+}
+
+TEST_F(JournalTest, ReplayedTradesKeepAcceptanceTime) {
+    Journal journal;
+    ASSERT_EQ(journal.create(path, JournalConfig{.capacity = 8}), JournalResult::Ok);
+    ASSERT_TRUE(journal.append(OrderEvent::new_limit(OrderId{1}, TraderId{1}, Side::Sell, Price{100}, Qty{5}), 1'000));
+    ASSERT_TRUE(journal.append(OrderEvent::new_limit(OrderId{2}, TraderId{2}, Side::Buy, Price{100}, Qty{5}), 2'000));
+    ASSERT_EQ(journal.close(), JournalResult::Ok);
+
+    JournalResult result;
+    auto reader = JournalReader::open(path, result);
+    ASSERT_TRUE(reader) << to_string(result);
+
+    Queue replay_queue;
+    MatchingEngine<TEST_QUEUE_CAPACITY> replayed(replay_queue, EngineConfig{});
+    std::vector<Timestamp> trade_times;
+    replayed.book().set_trade_callback([&](const Trade& trade) { trade_times.push_back(trade.timestamp); });
+    for (std::uint64_t i = 0; i < reader->count(); ++i) {
+        replayed.replay(reader->record(i));
+    }
+    ASSERT_EQ(trade_times.size(), 1u);
+    EXPECT_EQ(trade_times[0], Timestamp{2'000});
+}
+
+TEST_F(JournalTest, CheckpointPlusJournalTailRecovers) {
+    Journal journal;
+    ASSERT_EQ(journal.create(path, JournalConfig{.capacity = 64}), JournalResult::Ok);
+    engine->set_journal(&journal);
+    Checkpointer checkpointer(journal, CheckpointConfig{.path = path + ".ckpt", .interval = 5});
+    engine->set_checkpointer(&checkpointer);
+    
+    std::uint64_t id = 1;
+    for (int i = 0; i < 5; ++i) {
+        process_event(OrderEvent::new_limit(OrderId{id++}, TraderId{1}, Side::Buy, Price{100 - i}, Qty{10}));
+    }
+    checkpointer.wait_idle();
+    EXPECT_EQ(checkpointer.written(), 1u);
+    EXPECT_EQ(checkpointer.last_seq(), 5u);  // Taken right after the 5th record
+    
+    // Tail after the checkpoint: fills, a cancel and a modify
+    process_event(OrderEvent::new_limit(OrderId{id++}, TraderId{2}, Side::Sell, Price{99}, Qty{15}));
+    process_event(OrderEvent::cancel(OrderId{3}, TraderId{1}));
+    process_event(OrderEvent::modify(OrderId{4}, Qty{4}, Price{97}, TraderId{1}));
+    
+    const std::uint64_t live_hash = engine->state_hash();
+    ASSERT_EQ(journal.close(live_hash), JournalResult::Ok);
+    
+    JournalResult result;
+    auto reader = JournalReader::open(path, result);
+    ASSERT_TRUE(reader) << to_string(result);
+    
+    Queue recovery_queue;
+    EngineConfig config;
+    config.max_traders = 100;
+    MatchingEngine<TEST_QUEUE_CAPACITY> recovered(recovery_queue, config);
+    const RecoveryResult recovery = recovered.recover(path + ".ckpt", *reader);
+    ASSERT_EQ(recovery.result, SnapshotResult::Ok);
+    EXPECT_EQ(recovery.checkpoint_seq, 5u);
+    EXPECT_EQ(recovery.replayed, 3u);
+    EXPECT_EQ(recovered.state_hash(), live_hash);
+    EXPECT_EQ(recovered.events_processed(), engine->events_processed());
+    
+    MatchingEngine<TEST_QUEUE_CAPACITY> missing(recovery_queue, config);
+    EXPECT_EQ(missing.recover(path + ".none", *reader).result, SnapshotResult::IoError);
+}
+
+TEST_F(JournalTest, CheckpointWaitsForJournalRecordsItCovers) {
+    // Async never marks records durable on its own: the checkpoint is
+    // captured ahead of the journal flush
+    Journal journal;
+    ASSERT_EQ(journal.create(path, JournalConfig{.capacity = 64, .durability = JournalDurability::Async,
+                                                 .flush_interval = std::chrono::hours{1}}), JournalResult::Ok);
+    engine->set_journal(&journal);
+    Checkpointer checkpointer(journal, CheckpointConfig{.path = path + ".ckpt", .interval = 3});
+    engine->set_checkpointer(&checkpointer);
+    
+    for (std::uint64_t i = 1; i <= 3; ++i) {
+        process_event(OrderEvent::new_limit(OrderId{i}, TraderId{1}, Side::Buy, Price{100}, Qty{1}));
+    }
+    checkpointer.wait_idle();
+    ASSERT_EQ(checkpointer.written(), 1u);
+    EXPECT_EQ(checkpointer.last_seq(), 3u);
+    EXPECT_GE(journal.durable(), checkpointer.last_seq());
+    EXPECT_EQ(journal.close(), JournalResult::Ok);
+}
+
+TEST_F(JournalTest, StandbyTracksPrimaryWithinLagBound) {
+    Journal journal;
+    ASSERT_EQ(journal.create(path, JournalConfig{.capacity = 256}), JournalResult::Ok);
+    engine->set_journal(&journal);
+    const ReplicationConfig replication_config{.socket_path = path + ".sock", .max_lag = 4, .batch = 8};
+    ReplicationPrimary primary(journal, replication_config);
+    ASSERT_EQ(primary.start(), ReplicationResult::Ok);
+    engine->set_replication(&primary);
+    
+    Queue standby_queue;
+    EngineConfig config;
+    config.max_traders = 100;
+    MatchingEngine<TEST_QUEUE_CAPACITY> standby_engine(standby_queue, config);
+    ReplicationStandby standby(replication_config);
+    ASSERT_EQ(standby.connect(1), ReplicationResult::Ok);
+    
+    auto apply_until_stopped = [&](std::stop_token st) {
+        while (!st.stop_requested() && standby.connected()) {
+            standby.poll([&](const JournalRecord& r) { standby_engine.replay(r); });
+        }
+    };
+    auto flow = [](std::uint64_t id) {
+        const Side side = (id % 3 == 0) ? Side::Sell : Side::Buy;
+        return OrderEvent::new_limit(OrderId{id}, TraderId{static_cast<std::uint32_t>(id % 5)}, side,
+                                     Price{static_cast<Price::value_type>(100 + id % 4)}, Qty{3});
+    };
+    
+    {
+        std::jthread applier(apply_until_stopped);
+        while (!primary.connected()) {
+            std::this_thread::yield();
+        }
+        for (std::uint64_t id = 1; id <= 100; ++id) {
+            process_event(flow(id));
+            ASSERT_LE(primary.lag_events(), replication_config.max_lag);
+        }
+        process_event(OrderEvent::cancel(OrderId{7}, TraderId{2}));
+        while (standby.applied() < journal.written()) {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_EQ(standby_engine.state_hash(), engine->state_hash());
+    EXPECT_FALSE(standby.gap_detected());
+    EXPECT_EQ(primary.lag_events(), 0u);
+    EXPECT_GT(standby.lag_stats().count, 0u);
+    
+    // Standby gone: the primary stops throttling and keeps journaling
+    standby.disconnect();
+    while (primary.connected()) {
+        std::this_thread::yield();
+    }
+    for (std::uint64_t id = 101; id <= 120; ++id) {
+        process_event(flow(id));
+    }
+    EXPECT_EQ(journal.written(), 121u);
+    
+    // Reconnecting resumes from the standby's next seq
+    ASSERT_EQ(standby.connect(standby.applied() + 1), ReplicationResult::Ok);
+    {
+        std::jthread applier(apply_until_stopped);
+        while (standby.applied() < journal.written()) {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_EQ(standby_engine.state_hash(), engine->state_hash());
+    EXPECT_EQ(primary.connections(), 2u);
+    
+    primary.stop();
+    ASSERT_EQ(journal.close(), JournalResult::Ok);
+}
+
+TEST_F(JournalTest, DurabilityModesAndUncleanShutdown) {
+    for (JournalDurability mode : {JournalDurability::PerEvent, JournalDurability::GroupCommit,
+                                   JournalDurability::Async}) {
+        Journal journal;
+        ASSERT_EQ(journal.create(path, JournalConfig{.capacity = 4, .durability = mode}), JournalResult::Ok);
+        for (std::uint64_t i = 1; i <= 5; ++i) {
+            journal.append(OrderEvent::new_limit(OrderId{i}, TraderId{1}, Side::Buy, Price{100}, Qty{1}), i);
+        }
+        EXPECT_EQ(journal.written(), 4u) << to_string(mode);
+        EXPECT_EQ(journal.overflowed(), 1u);
+        if (mode == JournalDurability::PerEvent) {
+            EXPECT_EQ(journal.durable(), 4u);  // Each append waited for its sync
+        }
+        ASSERT_TRUE(journal.sync());
+        EXPECT_EQ(journal.durable(), 4u);
+        
+        // A copy taken while open looks like a crashed writer: prefix found by scanning
+        std::filesystem::copy_file(path, path + ".copy",
+                                   std::filesystem::copy_options::overwrite_existing);
+        JournalResult result;
+        auto reader = JournalReader::open(path + ".copy", result);
+        ASSERT_TRUE(reader) << to_string(result);
+        EXPECT_FALSE(reader->clean_close());
+        EXPECT_EQ(reader->count(), 4u);
+        EXPECT_EQ(reader->record(3).event.order_id, OrderId{4});
+        EXPECT_EQ(journal.close(), JournalResult::Ok);
+    }
+    
+    JournalResult result;
+    std::filesystem::resize_file(path, 10);
+    EXPECT_FALSE(JournalReader::open(path, result));
+    EXPECT_EQ(result, JournalResult::BadFormat);
+}
+
+TEST_F(JournalTest, TornRecordEndsValidPrefix) {
+    Journal journal;
+    ASSERT_EQ(journal.create(path, JournalConfig{.capacity = 8}), JournalResult::Ok);
+    for (std::uint64_t i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(journal.append(OrderEvent::new_limit(OrderId{i}, TraderId{1}, Side::Buy, Price{100}, Qty{1}), i));
+    }
+    ASSERT_TRUE(journal.sync());
+    std::filesystem::copy_file(path, path + ".copy", std::filesystem::copy_options::overwrite_existing);
+    ASSERT_EQ(journal.close(), JournalResult::Ok);
+
+    // Record 3 keeps its seq but the rest of it never reached the disk
+    {
+        std::fstream file(path + ".copy", std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(sizeof(JournalHeader) + 2 * sizeof(JournalRecord) +
+                                               offsetof(JournalRecord, event)));
+        const char zeros[sizeof(OrderEvent)] = {};
+        file.write(zeros, sizeof(zeros));
+    }
+    JournalResult result;
+    auto reader = JournalReader::open(path + ".copy", result);
+    ASSERT_TRUE(reader) << to_string(result);
+    EXPECT_FALSE(reader->clean_close());
+    EXPECT_EQ(reader->count(), 2u);
+}
+
+// ============================================================================
+// Execution Report Tests
+// ============================================================================
+
+TEST_F(MatchingEngineTest, ExecutionReportsRoutedToOwners) {
+    ReportRouter router;
+    ReportRouter::Queue maker_reports;
+    ReportRouter::Queue taker_reports;
+    router.attach(TraderId{0}, maker_reports);
+    router.attach(TraderId{1}, taker_reports);
+    engine->set_report_router(&router);
+    
+    auto next = [](ReportRouter::Queue& q) {
+        ExecutionReport report;
+        EXPECT_TRUE(q.try_pop(report));
+        return report;
+    };
+    
+    // Resting sell: Ack with full leaves
+    process_event(OrderEvent::new_limit(
+        OrderId{1}, TraderId{0}, Side::Sell, Price{100}, Qty{10}
+    ));
+    auto ack = next(maker_reports);
+    EXPECT_EQ(ack.type, ExecType::Ack);
+    EXPECT_EQ(ack.order_id, OrderId{1});
+    EXPECT_EQ(ack.leaves.get(), 10);
+    
+    // Partial cross: both sides get a Fill, taker then gets its Ack
+    process_event(OrderEvent::new_limit(
+        OrderId{2}, TraderId{1}, Side::Buy, Price{100}, Qty{4}
+    ));
+    auto maker_fill = next(maker_reports);
+    EXPECT_EQ(maker_fill.type, ExecType::Fill);
+    EXPECT_EQ(maker_fill.order_id, OrderId{1});
+    EXPECT_EQ(maker_fill.qty.get(), 4);
+    EXPECT_EQ(maker_fill.price.get(), 100);
+    auto taker_fill = next(taker_reports);
+    EXPECT_EQ(taker_fill.type, ExecType::Fill);
+    EXPECT_EQ(taker_fill.order_id, OrderId{2});
+    auto taker_ack = next(taker_reports);
+    EXPECT_EQ(taker_ack.type, ExecType::Ack);
+    EXPECT_EQ(taker_ack.result, OrderResult::FullyFilled);
+    EXPECT_EQ(taker_ack.leaves.get(), 0);
+    
+    // Cancel carrying the owner: Cancelled
+    process_event(OrderEvent::cancel(OrderId{1}, TraderId{0}));
+    EXPECT_EQ(next(maker_reports).type, ExecType::Cancelled);
+    
+    // Cancel of an order that is gone: Rejected / NotFound
+    process_event(OrderEvent::cancel(OrderId{1}, TraderId{0}));
+    auto unknown = next(maker_reports);
+    EXPECT_EQ(unknown.type, ExecType::Rejected);
+    EXPECT_EQ(unknown.result, OrderResult::NotFound);
+    
+    // Risk reject carries the reason
+    process_event(OrderEvent::new_limit(
+        OrderId{3}, TraderId{1}, Side::Buy, Price{100}, Qty{0}
+    ));
+    auto risk_reject = next(taker_reports);
+    EXPECT_EQ(risk_reject.type, ExecType::Rejected);
+    EXPECT_EQ(risk_reject.risk, RiskResult::InvalidQty);
+    
+    ExecutionReport extra;
+    EXPECT_FALSE(maker_reports.try_pop(extra));
+    EXPECT_FALSE(taker_reports.try_pop(extra));
+    EXPECT_EQ(router.dropped(), 0u);
+}
+
+TEST(MatchingEngineQueueTest, TraderKeepsOrdersOnRiskRejectedCancel) {
+    constexpr std::size_t Capacity = 64;
+    using Queue = SpscQueue<OrderEvent, Capacity>;
+    Queue queue;
+    ReportRouter::Queue reports;
+    Trader<Capacity, Queue> trader(TraderConfig{}, queue, 1, &reports);
+    
+    ASSERT_TRUE(reports.try_push(ExecutionReport{.order_id = OrderId{1}, .leaves = Qty{10}}));
+    ASSERT_TRUE(reports.try_push(ExecutionReport{.order_id = OrderId{2}, .leaves = Qty{10}}));
+    trader.poll_reports();
+    ASSERT_EQ(trader.live_orders(), 2u);
+    
+    // Cancel throttled and modify outside the band: both orders still rest
+    ASSERT_TRUE(reports.try_push(ExecutionReport{.order_id = OrderId{1}, .type = ExecType::Rejected,
+        .result = OrderResult::Rejected, .risk = RiskResult::RateLimited}));
+    ASSERT_TRUE(reports.try_push(ExecutionReport{.order_id = OrderId{2}, .type = ExecType::Rejected,
+        .result = OrderResult::Rejected, .risk = RiskResult::OutsidePriceBand}));
+    trader.poll_reports();
+    EXPECT_EQ(trader.live_orders(), 2u);
+    
+    // Cancel the book no longer knows: forgotten
+    ASSERT_TRUE(reports.try_push(ExecutionReport{.order_id = OrderId{1}, .type = ExecType::Rejected,
+        .result = OrderResult::NotFound}));
+    trader.poll_reports();
+    EXPECT_EQ(trader.live_orders(), 1u);
+}
+
+TEST(MatchingEngineQueueTest, TraderTracksLiveOrdersFromReports) {
+    constexpr std::size_t Capacity = 4096;
+    using Queue = SpscQueue<OrderEvent, Capacity>;
+    Queue queue;
+    EngineConfig config;
+    config.max_orders = 10000;
+    config.initial_balance = 1'000'000'000;
+    config.risk.check_balance = false;
+    MatchingEngine<Capacity, Queue> engine(queue, config);
+    
+    ReportRouter router;
+    ReportRouter::Queue reports;
+    router.attach(TraderId{0}, reports);
+    engine.set_report_router(&router);
+    
+    // Fewer orders than fit in the report queue, so nothing is dropped
+    // while the trader is no longer polling
+    TraderConfig trader_config;
+    trader_config.trader_id = TraderId{0};
+    trader_config.orders_to_generate = 1000;
+    trader_config.prob_cancel = 0.2;
+    trader_config.prob_modify = 0.1;
+    Trader<Capacity, Queue> trader(trader_config, queue, 1, &reports);
+    
+    std::jthread engine_thread([&engine](std::stop_token st) {
+        engine.run(st);
+    });
+    trader.run(std::stop_token{});
+    
+    while (engine.events_processed() + engine.stats().rejected_count.load() < trader.orders_sent()) {
+        std::this_thread::yield();
+    }
+    engine_thread.request_stop();
+    engine_thread.join();
+    trader.poll_reports();
+    
+    // The trader's view matches what actually rests in the book
+    EXPECT_EQ(router.dropped(), 0u);
+    EXPECT_EQ(trader.reports_received(), router.sent());
+    EXPECT_EQ(trader.live_orders(), engine.book().order_count());
+    EXPECT_GT(trader.round_trip_stats().count, 0u);
+}
+
 // ============================================================================
 // Threaded Engine Tests
 // ============================================================================
@@ -190,6 +1057,176 @@ TEST_F(MatchingEngineTest, ThreadedWithMatching) {
     EXPECT_EQ(engine->book().order_count(), 0);  // All matched
 }
 
+TEST_F(MatchingEngineTest, ThreadedSpinWaitStrategies) {
+    for (auto strategy : {WaitStrategy::BusySpin, WaitStrategy::SpinYield, WaitStrategy::SpinPark}) {
+        Queue spin_queue;
+        EngineConfig config;
+        config.max_orders = 10000;
+        config.max_traders = 100;
+        config.wait.strategy = strategy;
+        config.wait.spin_iterations = 100;
+        MatchingEngine<TEST_QUEUE_CAPACITY> spin_engine(spin_queue, config);
+
+        std::jthread engine_thread([&](std::stop_token st) {
+            spin_engine.run(st);
+        });
+
+        constexpr std::size_t NUM_ORDERS = 200;
+        for (std::size_t i = 0; i < NUM_ORDERS; ++i) {
+            spin_queue.push(OrderEvent::new_limit(
+                OrderId{i + 1}, TraderId{0}, Side::Buy, Price{100}, Qty{10}
+            ));
+        }
+
+        while (spin_engine.events_processed() < NUM_ORDERS) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // Stop must be observed without any further queue activity
+        engine_thread.request_stop();
+        engine_thread.join();
+
+        EXPECT_EQ(spin_engine.book().order_count(), NUM_ORDERS) << to_string(strategy);
+    }
+}
+
+TEST(MatchingEngineQueueTest, LockFreeQueueEngine) {
+    using LockFreeQueue = SpscQueue<OrderEvent, TEST_QUEUE_CAPACITY>;
+    LockFreeQueue queue;
+    EngineConfig config;
+    config.max_orders = 10000;
+    config.wait.strategy = WaitStrategy::SpinYield;
+    MatchingEngine<TEST_QUEUE_CAPACITY, LockFreeQueue> engine(queue, config);
+    
+    std::jthread engine_thread([&engine](std::stop_token st) {
+        engine.run(st);
+    });
+    
+    constexpr std::size_t NUM_PAIRS = 500;
+    for (std::size_t i = 0; i < NUM_PAIRS; ++i) {
+        queue.push(OrderEvent::new_limit(
+            OrderId{i * 2 + 1}, TraderId{0}, Side::Sell, Price{100}, Qty{10}
+        ));
+        queue.push(OrderEvent::new_limit(
+            OrderId{i * 2 + 2}, TraderId{1}, Side::Buy, Price{100}, Qty{10}
+        ));
+    }
+    
+    while (engine.events_processed() < NUM_PAIRS * 2) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engine_thread.request_stop();
+    engine_thread.join();
+    
+    EXPECT_EQ(engine.stats().trade_count.load(), NUM_PAIRS);
+    EXPECT_EQ(engine.book().order_count(), 0);
+}
+
+TEST(MatchingEngineQueueTest, MultipleProducersIntoMpscQueue) {
+    using MultiQueue = MpscQueue<OrderEvent, TEST_QUEUE_CAPACITY>;
+    MultiQueue queue;
+    EngineConfig config;
+    config.max_orders = 10000;
+    MatchingEngine<TEST_QUEUE_CAPACITY, MultiQueue> engine(queue, config);
+    
+    std::jthread engine_thread([&engine](std::stop_token st) {
+        engine.run(st);
+    });
+    
+    constexpr std::uint64_t PER_PRODUCER = 1000;
+    {
+        std::vector<std::jthread> producers;
+        for (std::uint32_t p = 0; p < 4; ++p) {
+            producers.emplace_back([&queue, p]() {
+                for (std::uint64_t i = 0; i < PER_PRODUCER; ++i) {
+                    // Resting, non-crossing orders: every one must reach the book
+                    queue.push(OrderEvent::new_limit(
+                        OrderId{p * PER_PRODUCER + i + 1}, TraderId{p},
+                        p % 2 == 0 ? Side::Buy : Side::Sell,
+                        p % 2 == 0 ? Price{99} : Price{101}, Qty{10}
+                    ));
+                }
+            });
+        }
+    }
+    
+    while (engine.events_processed() < 4 * PER_PRODUCER) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engine_thread.request_stop();
+    engine_thread.join();
+    
+    EXPECT_EQ(engine.book().order_count(), 4 * PER_PRODUCER);
+    EXPECT_EQ(engine.stats().trade_count.load(), 0u);
+}
+
+// ============================================================================
+// Staged Pipeline Tests
+// ============================================================================
+
+TEST(PipelineEngineTest, MatchesSingleThreadEngine) {
+    PipelineConfig config;
+    config.engine.max_orders = 10000;
+    config.engine.max_traders = 100;
+    auto pipeline = std::make_unique<PipelineEngine<1024>>(config);  // Small ring: wraps
+    
+    SpscSemaphoreQueue<OrderEvent, TEST_QUEUE_CAPACITY> queue;
+    MatchingEngine<TEST_QUEUE_CAPACITY> reference(queue, config.engine);
+    
+    pipeline->start();
+    std::uint64_t next_id = 1;
+    for (std::size_t i = 0; i < 5000; ++i) {
+        const auto trader = TraderId{static_cast<std::uint32_t>(i % 7)};
+        const Side side = (i % 3 == 0) ? Side::Sell : Side::Buy;
+        const Price price{static_cast<Price::value_type>(95 + (i * 7) % 11)};
+        OrderEvent event = (i % 10 == 9)
+            ? OrderEvent::cancel(OrderId{next_id - 5})
+            : OrderEvent::new_limit(OrderId{next_id++}, trader, side, price, Qty{10});
+        if (i == 100) {
+            event.qty = Qty{0};  // Rejected by risk
+        }
+        pipeline->publish(event);
+        reference.process_event(event);
+    }
+    pipeline->stop();
+    
+    EXPECT_EQ(pipeline->events_processed(), reference.events_processed());
+    EXPECT_EQ(pipeline->stats().rejected_count.load(), 1u);
+    EXPECT_EQ(pipeline->stats().trade_count.load(), reference.stats().trade_count.load());
+    EXPECT_EQ(pipeline->stats().volume.load(), reference.stats().volume.load());
+    EXPECT_EQ(pipeline->book().order_count(), reference.book().order_count());
+    EXPECT_EQ(pipeline->book().best_bid(), reference.book().best_bid());
+    EXPECT_EQ(pipeline->book().best_ask(), reference.book().best_ask());
+    for (std::uint32_t t = 0; t < 7; ++t) {
+        EXPECT_EQ(pipeline->accounts().get_position(TraderId{t}),
+                  reference.accounts().get_position(TraderId{t}));
+    }
+    EXPECT_EQ(pipeline->stats().get_latency_stats().count, 5000u);
+}
+
+TEST(PipelineEngineTest, SweepLargerThanTradeQueue) {
+    PipelineConfig config;
+    config.engine.max_orders = 200000;
+    config.engine.risk.max_order_qty = Qty{1'000'000};
+    config.engine.risk.max_order_value = std::numeric_limits<std::int64_t>::max();
+    auto pipeline = std::make_unique<PipelineEngine<4096>>(config);
+    pipeline->start();
+    
+    // One taker that generates more trades than the trade queue holds
+    constexpr std::uint64_t MAKERS = PipelineEngine<4096>::TRADE_QUEUE_CAPACITY + 1000;
+    for (std::uint64_t i = 0; i < MAKERS; ++i) {
+        pipeline->publish(OrderEvent::new_limit(
+            OrderId{i + 1}, TraderId{0}, Side::Sell, Price{100}, Qty{1}));
+    }
+    pipeline->publish(OrderEvent::new_market(
+        OrderId{MAKERS + 1}, TraderId{1}, Side::Buy, Qty{static_cast<Qty::value_type>(MAKERS)}));
+    pipeline->stop();
+    
+    EXPECT_EQ(pipeline->stats().trade_count.load(), MAKERS);
+    EXPECT_EQ(pipeline->book().order_count(), 0u);
+    EXPECT_EQ(pipeline->accounts().get_position(TraderId{1}), static_cast<std::int64_t>(MAKERS));
+}
+
 // ============================================================================
 // Latency Tracking Tests
 // ============================================================================
@@ -203,6 +1240,126 @@ TEST_F(MatchingEngineTest, LatencyRecorded) {
     EXPECT_GE(stats.count, 1);
 }
 
+TEST_F(MatchingEngineTest, LatencySplitByStageAndOrderType) {
+    engine->controls().publish(engine->controls().get()->with_band(Price{100}, 1000));
+    process_event(OrderEvent::new_limit(OrderId{1}, TraderId{0}, Side::Buy, Price{100}, Qty{10}));
+    process_event(OrderEvent::new_limit(OrderId{2}, TraderId{0}, Side::Buy, Price{99}, Qty{10}));
+    process_event(OrderEvent::new_limit(OrderId{3}, TraderId{0}, Side::Buy, Price{500}, Qty{10}));  // Band reject
+    process_event(OrderEvent::cancel(OrderId{1}, TraderId{0}));
+    
+    const EngineStats& stats = engine->stats();
+    EXPECT_EQ(stats.get_latency_stats().count, 4u);
+    EXPECT_EQ(stats.get_stage_stats(OrderType::NewLimit, LatencyStage::QueueWait).count, 3u);
+    EXPECT_EQ(stats.get_stage_stats(OrderType::NewLimit, LatencyStage::Risk).count, 3u);
+    EXPECT_EQ(stats.get_stage_stats(OrderType::NewLimit, LatencyStage::Journal).count, 0u);  // No journal
+    EXPECT_EQ(stats.get_stage_stats(OrderType::NewLimit, LatencyStage::Matching).count, 2u);  // Reject skips it
+    EXPECT_EQ(stats.get_stage_stats(OrderType::NewLimit, LatencyStage::PostTrade).count, 3u);
+    EXPECT_EQ(stats.get_stage_stats(OrderType::Cancel, LatencyStage::Matching).count, 1u);
+    EXPECT_EQ(stats.get_stage_stats(OrderType::NewMarket, LatencyStage::QueueWait).count, 0u);
+    
+    const StatsSnapshot snap = StatsSnapshot::capture(stats);
+    const auto& cancel = snap.stage_latency[static_cast<std::size_t>(OrderType::Cancel)];
+    EXPECT_EQ(cancel[static_cast<std::size_t>(LatencyStage::PostTrade)].count, 1u);
+    
+    // Stages partition the end-to-end latency
+    const auto& limit = snap.stage_latency[static_cast<std::size_t>(OrderType::NewLimit)];
+    double stage_total = 0.0;
+    for (const LatencyStats& stage : limit) {
+        stage_total += stage.mean_ns * static_cast<double>(stage.count);
+    }
+    for (const LatencyStats& stage : cancel) {
+        stage_total += stage.mean_ns * static_cast<double>(stage.count);
+    }
+    EXPECT_NEAR(stage_total, snap.latency.mean_ns * 4.0, 1.0);
+    
+    engine->stats().reset();
+    EXPECT_EQ(stats.get_stage_stats(OrderType::NewLimit, LatencyStage::Risk).count, 0u);
+}
+
+TEST(TscClockTest, CalibratesAgainstMonotonicClock) {
+    auto clock = TscClock::calibrate();
+    if (!clock) {
+        GTEST_SKIP() << "No invariant TSC";
+    }
+    EXPECT_GT(clock->ticks_per_ns(), 0.1);
+    
+    const auto wall_start = std::chrono::steady_clock::now();
+    const std::uint64_t tick_start = TscClock::ticks();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const Duration measured = clock->to_ns(static_cast<std::int64_t>(TscClock::ticks() - tick_start));
+    const auto expected = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - wall_start).count();
+    EXPECT_NEAR(static_cast<double>(measured), static_cast<double>(expected), expected * 0.01);
+    
+    // Timestamps map into ticks and back
+    const Timestamp ts = now_ns();
+    const auto round_trip = static_cast<Duration>(clock->to_timestamp(clock->from_timestamp(ts)) - ts);
+    EXPECT_LE(std::abs(round_trip), 2);
+    EXPECT_LE(std::abs(static_cast<Duration>(clock->to_timestamp(TscClock::ticks()) - now_ns())), 100'000);
+    
+    // A fresh anchor keeps the rate and still maps onto now_ns()
+    const std::uint64_t old_anchor = clock->anchor_ticks();
+    const double rate = clock->ticks_per_ns();
+    clock->reanchor();
+    EXPECT_GT(clock->anchor_ticks(), old_anchor);
+    EXPECT_EQ(clock->ticks_per_ns(), rate);
+    EXPECT_LE(std::abs(static_cast<Duration>(clock->to_timestamp(TscClock::ticks()) - now_ns())), 100'000);
+}
+
+TEST_F(MatchingEngineTest, EnqueueStampAheadOfEngineClockRecordsZeroWait) {
+    // A producer clock ahead of the engine's (or a stepped clock) must not
+    // produce negative durations, nor be dropped as SKIPPED
+    auto event = OrderEvent::new_limit(OrderId{1}, TraderId{0}, Side::Buy, Price{100}, Qty{10});
+    event.enqueue_time += 1'000'000'000;
+    process_event(event);
+    
+    const LatencyStats wait = engine->stats().get_stage_stats(OrderType::NewLimit, LatencyStage::QueueWait);
+    ASSERT_EQ(wait.count, 1u);
+    EXPECT_EQ(wait.max_ns, 0);
+    EXPECT_EQ(engine->stats().get_latency_stats().count, 1u);
+    EXPECT_EQ(engine->stats().get_latency_stats().max_ns, 0);
+}
+
+TEST_F(MatchingEngineTest, TscTimeSourceRecordsNanoseconds) {
+    EngineConfig config;
+    config.max_traders = 100;
+    config.time_source = TimeSource::Tsc;
+    MatchingEngine<TEST_QUEUE_CAPACITY> tsc_engine(queue, config);
+    if (tsc_engine.time_source() != TimeSource::Tsc) {
+        GTEST_SKIP() << "No invariant TSC";
+    }
+    
+    Journal journal;
+    const std::string path = (std::filesystem::temp_directory_path() / "ces_tsc_test.journal").string();
+    ASSERT_EQ(journal.create(path, JournalConfig{.capacity = 16}), JournalResult::Ok);
+    tsc_engine.set_journal(&journal);
+    
+    std::vector<Trade> trades;
+    tsc_engine.book().set_trade_callback([&](const Trade& t) { trades.push_back(t); });
+    const Timestamp before = now_ns();
+    auto resting = OrderEvent::new_limit(OrderId{1}, TraderId{1}, Side::Sell, Price{100}, Qty{10});
+    resting.enqueue_time -= 1'000'000;  // Waited a millisecond in the queue
+    tsc_engine.process_event(resting);
+    tsc_engine.process_event(OrderEvent::new_limit(OrderId{2}, TraderId{2}, Side::Buy, Price{100}, Qty{4}));
+    const Timestamp after = now_ns();
+    
+    // Durations are ticks internally, reported in ns
+    const LatencyStats wait = tsc_engine.stats().get_stage_stats(OrderType::NewLimit, LatencyStage::QueueWait);
+    ASSERT_EQ(wait.count, 2u);
+    EXPECT_GE(wait.max_ns, 900'000);
+    EXPECT_LT(wait.max_ns, 100'000'000);
+    EXPECT_LT(tsc_engine.stats().get_latency_stats().max_ns, 100'000'000);
+    
+    // What leaves the engine is in now_ns() time
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_GE(trades[0].timestamp + 100'000, before);
+    EXPECT_LE(trades[0].timestamp, after + 100'000);
+    EXPECT_EQ(trades[0].timestamp, journal.records()[1].timestamp);
+    
+    ASSERT_EQ(journal.close(), JournalResult::Ok);
+    std::remove(path.c_str());
+}
+
 // ============================================================================
 // Stress Test
 // ============================================================================
@@ -228,13 +1385,13 @@ TEST_F(MatchingEngineTest, StressTest) {
         } else {
             Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
             Price base_price{10000};
-            Price offset{static_cast<std::int64_t>((i % 20) - 10)};
+            Price offset{static_cast<Price::value_type>(i % 20) - 10};
             Price price = base_price + offset;
             
             event = OrderEvent::new_limit(
                 OrderId{i + 1},
                 TraderId{static_cast<std::uint32_t>(i % 10)},
-                side, price, Qty{10 + static_cast<std::int64_t>(i % 100)}
+                side, price, Qty{10 + static_cast<Qty::value_type>(i % 100)}
             );
         }
         
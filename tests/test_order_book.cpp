@@ -8,7 +8,17 @@
 #include <ces/lob/order_book.hpp>
 #include <ces/lob/order.hpp>
 #include <ces/common/types.hpp>
-
+#include <ces/common/instrument.hpp>
+#include <ces/memory/object_pool.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 using namespace ces;
@@ -187,6 +197,7 @@ TEST_F(OrderBookTest, PriceTimePriority) {
         OrderId{3}, TraderId{2}, Side::Buy, Price{100}, Qty{10}
     );
     
+    EXPECT_EQ(response.result, OrderResult::FullyFilled);
     EXPECT_EQ(trades.size(), 1);
     EXPECT_EQ(trades[0].maker_order_id.get(), 1);  // First order matched
     
@@ -329,3 +340,342 @@ TEST_F(OrderBookTest, Clear) {
     EXPECT_EQ(book.bid_levels(), 0);
     EXPECT_EQ(book.ask_levels(), 0);
 }
+
+// ============================================================================
+// Instrument Conversion
+// ============================================================================
+
+TEST(InstrumentTest, RoundTripsOnGrid) {
+    Instrument instrument{.tick_size = 5, .lot_size = 100};
+    
+    auto price = instrument.to_price(10'005);
+    auto qty = instrument.to_qty(2'500);
+    ASSERT_TRUE(price.has_value());
+    ASSERT_TRUE(qty.has_value());
+    EXPECT_EQ(price->get(), 2001);
+    EXPECT_EQ(qty->get(), 25);
+    EXPECT_EQ(instrument.raw_price(*price), 10'005);
+    EXPECT_EQ(instrument.raw_qty(*qty), 2'500);
+    EXPECT_EQ(instrument.raw_notional(notional_value(*price, *qty)), 10'005LL * 2'500);
+}
+
+TEST(InstrumentTest, RejectsOffGridAndOutOfRange) {
+    Instrument instrument{.tick_size = 5, .lot_size = 100};
+    
+    EXPECT_FALSE(instrument.to_price(10'003).has_value());
+    EXPECT_FALSE(instrument.to_qty(150).has_value());
+    EXPECT_FALSE(Instrument{}.to_price(std::int64_t{1} << 40).has_value());
+}
+
+TEST(InstrumentTest, CompactLayout) {
+    EXPECT_LE(sizeof(Order), CACHE_LINE_SIZE / 2);
+    EXPECT_EQ(sizeof(OrderEvent), CACHE_LINE_SIZE / 2);
+    EXPECT_EQ(notional_value(Price{std::numeric_limits<std::int32_t>::max()}, Qty{2}),
+              2LL * std::numeric_limits<std::int32_t>::max());
+}
+
+// ============================================================================
+// Pool Growth Tests
+// ============================================================================
+
+TEST(PoolGrowthTest, GrowsInlineBeyondInitialCapacity) {
+    // 16-entry segments so growth happens quickly
+    OrderBook book(16, 64, 0.5f, AllocationPolicy{}, PoolGrowth{.segment_shift = 4});
+    EXPECT_EQ(book.order_capacity(), 16u);
+    
+    for (std::uint64_t i = 1; i <= 100; ++i) {
+        auto response = book.add_limit(OrderId{i}, TraderId{1}, Side::Buy, Price{100}, Qty{1});
+        ASSERT_EQ(response.result, OrderResult::Accepted);
+    }
+    
+    EXPECT_EQ(book.order_count(), 100u);
+    EXPECT_GE(book.order_capacity(), 100u);
+    EXPECT_GT(book.pool_inline_grows(), 0u);
+    EXPECT_EQ(book.best_bid_qty().get(), 100);
+}
+
+TEST(PoolGrowthTest, MaintainGrowsAheadOfDemand) {
+    OrderBook book(16, 64, 0.5f, AllocationPolicy{},
+                   PoolGrowth{.segment_shift = 4, .low_watermark = 4});
+    
+    EXPECT_FALSE(book.maintain());
+    
+    for (std::uint64_t i = 1; i <= 13; ++i) {
+        (void)book.add_limit(OrderId{i}, TraderId{1}, Side::Sell, Price{100 + static_cast<std::int32_t>(i)}, Qty{1});
+    }
+    
+    EXPECT_TRUE(book.maintain());
+    EXPECT_EQ(book.order_capacity(), 32u);
+    
+    for (std::uint64_t i = 14; i <= 32; ++i) {
+        (void)book.add_limit(OrderId{i}, TraderId{1}, Side::Sell, Price{200}, Qty{1});
+    }
+    EXPECT_EQ(book.pool_inline_grows(), 0u);
+    
+    // Orders from both segments match in price-time order
+    auto response = book.add_market(OrderId{100}, TraderId{2}, Side::Buy, Qty{32});
+    EXPECT_EQ(response.result, OrderResult::FullyFilled);
+    EXPECT_EQ(book.order_count(), 0u);
+}
+
+TEST(PoolGrowthTest, ConcurrentMaintainInstallsOneSegment) {
+    OrderBook book(16, 64, 0.5f, AllocationPolicy{},
+                   PoolGrowth{.segment_shift = 4, .low_watermark = 4});
+    
+    for (std::uint64_t i = 1; i <= 13; ++i) {
+        (void)book.add_limit(OrderId{i}, TraderId{1}, Side::Sell, Price{100 + static_cast<std::int32_t>(i)}, Qty{1});
+    }
+    
+    // Engine idle path and housekeeping thread racing on the same shortfall
+    std::atomic<int> installed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            if (book.maintain()) {
+                installed.fetch_add(1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    EXPECT_EQ(installed.load(), 1);
+    EXPECT_EQ(book.order_capacity(), 32u);
+}
+
+TEST(PoolGrowthTest, FixedPoolRejectsWhenFull) {
+    OrderBook book(16, 64, 0.5f, AllocationPolicy{},
+                   PoolGrowth{.segment_shift = 4, .max_capacity = 0});
+    
+    for (std::uint64_t i = 1; i <= 16; ++i) {
+        ASSERT_EQ(book.add_limit(OrderId{i}, TraderId{1}, Side::Buy, Price{100}, Qty{1}).result,
+                  OrderResult::Accepted);
+    }
+    EXPECT_EQ(book.add_limit(OrderId{17}, TraderId{1}, Side::Buy, Price{100}, Qty{1}).result,
+              OrderResult::Rejected);
+    EXPECT_FALSE(book.maintain());
+}
+
+// ============================================================================
+// Order Index Tests
+// ============================================================================
+
+TEST(OrderIndexTest, MatchesReferenceMapUnderChurn) {
+    OrderIndex index(64);
+    std::unordered_map<std::uint64_t, std::uint32_t> reference;
+    std::mt19937_64 rng(7);
+    
+    for (std::uint32_t i = 0; i < 20000; ++i) {
+        const std::uint64_t key = rng() % 2048;
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(index.erase(key), reference.erase(key) == 1);
+        } else {
+            EXPECT_EQ(index.insert(key, i), reference.emplace(key, i).second);
+        }
+    }
+    
+    EXPECT_EQ(index.size(), reference.size());
+    for (std::uint64_t key = 0; key < 2048; ++key) {
+        auto it = reference.find(key);
+        EXPECT_EQ(index.find(key), it == reference.end() ? OrderIndex::INVALID_INDEX : it->second);
+    }
+}
+
+TEST(OrderIndexTest, ClearIsBulkAndReusable) {
+    OrderIndex index(16);
+    for (std::uint64_t key = 1; key <= 100; ++key) {
+        ASSERT_TRUE(index.insert(key, static_cast<std::uint32_t>(key)));
+    }
+    const std::size_t slots = index.slot_count();
+    
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.slot_count(), slots);
+    EXPECT_FALSE(index.contains(50));
+    
+    EXPECT_TRUE(index.insert(50, 7));
+    EXPECT_EQ(index.find(50), 7u);
+    EXPECT_FALSE(index.contains(51));
+}
+
+// ============================================================================
+// Pool Reset Tests
+// ============================================================================
+
+TEST(PoolResetTest, ClearInvalidatesOldIndicesAndRewinds) {
+    ObjectPool<Order> pool(16, AllocationPolicy{}, PoolGrowth{.segment_shift = 4});
+    
+    const auto a = pool.allocate(OrderId{1}, TraderId{1}, Side::Buy, Price{100}, Qty{1});
+    const auto b = pool.allocate(OrderId{2}, TraderId{1}, Side::Buy, Price{100}, Qty{1});
+    pool.deallocate(a);
+    EXPECT_EQ(pool.allocate(OrderId{3}, TraderId{1}, Side::Buy, Price{100}, Qty{1}), a);  // Freelist first
+    EXPECT_EQ(pool.slots_used(), 2u);
+    
+    pool.clear();
+    EXPECT_TRUE(pool.empty());
+    EXPECT_FALSE(pool.is_valid(a));
+    EXPECT_FALSE(pool.is_valid(b));
+    EXPECT_EQ(pool.get(b), nullptr);
+    EXPECT_EQ(pool.slots_used(), 0u);
+    
+    // Bump pointer restarts at slot 0
+    const auto c = pool.allocate(OrderId{4}, TraderId{1}, Side::Sell, Price{101}, Qty{2});
+    EXPECT_EQ(c, 0u);
+    EXPECT_TRUE(pool.is_valid(c));
+    EXPECT_FALSE(pool.is_valid(1));
+    EXPECT_EQ(pool[c].order_id, OrderId{4});
+}
+
+TEST_F(OrderBookTest, ClearThenReuseIds) {
+    for (std::uint64_t i = 1; i <= 50; ++i) {
+        book.add_limit(OrderId{i}, TraderId{1}, Side::Buy, Price{100 - static_cast<std::int32_t>(i % 5)}, Qty{10});
+    }
+    book.clear();
+    EXPECT_FALSE(book.has_order(OrderId{1}));
+    
+    EXPECT_EQ(book.add_limit(OrderId{1}, TraderId{2}, Side::Sell, Price{105}, Qty{10}).result,
+              OrderResult::Accepted);
+    EXPECT_EQ(book.order_count(), 1u);
+    EXPECT_EQ(book.cancel(OrderId{1}).result, OrderResult::Cancelled);
+    EXPECT_EQ(book.cancel(OrderId{2}).result, OrderResult::NotFound);
+}
+
+TEST_F(OrderBookTest, PrefaultPreservesContents) {
+    book.add_limit(OrderId{1}, TraderId{1}, Side::Buy, Price{100}, Qty{10});
+    book.add_limit(OrderId{2}, TraderId{2}, Side::Sell, Price{101}, Qty{20});
+    
+    book.prefault();
+    
+    EXPECT_EQ(book.order_count(), 2u);
+    EXPECT_EQ(book.best_bid_qty().get(), 10);
+    EXPECT_EQ(book.cancel(OrderId{2}).result, OrderResult::Cancelled);
+    EXPECT_EQ(book.add_limit(OrderId{3}, TraderId{3}, Side::Sell, Price{100}, Qty{10}).result,
+              OrderResult::FullyFilled);
+}
+
+TEST_F(OrderBookTest, MemoryStatsTrackOccupancyAndShifts) {
+    book.add_limit(OrderId{1}, TraderId{1}, Side::Buy, Price{100}, Qty{10});
+    book.add_limit(OrderId{2}, TraderId{1}, Side::Buy, Price{102}, Qty{10});  // New best: shifts 1
+    book.add_limit(OrderId{3}, TraderId{1}, Side::Buy, Price{101}, Qty{10});  // Middle: shifts 1
+    book.cancel(OrderId{2});                                                   // Erase front: shifts 2
+    
+    auto stats = book.memory_stats();
+    EXPECT_EQ(stats.pool_live, 2u);
+    EXPECT_EQ(stats.pool_peak_live, 3u);
+    EXPECT_EQ(stats.pool_slots_touched, 3u);
+    EXPECT_GE(stats.pool_reserved_bytes, stats.pool_capacity * ObjectPool<Order>::slot_bytes());
+    EXPECT_EQ(stats.index_entries, 2u);
+    EXPECT_EQ(stats.index_peak_entries, 3u);
+    EXPECT_GE(stats.index_mean_probe, 1.0);
+    EXPECT_GE(stats.index_max_probe, 1u);
+    EXPECT_EQ(stats.bid_levels, 2u);
+    EXPECT_EQ(stats.peak_bid_levels, 3u);
+    EXPECT_EQ(stats.level_inserts, 3u);
+    EXPECT_EQ(stats.level_erases, 1u);
+    EXPECT_EQ(stats.level_elements_shifted, 4u);
+    EXPECT_EQ(stats.level_reallocations, 0u);
+    EXPECT_LE(stats.total_used_bytes(), stats.total_reserved_bytes());
+}
+
+// ============================================================================
+// Snapshot Tests
+// ============================================================================
+
+class SnapshotTest : public ::testing::Test {
+protected:
+    std::string path = (std::filesystem::temp_directory_path() /
+        ("ces_snapshot_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + ".bin")).string();
+    
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+};
+
+TEST_F(SnapshotTest, RoundTripPreservesLevelsAndPriority) {
+    OrderBook original(1000, 100);
+    original.add_limit(OrderId{1}, TraderId{1}, Side::Buy, Price{100}, Qty{10});
+    original.add_limit(OrderId{2}, TraderId{2}, Side::Buy, Price{100}, Qty{20});
+    original.add_limit(OrderId{3}, TraderId{3}, Side::Buy, Price{99}, Qty{30});
+    original.add_limit(OrderId{4}, TraderId{4}, Side::Sell, Price{101}, Qty{40});
+    original.add_limit(OrderId{5}, TraderId{5}, Side::Sell, Price{103}, Qty{50});
+    original.add_limit(OrderId{6}, TraderId{6}, Side::Sell, Price{101}, Qty{5});
+    original.cancel(OrderId{4});
+    
+    ASSERT_EQ(original.save_snapshot(path), SnapshotResult::Ok);
+    
+    OrderBook restored(16, 100);
+    restored.add_limit(OrderId{99}, TraderId{9}, Side::Buy, Price{50}, Qty{1});  // Replaced by load
+    ASSERT_EQ(restored.load_snapshot(path), SnapshotResult::Ok);
+    
+    EXPECT_EQ(restored.order_count(), 5u);
+    EXPECT_FALSE(restored.has_order(OrderId{99}));
+    EXPECT_EQ(restored.bid_levels(), 2u);
+    EXPECT_EQ(restored.ask_levels(), 2u);
+    EXPECT_EQ(restored.best_bid(), Price{100});
+    EXPECT_EQ(restored.best_ask(), Price{101});
+    EXPECT_EQ(restored.best_bid_qty().get(), 30);
+    
+    // Time priority survives: order 1 fills before order 2
+    std::vector<Trade> trades;
+    restored.set_trade_callback([&trades](const Trade& t) { trades.push_back(t); });
+    restored.add_market(OrderId{100}, TraderId{7}, Side::Sell, Qty{15});
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(trades[0].maker_order_id, OrderId{1});
+    EXPECT_EQ(trades[1].maker_order_id, OrderId{2});
+    
+    // Cancels work on restored orders
+    EXPECT_EQ(restored.cancel(OrderId{5}).result, OrderResult::Cancelled);
+}
+
+TEST_F(SnapshotTest, RejectsMissingAndCorruptFiles) {
+    OrderBook book(1000, 100);
+    EXPECT_EQ(book.load_snapshot(path), SnapshotResult::IoError);
+    
+    book.add_limit(OrderId{1}, TraderId{1}, Side::Buy, Price{100}, Qty{10});
+    ASSERT_EQ(book.save_snapshot(path), SnapshotResult::Ok);
+    
+    // Truncate the last order record: rejected before the book is touched
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+    EXPECT_EQ(book.load_snapshot(path), SnapshotResult::BadFormat);
+    EXPECT_EQ(book.order_count(), 1u);
+}
+
+TEST_F(SnapshotTest, RejectsInconsistentImages) {
+    OrderBook source(1000, 100);
+    source.add_limit(OrderId{1}, TraderId{1}, Side::Buy, Price{100}, Qty{10});
+    source.add_limit(OrderId{2}, TraderId{2}, Side::Buy, Price{100}, Qty{20});
+    source.add_limit(OrderId{3}, TraderId{3}, Side::Sell, Price{101}, Qty{30});
+    std::vector<std::byte> good;
+    source.capture_snapshot(good);
+    
+    // Layout: header, bid level, ask level, three orders
+    constexpr std::size_t BID_LEVEL = sizeof(SnapshotHeader);
+    constexpr std::size_t FIRST_ORDER = BID_LEVEL + 2 * sizeof(SnapshotLevel);
+    auto patched = [&good](std::size_t offset, const auto& value) {
+        std::vector<std::byte> image = good;
+        std::memcpy(image.data() + offset, &value, sizeof(value));
+        return image;
+    };
+    
+    OrderBook book(1000, 100);
+    ASSERT_EQ(book.load_snapshot(std::span<const std::byte>(good)), SnapshotResult::Ok);
+    
+    // Zero-quantity order
+    auto image = patched(FIRST_ORDER + offsetof(SnapshotOrder, qty), Qty{0});
+    EXPECT_EQ(book.load_snapshot(std::span<const std::byte>(image)), SnapshotResult::BadFormat);
+    EXPECT_EQ(book.order_count(), 0u);
+    
+    // Non-positive price
+    image = patched(BID_LEVEL + offsetof(SnapshotLevel, price), Price{-5});
+    EXPECT_EQ(book.load_snapshot(std::span<const std::byte>(image)), SnapshotResult::BadFormat);
+    
+    // Crossed book: bid at the ask price
+    image = patched(BID_LEVEL + offsetof(SnapshotLevel, price), Price{101});
+    EXPECT_EQ(book.load_snapshot(std::span<const std::byte>(image)), SnapshotResult::BadFormat);
+    
+    // Level counts add up to 2 of the header's 3 orders
+    image = patched(BID_LEVEL + offsetof(SnapshotLevel, order_count), std::uint32_t{1});
+    EXPECT_EQ(book.load_snapshot(std::span<const std::byte>(image)), SnapshotResult::BadFormat);
+    EXPECT_EQ(book.order_count(), 0u);
+}
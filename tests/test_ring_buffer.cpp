@@ -1,16 +1,20 @@
 /**
  * @file test_ring_buffer.cpp
- * @brief Unit tests for ring buffer and SPSC semaphore queue
+ * @brief Unit tests for ring buffer and SPSC/MPSC queues
  */
 
 #include <gtest/gtest.h>
 
 #include <ces/concurrency/ring_buffer.hpp>
 #include <ces/concurrency/spsc_semaphore_queue.hpp>
+#include <ces/concurrency/spsc_queue.hpp>
+#include <ces/concurrency/mpsc_queue.hpp>
+#include <ces/concurrency/versioned_config.hpp>
 
 #include <thread>
 #include <vector>
 #include <atomic>
+#include <span>
 
 using namespace ces;
 
@@ -208,3 +212,356 @@ TEST(SpscQueueTest, SizeApprox) {
     EXPECT_TRUE(queue.try_pop(value));
     EXPECT_EQ(queue.size_approx(), 2);
 }
+
+TEST(SpscQueueTest, HugePagePolicy) {
+    SpscSemaphoreQueue<int, 1 << 20> queue(AllocationPolicy::huge());
+    
+#if defined(__linux__)
+    EXPECT_NE(queue.backing(), PageBacking::Heap);
+#endif
+    
+    for (int i = 0; i < 1000; ++i) {
+        queue.push(i);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(queue.pop(), i);
+    }
+}
+
+TEST(SpscQueueTest, DefaultPolicyIsHeap) {
+    SpscSemaphoreQueue<int, 16> queue;
+    EXPECT_EQ(queue.backing(), PageBacking::Heap);
+}
+
+// ============================================================================
+// SpscQueue (lock-free) Tests
+// ============================================================================
+
+TEST(SpscLockFreeQueueTest, BasicOperations) {
+    SpscQueue<int, 16> queue;
+    
+    int value = 0;
+    EXPECT_FALSE(queue.try_pop(value));
+    
+    EXPECT_TRUE(queue.try_push(42));
+    EXPECT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, 42);
+    EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(SpscLockFreeQueueTest, FullAndWraparound) {
+    SpscQueue<int, 4> queue;
+    
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(queue.try_push(round * 10 + i));
+        }
+        EXPECT_FALSE(queue.try_push(99));  // Full
+        EXPECT_TRUE(queue.full_approx());
+        
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(queue.pop(), round * 10 + i);
+        }
+        EXPECT_TRUE(queue.empty_approx());
+    }
+}
+
+TEST(SpscLockFreeQueueTest, ConcurrentProducerConsumer) {
+    constexpr std::uint64_t NUM_ITEMS = 100000;
+    SpscQueue<std::uint64_t, 64> queue;  // Small: forces frequent full/empty
+    
+    std::thread producer([&]() {
+        for (std::uint64_t i = 1; i <= NUM_ITEMS; ++i) {
+            queue.push(i);
+        }
+    });
+    
+    // FIFO order must hold across cached-index refreshes
+    std::uint64_t expected = 1;
+    std::uint64_t value = 0;
+    while (expected <= NUM_ITEMS) {
+        queue.pop(value);
+        ASSERT_EQ(value, expected);
+        ++expected;
+    }
+    
+    producer.join();
+    EXPECT_TRUE(queue.empty_approx());
+}
+
+TEST(SpscLockFreeQueueTest, Timeout) {
+    SpscQueue<int, 8> queue;
+    
+    int value;
+    auto start = std::chrono::steady_clock::now();
+    bool result = queue.try_pop_for(value, std::chrono::milliseconds(50));
+    auto end = std::chrono::steady_clock::now();
+    
+    EXPECT_FALSE(result);
+    EXPECT_GE(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(), 40);
+    
+    for (int i = 0; i < 8; ++i) {
+        queue.push(i);
+    }
+    EXPECT_FALSE(queue.try_push_for(8, std::chrono::milliseconds(5)));
+    EXPECT_TRUE(queue.try_pop_for(value, std::chrono::milliseconds(5)));
+    EXPECT_EQ(value, 0);
+}
+
+// ============================================================================
+// Batch Operation Tests
+// ============================================================================
+
+TEST(SpscBatchTest, PushPopNWrapsAround) {
+    SpscQueue<int, 8> queue;
+    std::vector<int> in{1, 2, 3, 4, 5, 6};
+    std::vector<int> out(8, 0);
+    
+    // Advance the indices so the next batch straddles the buffer end
+    EXPECT_EQ(queue.try_push_n(std::span<const int>(in)), 6u);
+    EXPECT_EQ(queue.try_pop_n(std::span<int>(out), 6), 6u);
+    
+    std::vector<int> more{10, 11, 12, 13, 14, 15, 16, 17, 18};
+    EXPECT_EQ(queue.try_push_n(std::span<const int>(more)), 8u);  // Capacity-limited
+    EXPECT_EQ(queue.try_push_n(std::span<const int>(more)), 0u);   // Full
+    
+    EXPECT_EQ(queue.try_pop_n(std::span<int>(out), 3), 3u);
+    EXPECT_EQ(out[0], 10);
+    EXPECT_EQ(out[2], 12);
+    EXPECT_EQ(queue.try_pop_n(std::span<int>(out), 8), 5u);
+    EXPECT_EQ(out[0], 13);
+    EXPECT_EQ(out[4], 17);
+    EXPECT_EQ(queue.try_pop_n(std::span<int>(out), 8), 0u);
+}
+
+TEST(SpscBatchTest, ReadAvailableIsZeroCopyUntilConsumed) {
+    SpscQueue<int, 8> queue;
+    std::vector<int> sink(8);
+    std::vector<int> in{0, 0, 0, 0, 0, 0};
+    ASSERT_EQ(queue.try_push_n(std::span<const int>(in)), 6u);
+    ASSERT_EQ(queue.try_pop_n(std::span<int>(sink), 6), 6u);
+    
+    // Slots 6,7 then 0,1 hold a wrapped run of four
+    std::vector<int> wrapped{1, 2, 3, 4};
+    ASSERT_EQ(queue.try_push_n(std::span<const int>(wrapped)), 4u);
+    
+    auto view = queue.read_available();
+    ASSERT_EQ(view.size(), 2u);  // Stops at the buffer end
+    EXPECT_EQ(view[0], 1);
+    EXPECT_EQ(view[1], 2);
+    
+    // Unconsumed slots are still owned by the consumer
+    EXPECT_EQ(queue.read_available().data(), view.data());
+    EXPECT_EQ(queue.size_approx(), 4u);
+    
+    queue.consume(view.size());
+    view = queue.read_available(1);
+    ASSERT_EQ(view.size(), 1u);
+    EXPECT_EQ(view[0], 3);
+    queue.consume(1);
+    EXPECT_EQ(queue.pop(), 4);
+    EXPECT_TRUE(queue.read_available().empty());
+}
+
+TEST(SpscBatchTest, SemaphoreQueueBatches) {
+    SpscSemaphoreQueue<int, 8> queue;
+    std::vector<int> in{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<int> out(8, 0);
+    
+    EXPECT_EQ(queue.try_push_n(std::span<const int>(in)), 8u);
+    EXPECT_FALSE(queue.try_push(10));
+    EXPECT_EQ(queue.try_pop_n(std::span<int>(out), 5), 5u);
+    EXPECT_EQ(out[4], 5);
+    
+    // Semaphore counts stay consistent with single-element calls
+    EXPECT_TRUE(queue.try_push(10));
+    EXPECT_EQ(queue.size_approx(), 4u);
+    EXPECT_EQ(queue.try_pop_n(std::span<int>(out), 8), 4u);
+    EXPECT_EQ(out[3], 10);
+    int value;
+    EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(SpscBatchTest, ConcurrentBatchTransfer) {
+    constexpr std::uint64_t NUM_ITEMS = 100000;
+    SpscQueue<std::uint64_t, 64> queue;
+    
+    std::thread producer([&]() {
+        std::vector<std::uint64_t> chunk;
+        std::uint64_t next = 1;
+        while (next <= NUM_ITEMS) {
+            chunk.clear();
+            for (std::uint64_t i = 0; i < 17 && next + i <= NUM_ITEMS; ++i) {
+                chunk.push_back(next + i);
+            }
+            std::span<const std::uint64_t> pending(chunk);
+            while (!pending.empty()) {
+                const std::size_t pushed = queue.try_push_n(pending);
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+                pending = pending.subspan(pushed);
+            }
+            next += chunk.size();
+        }
+    });
+    
+    std::uint64_t expected = 1;
+    while (expected <= NUM_ITEMS) {
+        auto view = queue.read_available(13);
+        for (std::uint64_t value : view) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        }
+        if (view.empty()) {
+            std::this_thread::yield();
+        }
+        queue.consume(view.size());
+    }
+    
+    producer.join();
+}
+
+// ============================================================================
+// MpscQueue Tests
+// ============================================================================
+
+TEST(MpscQueueTest, BasicAndFull) {
+    MpscQueue<int, 4> queue;
+    
+    int value = 0;
+    EXPECT_FALSE(queue.try_pop(value));
+    
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(queue.try_push(lap * 10 + i));
+        }
+        EXPECT_FALSE(queue.try_push(99));
+        EXPECT_EQ(queue.size_approx(), 4u);
+        
+        std::vector<int> out(4);
+        EXPECT_EQ(queue.try_pop_n(std::span<int>(out), 2), 2u);
+        EXPECT_EQ(out[1], lap * 10 + 1);
+        EXPECT_EQ(queue.pop(), lap * 10 + 2);
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, lap * 10 + 3);
+        EXPECT_TRUE(queue.empty_approx());
+    }
+}
+
+TEST(MpscQueueTest, ConcurrentProducersKeepPerProducerOrder) {
+    constexpr std::size_t NUM_PRODUCERS = 4;
+    constexpr std::uint64_t PER_PRODUCER = 25000;
+    MpscQueue<std::uint64_t, 128> queue;  // Small: producers contend on full
+    
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < NUM_PRODUCERS; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (std::uint64_t i = 0; i < PER_PRODUCER; ++i) {
+                queue.push((static_cast<std::uint64_t>(p) << 32) | i);
+            }
+        });
+    }
+    
+    std::vector<std::uint64_t> next(NUM_PRODUCERS, 0);
+    std::vector<std::uint64_t> batch(32);
+    std::uint64_t received = 0;
+    while (received < NUM_PRODUCERS * PER_PRODUCER) {
+        const std::size_t count = queue.try_pop_n(std::span<std::uint64_t>(batch), batch.size());
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t producer = batch[i] >> 32;
+            ASSERT_LT(producer, NUM_PRODUCERS);
+            ASSERT_EQ(batch[i] & 0xFFFFFFFFu, next[producer]);  // No loss, no reorder
+            ++next[producer];
+        }
+        received += count;
+    }
+    
+    for (auto& t : producers) {
+        t.join();
+    }
+    for (std::uint64_t n : next) {
+        EXPECT_EQ(n, PER_PRODUCER);
+    }
+    EXPECT_TRUE(queue.empty_approx());
+}
+
+// ============================================================================
+// VersionedConfig Tests
+// ============================================================================
+
+TEST(VersionedConfigTest, ReclaimsSnapshotsReadersHaveMovedPast) {
+    VersionedConfig<int> config(0);
+    
+    // No readers: superseded snapshots are freed on the next publish
+    for (int i = 1; i <= 100; ++i) {
+        EXPECT_EQ(config.publish(i), static_cast<std::uint64_t>(i));
+    }
+    EXPECT_EQ(config.retained(), 0u);
+    
+    // A reader holds what it loaded until its next quiescent point
+    auto reader = config.register_reader();
+    const int* held = reader.get();
+    EXPECT_EQ(*held, 100);
+    config.publish(101);
+    config.publish(102);
+    EXPECT_EQ(config.retained(), 2u);
+    EXPECT_EQ(*held, 100);
+    
+    reader.quiescent();
+    EXPECT_EQ(*reader.get(), 102);
+    config.publish(103);
+    EXPECT_EQ(config.retained(), 1u);  // 102, which the reader may hold
+    
+    // Offline readers hold nothing back; coming back online catches up
+    reader.offline();
+    config.publish(104);
+    EXPECT_EQ(config.retained(), 0u);
+    reader.quiescent();
+    EXPECT_EQ(*reader.get(), 104);
+    
+    reader.reset();
+    config.publish(105);
+    EXPECT_EQ(config.retained(), 0u);
+}
+
+TEST(VersionedConfigTest, ConcurrentReaderNeverSeesFreedSnapshot) {
+    struct Snapshot {
+        std::uint64_t value{0};
+        std::uint64_t check{~std::uint64_t{0}};
+    };
+    VersionedConfig<Snapshot> config;
+    std::atomic<bool> done{false};
+    
+    std::thread reader_thread([&] {
+        auto reader = config.register_reader();
+        std::uint64_t last = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < 16; ++i) {
+                const Snapshot* snapshot = reader.get();
+                ASSERT_EQ(snapshot->check, ~snapshot->value);
+                ASSERT_GE(snapshot->value, last);
+                last = snapshot->value;
+            }
+            reader.quiescent();
+            if ((last & 7) == 0) {
+                reader.offline();
+                std::this_thread::yield();
+                reader.quiescent();
+            }
+        }
+    });
+    
+    for (std::uint64_t v = 1; v <= 20'000; ++v) {
+        config.publish(Snapshot{v, ~v});
+    }
+    done.store(true);
+    reader_thread.join();
+    
+    // Retention stays bounded by the reader's quiescent interval
+    config.publish(Snapshot{0, ~std::uint64_t{0}});
+    EXPECT_LE(config.retained(), 1u);
+}
@@ -8,14 +8,33 @@
  *   L,2,1,S,10100,50        (NewLimit, Sell)
  *   C,1,,,,                 (Cancel order 1)
  *   M,2,,,,75               (Modify order 2 qty to 75)
+ * 
+ * Prices and quantities in the CSV are raw units. They are converted to
+ * ticks/lots with the instrument given by --tick-size / --lot-size; rows
+ * that are not representable are skipped.
+
+ * 
+ * Journal mode (ces_replay --journal FILE) maps an engine write-ahead
+ * journal and applies its records straight to a MatchingEngine's book and
+ * accounts (no queue, clock reads or logging), then checks the resulting
+ * state hash against the one the live engine recorded at close. The
+ * elapsed time makes it a throughput benchmark on recorded flow. With
+ * --checkpoint FILE it restarts the way a recovering engine would: load
+ * the checkpoint, then replay only the journal records after it.
  */
 
 #include <ces/common/types.hpp>
 #include <ces/common/time.hpp>
+#include <ces/common/instrument.hpp>
 #include <ces/lob/order_book.hpp>
 #include <ces/lob/order.hpp>
 #include <ces/engine/accounts.hpp>
+#include <ces/engine/journal.hpp>
+#include <ces/engine/matching_engine.hpp>
+#include <ces/concurrency/spsc_queue.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -33,7 +52,8 @@ struct CsvOrder {
     Qty qty;
 };
 
-std::vector<CsvOrder> parse_csv(const std::string& filename) {
+std::vector<CsvOrder> parse_csv(const std::string& filename, const Instrument& instrument,
+                                std::size_t& skipped) {
     std::vector<CsvOrder> orders;
     std::ifstream file(filename);
     
@@ -87,14 +107,24 @@ std::vector<CsvOrder> parse_csv(const std::string& filename) {
             order.side = (tokens[3][0] == 'B') ? Side::Buy : Side::Sell;
         }
         
-        // Parse price
+        // Parse price (raw units -> ticks)
         if (tokens.size() > 4 && !tokens[4].empty()) {
-            order.price = Price{std::stoll(tokens[4])};
+            auto price = instrument.to_price(std::stoll(tokens[4]));
+            if (!price) {
+                ++skipped;
+                continue;
+            }
+            order.price = *price;
         }
         
-        // Parse qty
+        // Parse qty (raw units -> lots)
         if (tokens.size() > 5 && !tokens[5].empty()) {
-            order.qty = Qty{std::stoll(tokens[5])};
+            auto qty = instrument.to_qty(std::stoll(tokens[5]));
+            if (!qty) {
+                ++skipped;
+                continue;
+            }
+            order.qty = *qty;
         }
         
         orders.push_back(order);
@@ -103,9 +133,91 @@ std::vector<CsvOrder> parse_csv(const std::string& filename) {
     return orders;
 }
 
+/**
+ * @brief Replay a write-ahead journal and verify its state hash
+ * @return 0 if the hash matches (or none was recorded), 1 on error, 2 on mismatch
+ */
+int replay_journal(const std::string& path, const std::string& checkpoint_path,
+                   std::int64_t initial_balance) {
+    JournalResult result;
+    auto reader = JournalReader::open(path, result);
+    if (!reader) {
+        std::cerr << "Error: Could not open journal " << path << ": " << to_string(result) << "\n";
+        return 1;
+    }
+    
+    std::cout << "Journal:          " << path << "\n";
+    std::cout << "Records:          " << reader->count()
+              << (reader->clean_close() ? "" : " (unclean shutdown: valid prefix only)") << "\n";
+    
+    // The queue is never read: events go straight to replay()
+    using Queue = SpscQueue<OrderEvent, 4096>;
+    Queue queue;
+    EngineConfig config;
+    config.max_orders = static_cast<std::uint32_t>(
+        std::clamp<std::uint64_t>(reader->count(), 1024, constants::DEFAULT_MAX_ORDERS));
+    config.initial_balance = initial_balance;
+    MatchingEngine<4096, Queue> engine(queue, config);
+    
+    Timestamp start = now_ns();
+    const RecoveryResult recovery = engine.recover(checkpoint_path, *reader);
+    Timestamp end = now_ns();
+    if (recovery.result != SnapshotResult::Ok) {
+        std::cerr << "Error: Could not load checkpoint " << checkpoint_path << ": "
+                  << to_string(recovery.result) << "\n";
+        return 1;
+    }
+    const std::uint64_t count = recovery.replayed;
+    
+    const double elapsed_s = static_cast<double>(end - start) / 1e9;
+    const std::uint64_t hash = engine.state_hash();
+    
+    std::cout << "\n=== Journal Replay ===\n";
+    if (!checkpoint_path.empty()) {
+        std::cout << "Checkpoint seq:   " << recovery.checkpoint_seq << "\n";
+    }
+    std::cout << "Events replayed:  " << recovery.replayed << "\n";
+    std::cout << "Trades executed:  " << engine.stats().trade_count.load() << "\n";
+    std::cout << (checkpoint_path.empty() ? "Elapsed time:     " : "Restart time:     ")
+              << elapsed_s * 1e3 << " ms\n";
+    std::cout << "Throughput:       "
+              << static_cast<std::uint64_t>(elapsed_s > 0 ? static_cast<double>(count) / elapsed_s : 0.0)
+              << " events/sec\n";
+    std::cout << "Active orders:    " << engine.book().order_count() << "\n";
+    std::cout << "State hash:       " << std::hex << hash << std::dec << "\n";
+    
+    const auto recorded = reader->state_hash();
+    if (!recorded) {
+        std::cout << "Recorded hash:    none (journal not closed with a state hash)\n";
+        return 0;
+    }
+    std::cout << "Recorded hash:    " << std::hex << *recorded << std::dec << "\n";
+    if (*recorded != hash) {
+        std::cout << "Verification:     MISMATCH\n";
+        return 2;
+    }
+    std::cout << "Verification:     OK\n";
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
+    if (argc >= 3 && std::string(argv[1]) == "--journal") {
+        std::int64_t initial_balance = EngineConfig{}.initial_balance;
+        std::string checkpoint_path;
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--initial-balance" && i + 1 < argc) {
+                initial_balance = std::stoll(argv[++i]);
+            } else if (arg == "--checkpoint" && i + 1 < argc) {
+                checkpoint_path = argv[++i];
+            }
+        }
+        return replay_journal(argv[2], checkpoint_path, initial_balance);
+    }
+    
     if (argc < 2) {
-        std::cout << "Usage: " << argv[0] << " <csv_file>\n";
+        std::cout << "Usage: " << argv[0] << " <csv_file> [--tick-size N] [--lot-size N]\n";
+        std::cout << "       " << argv[0] << " --journal <journal_file> [--checkpoint FILE] [--initial-balance N]\n";
         std::cout << "\nCSV Format:\n";
         std::cout << "  type,order_id,trader_id,side,price,qty\n";
         std::cout << "  L,1,0,B,10000,100    (NewLimit Buy)\n";
@@ -116,10 +228,28 @@ int main(int argc, char* argv[]) {
     }
     
     std::string filename = argv[1];
+    
+    Instrument instrument;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--tick-size" && i + 1 < argc) {
+            instrument.tick_size = std::stoll(argv[++i]);
+        } else if (arg == "--lot-size" && i + 1 < argc) {
+            instrument.lot_size = std::stoll(argv[++i]);
+        }
+    }
+    
     std::cout << "Reading orders from: " << filename << "\n";
+    std::cout << "Tick size: " << instrument.tick_size
+              << ", lot size: " << instrument.lot_size << "\n";
     
-    auto csv_orders = parse_csv(filename);
-    std::cout << "Parsed " << csv_orders.size() << " orders\n\n";
+    std::size_t skipped = 0;
+    auto csv_orders = parse_csv(filename, instrument, skipped);
+    std::cout << "Parsed " << csv_orders.size() << " orders";
+    if (skipped > 0) {
+        std::cout << " (" << skipped << " skipped: not on tick/lot grid)";
+    }
+    std::cout << "\n\n";
     
     // Create order book
     OrderBook book(100000, 1024);
@@ -130,11 +260,12 @@ int main(int argc, char* argv[]) {
     std::uint64_t trade_volume = 0;
     
     book.set_trade_callback([&](const Trade& trade) {
-        std::cout << "  TRADE: " << trade.qty.get() << " @ " << trade.price.get()
+        std::cout << "  TRADE: " << instrument.raw_qty(trade.qty)
+                  << " @ " << instrument.raw_price(trade.price)
                   << " (maker=" << trade.maker_order_id.get() 
                   << ", taker=" << trade.taker_order_id.get() << ")\n";
         ++trade_count;
-        trade_volume += trade.qty.get();
+        trade_volume += static_cast<std::uint64_t>(instrument.raw_qty(trade.qty));
     });
     
     // Process orders
@@ -150,7 +281,8 @@ int main(int argc, char* argv[]) {
             case OrderType::NewLimit:
                 std::cout << "ADD LIMIT: id=" << csv_order.order_id.get()
                           << " " << to_string(csv_order.side)
-                          << " " << csv_order.qty.get() << " @ " << csv_order.price.get() << "\n";
+                          << " " << instrument.raw_qty(csv_order.qty)
+                          << " @ " << instrument.raw_price(csv_order.price) << "\n";
                 response = book.add_limit(
                     csv_order.order_id, csv_order.trader_id,
                     csv_order.side, csv_order.price, csv_order.qty
@@ -160,7 +292,7 @@ int main(int argc, char* argv[]) {
             case OrderType::NewMarket:
                 std::cout << "ADD MARKET: id=" << csv_order.order_id.get()
                           << " " << to_string(csv_order.side)
-                          << " " << csv_order.qty.get() << "\n";
+                          << " " << instrument.raw_qty(csv_order.qty) << "\n";
                 response = book.add_market(
                     csv_order.order_id, csv_order.trader_id,
                     csv_order.side, csv_order.qty
@@ -174,7 +306,7 @@ int main(int argc, char* argv[]) {
                 
             case OrderType::Modify:
                 std::cout << "MODIFY: id=" << csv_order.order_id.get()
-                          << " new_qty=" << csv_order.qty.get() << "\n";
+                          << " new_qty=" << instrument.raw_qty(csv_order.qty) << "\n";
                 response = book.modify(csv_order.order_id, csv_order.qty, csv_order.price);
                 break;
         }
@@ -201,9 +333,9 @@ int main(int argc, char* argv[]) {
     
     auto best_bid = book.best_bid();
     auto best_ask = book.best_ask();
-    if (best_bid) std::cout << "Best bid:      " << best_bid->get() << "\n";
-    if (best_ask) std::cout << "Best ask:      " << best_ask->get() << "\n";
-    if (auto spread = book.spread()) std::cout << "Spread:        " << *spread << "\n";
+    if (best_bid) std::cout << "Best bid:      " << instrument.raw_price(*best_bid) << "\n";
+    if (best_ask) std::cout << "Best ask:      " << instrument.raw_price(*best_ask) << "\n";
+    if (auto spread = book.spread()) std::cout << "Spread:        " << *spread << " ticks\n";
     
     return 0;
 }